@@ -5,7 +5,9 @@
 
 #include "lardataobj/RecoBase/SpacePoint.h"
 #include "lareventdisplay/EventDisplay/3DDrawers/ISpacePoints3D.h"
+#include "lareventdisplay/EventDisplay/3DDrawers/SpacePointDecimator.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Utilities/ToolMacros.h"
@@ -68,8 +70,9 @@ void SpacePoint3DDrawerHitAsymmetry::Draw(const std::vector<art::Ptr<recob::Spac
 
     // Get services.
     art::ServiceHandle<evd::ColorDrawingOptions const> cst;
+    art::ServiceHandle<evd::RecoDrawingOptions const>  recoOpt;
 
-    using HitPosition = std::array<double,6>;
+    using HitPosition = SpacePointDecimator::Point_t;
     std::map<int,std::vector<HitPosition>> colorToHitMap;
     
     // Get the scale factor
@@ -84,16 +87,19 @@ void SpacePoint3DDrawerHitAsymmetry::Draw(const std::vector<art::Ptr<recob::Spac
             float         chgFactor      = cst->fRecoQLow[geo::kCollection] + asymmetryScale * hitAsymmetry;
             int           chargeColorIdx = cst->CalQ(geo::kCollection).GetColor(chgFactor);
             const double* pos            = spacePoint->XYZ();
-            const double* err            = spacePoint->ErrXYZ();
 
-            colorToHitMap[chargeColorIdx].push_back(HitPosition()={{pos[0],pos[1],pos[2],err[2],err[2],err[5]}});
+            colorToHitMap[chargeColorIdx].push_back(HitPosition{{pos[0],pos[1],pos[2]}});
         }
     }
     
+    // With too many points, close ones are merged.
+    SpacePointDecimator const decimator(recoOpt->fSpacePoint3DBudget, hitsVec.size());
+
     for(auto& hitPair : colorToHitMap)
     {
-        TPolyMarker3D& pm = view->AddPolyMarker3D(hitPair.second.size(), hitPair.first, kFullDotLarge, 0.25);
-        for (const auto& hit : hitPair.second) pm.SetNextPoint(hit[0],hit[1],hit[2]);
+        std::vector<HitPosition> const positions = decimator.Decimate(std::move(hitPair.second));
+        TPolyMarker3D& pm = view->AddPolyMarker3D(positions.size(), hitPair.first, kFullDotLarge, 0.25);
+        for (const auto& hit : positions) pm.SetNextPoint(hit[0],hit[1],hit[2]);
     }
 
     return;
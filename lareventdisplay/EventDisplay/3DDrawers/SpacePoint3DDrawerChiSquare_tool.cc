@@ -5,7 +5,9 @@
 
 #include "lardataobj/RecoBase/SpacePoint.h"
 #include "lareventdisplay/EventDisplay/3DDrawers/ISpacePoints3D.h"
+#include "lareventdisplay/EventDisplay/3DDrawers/SpacePointDecimator.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Utilities/ToolMacros.h"
@@ -59,8 +61,9 @@ void SpacePoint3DDrawerChiSquare::Draw(const std::vector<art::Ptr<recob::SpacePo
 {
     // Get services.
     art::ServiceHandle<evd::ColorDrawingOptions const> cst;
+    art::ServiceHandle<evd::RecoDrawingOptions const>  recoOpt;
 
-    using HitPosition = std::array<double,6>;
+    using HitPosition = SpacePointDecimator::Point_t;
     std::map<int,std::vector<HitPosition>> colorToHitMap;
 
     float minHitChiSquare(0.);
@@ -70,7 +73,6 @@ void SpacePoint3DDrawerChiSquare::Draw(const std::vector<art::Ptr<recob::SpacePo
     for(const auto& spacePoint : hitsVec)
     {
         const double* pos = spacePoint->XYZ();
-        const double* err = spacePoint->ErrXYZ();
 
         int   chargeColorIdx(0);
         float spacePointChiSq(spacePoint->Chisq());
@@ -81,13 +83,17 @@ void SpacePoint3DDrawerChiSquare::Draw(const std::vector<art::Ptr<recob::SpacePo
 
         chargeColorIdx = cst->CalQ(geo::kCollection).GetColor(chgFactor);
 
-        colorToHitMap[chargeColorIdx].push_back(HitPosition()={{pos[0],pos[1],pos[2],err[3],err[3],err[5]}});
+        colorToHitMap[chargeColorIdx].push_back(HitPosition{{pos[0],pos[1],pos[2]}});
     }
 
+    // With too many points, close ones are merged.
+    SpacePointDecimator const decimator(recoOpt->fSpacePoint3DBudget, hitsVec.size());
+
     for(auto& hitPair : colorToHitMap)
     {
-        TPolyMarker3D& pm = view->AddPolyMarker3D(hitPair.second.size(), hitPair.first, kFullDotLarge, 0.17);
-        for (const auto& hit : hitPair.second) pm.SetNextPoint(hit[0],hit[1],hit[2]);
+        std::vector<HitPosition> const positions = decimator.Decimate(std::move(hitPair.second));
+        TPolyMarker3D& pm = view->AddPolyMarker3D(positions.size(), hitPair.first, kFullDotLarge, 0.17);
+        for (const auto& hit : positions) pm.SetNextPoint(hit[0],hit[1],hit[2]);
     }
 
     return;
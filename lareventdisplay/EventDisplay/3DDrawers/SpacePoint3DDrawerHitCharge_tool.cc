@@ -5,15 +5,41 @@
 
 #include "lardataobj/RecoBase/SpacePoint.h"
 #include "lareventdisplay/EventDisplay/3DDrawers/ISpacePoints3D.h"
+#include "lareventdisplay/EventDisplay/3DDrawers/SpacePointDecimator.h"
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
+#include "nuevdb/EventDisplayBase/EventHolder.h"
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Utilities/ToolMacros.h"
 #include "canvas/Persistency/Common/FindManyP.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
 
-#include "TMath.h"
 #include "TPolyMarker3D.h"
 
+#include <cmath>
+#include <limits>
+#include <map>
+
+namespace
+{
+// Error function from the rational approximation 7.1.28 of Abramowitz and Stegun
+// (absolute error below 3e-7): only products and one division, with no branch,
+// so that a loop of them can be vectorized, which is not the case for std::erf
+inline double vectorErf(double x)
+{
+    const double t = std::fabs(x);
+    double p = 1. + t * (0.0705230784 + t * (0.0422820123 + t * (0.0092705272
+             + t * (0.0001520143 + t * (0.0002765672 + t * 0.0000430638)))));
+    p *= p; // ^2
+    p *= p; // ^4
+    p *= p; // ^8
+    p *= p; // ^16 (infinity for large arguments, where erf is 1)
+    return std::copysign(1. - 1. / p, x);
+}
+} // local namespace
+
 namespace evdb_tool
 {
 
@@ -33,13 +59,30 @@ public:
              ) const;
 
 private:
-    double getSpacePointCharge(const art::Ptr<recob::SpacePoint>&,
-                               const art::FindManyP<recob::Hit>* ) const;
-    double chargeIntegral(double,double,double,double,int,int)     const;
+    /// Parameters of the hits whose charge is integrated, one entry per hit
+    struct HitIntegrals
+    {
+        std::vector<double> peakMean;
+        std::vector<double> peakAmp;
+        std::vector<double> peakWidth;
+        std::vector<double> low;
+        std::vector<double> hi;
+        std::vector<size_t> spacePoint; // index of the space point of the hit
+        std::vector<float>  weight;     // one over the hits of that space point
+    };
+
+    std::vector<float> getSpacePointCharges(const std::vector<art::Ptr<recob::SpacePoint>>&,
+                                            const art::FindManyP<recob::Hit>* ) const;
+    void chargeIntegrals(const HitIntegrals&, std::vector<double>&) const;
 
     bool           fUseAbsoluteScale;
     float          fMinHitCharge;
     float          fMaxHitCharge;
+
+    // Charges of the space points already drawn in this event, by product and key
+    // (not a number for the points not computed yet)
+    mutable util::EventChangeTracker_t                       fChargeEvent;
+    mutable std::map<art::ProductID, std::vector<float>>     fChargeCache;
 };
 
 //----------------------------------------------------------------------
@@ -73,10 +116,14 @@ void SpacePoint3DDrawerHitCharge::Draw(const std::vector<art::Ptr<recob::SpacePo
 
     // Get services.
     art::ServiceHandle<evd::ColorDrawingOptions const> cst;
+    art::ServiceHandle<evd::RecoDrawingOptions const>  recoOpt;
 
-    using HitPosition = std::array<double,6>;
+    using HitPosition = SpacePointDecimator::Point_t;
     std::map<int,std::vector<HitPosition>> colorToHitMap;
     
+    // The charge of each space point, used for both the range and the colors
+    const std::vector<float> spacePointCharges = getSpacePointCharges(hitsVec, hitAssnVec);
+
     float minHitCharge(std::numeric_limits<float>::max());
     float maxHitCharge(std::numeric_limits<float>::lowest());
     
@@ -88,10 +135,9 @@ void SpacePoint3DDrawerHitCharge::Draw(const std::vector<art::Ptr<recob::SpacePo
     else
     // Find the range in the input space point list
     {
-        for(const auto& spacePoint : hitsVec)
+        for(float hitCharge : spacePointCharges)
         {
-            //float hitCharge = getSpacePointCharge(spacePoint, hitAssnVec);
-            float hitCharge = spacePoint->ErrXYZ()[1];
+            if (hitCharge <= 0.) continue;
 
             minHitCharge = std::min(minHitCharge, hitCharge);
             maxHitCharge = std::max(maxHitCharge, hitCharge);
@@ -103,82 +149,156 @@ void SpacePoint3DDrawerHitCharge::Draw(const std::vector<art::Ptr<recob::SpacePo
     {
         float hitChiSqScale((cst->fRecoQHigh[geo::kCollection] - cst->fRecoQLow[geo::kCollection]) / (maxHitCharge - minHitCharge));
         
-        for(const auto& spacePoint : hitsVec)
+        for(size_t spIdx = 0; spIdx < hitsVec.size(); spIdx++)
         {
-            float hitCharge = getSpacePointCharge(spacePoint, hitAssnVec);
+            const art::Ptr<recob::SpacePoint>& spacePoint = hitsVec[spIdx];
+            float                              hitCharge  = spacePointCharges[spIdx];
             
             if (hitCharge > 0.)
             {
                 float         chgFactor      = cst->fRecoQLow[geo::kCollection] + hitChiSqScale * hitCharge;
                 int           chargeColorIdx = cst->CalQ(geo::kCollection).GetColor(chgFactor);
                 const double* pos            = spacePoint->XYZ();
-                const double* err            = spacePoint->ErrXYZ();
 
-                colorToHitMap[chargeColorIdx].push_back(HitPosition()={{pos[0],pos[1],pos[2],err[3],err[3],err[5]}});
+                colorToHitMap[chargeColorIdx].push_back(HitPosition{{pos[0],pos[1],pos[2]}});
             }
         }
         
+        // With too many points, close ones are merged.
+        SpacePointDecimator const decimator(recoOpt->fSpacePoint3DBudget, hitsVec.size());
+
         for(auto& hitPair : colorToHitMap)
         {
-            TPolyMarker3D& pm = view->AddPolyMarker3D(hitPair.second.size(), hitPair.first, kFullDotLarge, 0.25);
-            for (const auto& hit : hitPair.second) pm.SetNextPoint(hit[0],hit[1],hit[2]);
+            std::vector<HitPosition> const positions = decimator.Decimate(std::move(hitPair.second));
+            TPolyMarker3D& pm = view->AddPolyMarker3D(positions.size(), hitPair.first, kFullDotLarge, 0.25);
+            for (const auto& hit : positions) pm.SetNextPoint(hit[0],hit[1],hit[2]);
         }
     }
 
     return;
 }
     
-double SpacePoint3DDrawerHitCharge::getSpacePointCharge(const art::Ptr<recob::SpacePoint>& spacePoint,
-                                                        const art::FindManyP<recob::Hit>*  hitAssnVec) const
+std::vector<float> SpacePoint3DDrawerHitCharge::getSpacePointCharges(const std::vector<art::Ptr<recob::SpacePoint>>& hitsVec,
+                                                                     const art::FindManyP<recob::Hit>*               hitAssnVec) const
 {
-    double totalCharge(0.);
+    std::vector<float> spacePointCharges(hitsVec.size(), 0.);
+    
+    // Redrawing the same event (e.g. on a rotation) reuses the charges of its space points;
+    // without an event, nothing can be reused or kept
+    const art::Event* event = evdb::EventHolder::Instance()->GetEvent();
     
-    // Need to recover the integrated charge from the collection plane, so need to loop through associated hits
-    const std::vector<art::Ptr<recob::Hit>>& hit2DVec(hitAssnVec->at(spacePoint.key()));
+    if (!event) fChargeCache.clear();
+    else if (fChargeEvent.update(util::EventChangeTracker_t(*event))) fChargeCache.clear();
     
-    float hitCharge(0.);
-    int   lowIndex(std::numeric_limits<int>::min());
-    int   hiIndex(std::numeric_limits<int>::max());
+    std::vector<size_t> missingSpacePoints;
     
-    for(const auto& hit2D : hit2DVec)
+    for(size_t spIdx = 0; spIdx < hitsVec.size(); spIdx++)
     {
-        int hitStart = hit2D->PeakTime() - 2. * hit2D->RMS() - 0.5;
-        int hitStop  = hit2D->PeakTime() + 2. * hit2D->RMS() + 0.5;
+        auto const cacheItr = fChargeCache.find(hitsVec[spIdx].id());
         
-        lowIndex = std::max(hitStart,    lowIndex);
-        hiIndex  = std::min(hitStop + 1, hiIndex);
-        
-        hitCharge += hit2D->Integral();
+        if (cacheItr != fChargeCache.end() && hitsVec[spIdx].key() < cacheItr->second.size()
+            && !std::isnan(cacheItr->second[hitsVec[spIdx].key()]))
+            spacePointCharges[spIdx] = cacheItr->second[hitsVec[spIdx].key()];
+        else
+            missingSpacePoints.push_back(spIdx);
     }
     
-    if (!hit2DVec.empty()) hitCharge /= float(hit2DVec.size());
+    if (missingSpacePoints.empty()) return spacePointCharges;
+    
+    // First collect the hits of all the space points, so that their integrals are computed in a single pass
+    HitIntegrals hitIntegrals;
     
-    if (hitCharge > 0.)
+    for(size_t spIdx : missingSpacePoints)
     {
-        if (hiIndex > lowIndex)
+        // Need to recover the integrated charge from the collection plane, so need to loop through associated hits
+        const std::vector<art::Ptr<recob::Hit>>& hit2DVec(hitAssnVec->at(hitsVec[spIdx].key()));
+        
+        float hitCharge(0.);
+        int   lowIndex(std::numeric_limits<int>::min());
+        int   hiIndex(std::numeric_limits<int>::max());
+        
+        for(const auto& hit2D : hit2DVec)
+        {
+            int hitStart = hit2D->PeakTime() - 2. * hit2D->RMS() - 0.5;
+            int hitStop  = hit2D->PeakTime() + 2. * hit2D->RMS() + 0.5;
+            
+            lowIndex = std::max(hitStart,    lowIndex);
+            hiIndex  = std::min(hitStop + 1, hiIndex);
+            
+            hitCharge += hit2D->Integral();
+        }
+        
+        if (!hit2DVec.empty()) hitCharge /= float(hit2DVec.size());
+        
+        if (hitCharge > 0. && hiIndex > lowIndex)
         {
             for(const auto& hit2D : hit2DVec)
-                totalCharge += chargeIntegral(hit2D->PeakTime(),hit2D->PeakAmplitude(),hit2D->RMS(),1.,lowIndex,hiIndex);
+            {
+                // a pulse with no width has no charge
+                if (!(hit2D->RMS() > 0.)) continue;
+                
+                hitIntegrals.peakMean.push_back(hit2D->PeakTime());
+                hitIntegrals.peakAmp.push_back(hit2D->PeakAmplitude());
+                hitIntegrals.peakWidth.push_back(hit2D->RMS());
+                hitIntegrals.low.push_back(lowIndex);
+                hitIntegrals.hi.push_back(hiIndex);
+                hitIntegrals.spacePoint.push_back(spIdx);
+                hitIntegrals.weight.push_back(1. / float(hit2DVec.size()));
+            }
+        }
+    }
+    
+    std::vector<double> integrals;
+    chargeIntegrals(hitIntegrals, integrals);
+    
+    // The charge of a space point is the average of the integrals of its hits
+    for(size_t hitIdx = 0; hitIdx < integrals.size(); hitIdx++)
+        spacePointCharges[hitIntegrals.spacePoint[hitIdx]] += hitIntegrals.weight[hitIdx] * integrals[hitIdx];
+    
+    if (event)
+    {
+        for(size_t spIdx : missingSpacePoints)
+        {
+            std::vector<float>& charges = fChargeCache[hitsVec[spIdx].id()];
             
-            totalCharge /= float(hit2DVec.size());
+            if (hitsVec[spIdx].key() >= charges.size())
+                charges.resize(hitsVec[spIdx].key() + 1, std::numeric_limits<float>::quiet_NaN());
+            
+            charges[hitsVec[spIdx].key()] = spacePointCharges[spIdx];
         }
     }
-
-    return totalCharge;
+    
+    return spacePointCharges;
 }
 
-double SpacePoint3DDrawerHitCharge::chargeIntegral(double peakMean,
-                                                   double peakAmp,
-                                                   double peakWidth,
-                                                   double areaNorm,
-                                                   int    low,
-                                                   int    hi) const
+void SpacePoint3DDrawerHitCharge::chargeIntegrals(const HitIntegrals& hits, std::vector<double>& integrals) const
 {
-    double integral(0);
-
-    for(int sigPos = low; sigPos < hi; sigPos++) integral += peakAmp * TMath::Gaus(double(sigPos)+0.5,peakMean,peakWidth);
-
-    return integral;
+    // Each hit is a gaussian pulse, summed over the ticks from low to hi (excluded) at their centers;
+    // the sum is approximated by the integral of the gaussian in the same range, which is
+    // peakAmp * peakWidth * sqrt(pi/2) * [ erf((hi - mean) / (sqrt(2) width)) - erf((low - mean) / (sqrt(2) width)) ]
+    const double normFactor(std::sqrt(0.5 * M_PI));
+    
+    const size_t nHits = hits.peakMean.size();
+    
+    integrals.resize(nHits);
+    
+    const double* peakMean  = hits.peakMean.data();
+    const double* peakAmp   = hits.peakAmp.data();
+    const double* peakWidth = hits.peakWidth.data();
+    const double* low       = hits.low.data();
+    const double* hi        = hits.hi.data();
+    double*       integral  = integrals.data();
+    
+    // no branch and no library call in the loop, so that it can be vectorized
+    // (the hits with no width were left out when they were collected)
+    for(size_t hitIdx = 0; hitIdx < nHits; hitIdx++)
+    {
+        const double width = peakWidth[hitIdx];
+        const double scale = M_SQRT1_2 / width;
+        
+        integral[hitIdx] = peakAmp[hitIdx] * width * normFactor
+                         * (vectorErf((hi[hitIdx] - peakMean[hitIdx]) * scale) - vectorErf((low[hitIdx] - peakMean[hitIdx]) * scale));
+    }
 }
 
 DEFINE_ART_CLASS_TOOL(SpacePoint3DDrawerHitCharge)
@@ -5,6 +5,7 @@
 
 #include "lardataobj/RecoBase/SpacePoint.h"
 #include "lareventdisplay/EventDisplay/3DDrawers/ISpacePoints3D.h"
+#include "lareventdisplay/EventDisplay/3DDrawers/SpacePointDecimator.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 
 #include "art/Framework/Services/Registry/ServiceHandle.h"
@@ -96,26 +97,33 @@ void SpacePoint3DDrawerStandard::Draw(const std::vector<art::Ptr<recob::SpacePoi
         spmap[spcolor].push_back(&*pspt);
     }
 
+    // With too many points, close ones are merged.
+    SpacePointDecimator const decimator(recoOpt->fSpacePoint3DBudget, spts.size());
+
     // Loop over colors.
     // Note that larger (=better) space points are plotted on
     // top for optimal visibility.
 
-    for(auto const icolor : spmap)
+    for(auto const& icolor : spmap)
     {
         int spcolor = icolor.first;
         const std::vector<const recob::SpacePoint*>& psps = icolor.second;
 
-        // Make and fill a polymarker.
+        std::vector<SpacePointDecimator::Point_t> positions;
+        positions.reserve(psps.size());
+        for(const recob::SpacePoint* spt : psps)
+        {
+            const double *xyz = spt->XYZ();
+            positions.push_back(SpacePointDecimator::Point_t{{xyz[0], xyz[1], xyz[2]}});
+        }
+        positions = decimator.Decimate(std::move(positions));
 
-        TPolyMarker3D& pm = view->AddPolyMarker3D(psps.size(), spcolor, marker, size);
+        // Make and fill a polymarker.
 
-        for(size_t s = 0; s < psps.size(); ++s)
-        {
-            const recob::SpacePoint& spt = *psps[s];
+        TPolyMarker3D& pm = view->AddPolyMarker3D(positions.size(), spcolor, marker, size);
 
-            const double *xyz = spt.XYZ();
-            pm.SetPoint(s, xyz[0], xyz[1], xyz[2]);
-        }
+        for(size_t s = 0; s < positions.size(); ++s)
+            pm.SetPoint(s, positions[s][0], positions[s][1], positions[s][2]);
     }
 
     return;
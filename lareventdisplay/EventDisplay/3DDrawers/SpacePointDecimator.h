@@ -0,0 +1,193 @@
+////////////////////////////////////////////////////////////////////////
+///
+/// \file   SpacePointDecimator.h
+///
+/// \brief  Reduces the number of space points to be drawn in the 3D
+///         display, merging the ones close to each other
+///
+////////////////////////////////////////////////////////////////////////
+
+#ifndef SpacePointDecimator_H
+#define SpacePointDecimator_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "TView.h"
+#include "TVirtualPad.h"
+
+namespace evdb_tool
+{
+    /**
+     * @brief Level of detail of the space points in the 3D display
+     *
+     * A drawer collects the positions of the points to draw (for example,
+     * one list per color), and asks `Decimate()` which positions to actually
+     * draw. Up to the configured budget of points (`SpacePoint3DBudget` in
+     * `RecoDrawingOptions`) are drawn as they are; the budget is shared among
+     * the lists in proportion to their size. Beyond that, points are
+     * merged into cubic cells, and each occupied cell is drawn as a single
+     * point at the average position of the points in it. The cell size starts
+     * from the size of the region shown by the current 3D view, so that cells
+     * get smaller when zooming in, and it is enlarged until the budget is met.
+     * Points inside the shown region are kept at full resolution when they
+     * alone fit the budget.
+     *
+     * The region shown is taken from the `TView` of the current pad, which is
+     * therefore expected to be the pad being drawn, or it is given explicitly;
+     * without a view, the region spans all the points.
+     */
+    class SpacePointDecimator
+    {
+    public:
+        using Point_t = std::array<double, 3>;
+
+        /// Constructor: `budget` points out of `nPoints` (no decimation if `0`)
+        SpacePointDecimator(std::size_t budget, std::size_t nPoints)
+            : fBudget(budget), fNPoints(nPoints)
+        {
+            TView* view = gPad? gPad->GetView(): nullptr;
+            if (view) SetRegion(view->GetRmin(), view->GetRmax());
+        }
+
+        /// Constructor: the region shown is the box between `min` and `max`
+        SpacePointDecimator(std::size_t budget, std::size_t nPoints,
+                            Point_t const& min, Point_t const& max)
+            : fBudget(budget), fNPoints(nPoints)
+        {
+            SetRegion(min.data(), max.data());
+        }
+
+        /// Returns the points to draw, out of `points`
+        std::vector<Point_t> Decimate(std::vector<Point_t> points) const
+        {
+            if ((fBudget == 0) || (fNPoints <= fBudget)) return points;
+
+            // this list gets its share of the budget
+            std::size_t const budget = std::max(std::size_t(1), fBudget * points.size() / fNPoints);
+            if (points.size() <= budget) return points;
+
+            Point_t min = fMin, max = fMax;
+            if (!fHasRegion) std::tie(min, max) = Extent(points);
+
+            // points in the shown region are kept if they fit the budget
+            std::vector<Point_t> shown, hidden;
+            for (Point_t const& point : points)
+                (isInside(point, min, max)? shown: hidden).push_back(point);
+
+            if (shown.size() <= budget)
+            {
+                std::vector<Point_t> merged = Merge(hidden, min, max, budget - shown.size());
+                shown.insert(shown.end(), merged.begin(), merged.end());
+                return shown;
+            }
+
+            return Merge(points, min, max, budget);
+        }
+
+    private:
+        std::size_t fBudget;     ///< maximum number of points to draw
+        std::size_t fNPoints;    ///< number of points in all the lists
+        bool        fHasRegion = false; ///< whether the shown region is known
+        Point_t     fMin{};      ///< lower corner of the shown region
+        Point_t     fMax{};      ///< upper corner of the shown region
+
+        /// Sets the shown region from two opposite corners
+        void SetRegion(double const* corner1, double const* corner2)
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                fMin[i] = std::min(corner1[i], corner2[i]);
+                fMax[i] = std::max(corner1[i], corner2[i]);
+            }
+            fHasRegion = true;
+        }
+
+        /// Returns whether the point is in the box
+        static bool isInside(Point_t const& point, Point_t const& min, Point_t const& max)
+        {
+            for (std::size_t i = 0; i < 3; ++i)
+                if ((point[i] < min[i]) || (point[i] > max[i])) return false;
+            return true;
+        }
+
+        /// Returns the corners of the box containing all the points
+        static std::pair<Point_t, Point_t> Extent(std::vector<Point_t> const& points)
+        {
+            Point_t min, max;
+            min.fill(std::numeric_limits<double>::max());
+            max.fill(std::numeric_limits<double>::lowest());
+            for (Point_t const& point : points)
+            {
+                for (std::size_t i = 0; i < 3; ++i)
+                {
+                    min[i] = std::min(min[i], point[i]);
+                    max[i] = std::max(max[i], point[i]);
+                }
+            }
+            return { min, max };
+        }
+
+        /// Merges the points into at most `budget` cells, sized after the box
+        static std::vector<Point_t> Merge(std::vector<Point_t> const& points,
+                                          Point_t const&              min,
+                                          Point_t const&              max,
+                                          std::size_t                 budget)
+        {
+            if ((budget == 0) || points.empty()) return {};
+
+            // sum of the positions and number of points in each cell
+            using Cell_t = std::array<long long int, 3>;
+            struct CellHash
+            {
+                std::size_t operator()(Cell_t const& cell) const
+                {
+                    return std::size_t((cell[0] * 73856093LL) ^ (cell[1] * 19349663LL) ^ (cell[2] * 83492791LL));
+                }
+            };
+            std::unordered_map<Cell_t, std::pair<Point_t, std::size_t>, CellHash> cells;
+
+            double const length = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2] });
+            double cellSize = std::max(length, 1.) / std::max(std::cbrt(double(budget)), 1.);
+
+            while (true)
+            {
+                cells.clear();
+                cells.reserve(std::min(points.size(), 2 * budget));
+                for (Point_t const& point : points)
+                {
+                    Cell_t const cell{{
+                        (long long int) std::floor((point[0] - min[0]) / cellSize),
+                        (long long int) std::floor((point[1] - min[1]) / cellSize),
+                        (long long int) std::floor((point[2] - min[2]) / cellSize)
+                    }};
+                    auto& content = cells[cell];
+                    for (std::size_t i = 0; i < 3; ++i) content.first[i] += point[i];
+                    ++content.second;
+                }
+                if (cells.size() <= budget) break;
+                // (cells fill a volume at most: a larger enlargement may be needed)
+                cellSize *= std::max(std::cbrt(double(cells.size()) / double(budget)), 1.1);
+            }
+
+            std::vector<Point_t> merged;
+            merged.reserve(cells.size());
+            for (auto const& cell : cells)
+            {
+                Point_t const& sum = cell.second.first;
+                double const   n   = double(cell.second.second);
+                merged.push_back(Point_t{{ sum[0] / n, sum[1] / n, sum[2] / n }});
+            }
+            return merged;
+        }
+    };
+}
+
+#endif
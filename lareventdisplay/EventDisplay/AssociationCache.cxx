@@ -0,0 +1,31 @@
+/// \file    AssociationCache.cxx
+/// \brief   Per-event cache of the association queries of the drawers
+
+#include "lareventdisplay/EventDisplay/AssociationCache.h"
+
+#include "art/Framework/Principal/Event.h"
+
+namespace evd {
+
+  //......................................................................
+  AssociationCache& AssociationCache::Instance()
+  {
+    static AssociationCache cache;
+    return cache;
+  } // AssociationCache::Instance()
+
+  //......................................................................
+  void AssociationCache::Clear()
+  {
+    fEvent.clear();
+    fQueries.clear();
+  } // AssociationCache::Clear()
+
+  //......................................................................
+  void AssociationCache::UpdateEvent(art::Event const& evt)
+  {
+    if (!fEvent.update(util::EventChangeTracker_t(evt))) return;
+    fQueries.clear();
+  } // AssociationCache::UpdateEvent()
+
+} // namespace evd
@@ -0,0 +1,164 @@
+/// \file    AssociationCache.h
+/// \brief   Per-event cache of the association queries of the drawers
+#ifndef EVD_ASSOCIATIONCACHE_H
+#define EVD_ASSOCIATIONCACHE_H
+
+#include <cstddef> // std::size_t
+#include <map>
+#include <memory> // std::shared_ptr
+#include <string>
+#include <tuple>
+#include <typeindex>
+#include <typeinfo> // typeid
+#include <vector>
+
+#include "art/Framework/Principal/Handle.h"
+#include "art/Framework/Principal/View.h"
+#include "canvas/Persistency/Common/FindMany.h"
+#include "canvas/Persistency/Common/FindManyP.h"
+#include "canvas/Utilities/InputTag.h"
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+
+namespace art { class Event; }
+
+namespace evd {
+
+  /**
+   * @brief Association queries (`art::FindMany`, `art::FindManyP`) of an event
+   *
+   * The drawers query the same associations on each redraw, and once for each
+   * of the views they draw into. The cache builds each query the first time
+   * it is asked for in an event, and hands out the same object afterwards,
+   * until a different event is asked about.
+   *
+   * A query is identified by its type, the type of the source collection, the
+   * tag the source objects were read from and the tag of the associations.
+   * The source is either a (valid) handle to the data product, or a view or
+   * collection of pointers holding all the objects of the data product in
+   * their original order, as the ones returned by the
+   * `RecoBaseDrawer::Get...()` methods do. In case the same event has been read anew, a query is built
+   * again when the source objects are not the ones it was built from.
+   *
+   * The cache is shared by all the drawers through `Instance()`. It is not
+   * thread-safe, and a query returned by it is valid until the cache moves to
+   * another event or builds that same query again.
+   */
+  class AssociationCache {
+  public:
+
+    /// Returns the cache shared by the whole event display
+    static AssociationCache& Instance();
+
+    /// Returns the objects of type `B` associated with the ones in `source`
+    template <typename B, typename Source>
+    art::FindMany<B> const& FindMany(
+      art::Event const& evt,
+      art::InputTag const& sourceTag, Source const& source,
+      art::InputTag const& assnsTag
+      )
+      { return Find<art::FindMany<B>>(evt, sourceTag, source, assnsTag); }
+
+    /// Returns pointers to the objects of type `B` associated with `source`
+    template <typename B, typename Source>
+    art::FindManyP<B> const& FindManyP(
+      art::Event const& evt,
+      art::InputTag const& sourceTag, Source const& source,
+      art::InputTag const& assnsTag
+      )
+      { return Find<art::FindManyP<B>>(evt, sourceTag, source, assnsTag); }
+
+    /// Forgets all the queries
+    void Clear();
+
+  private:
+
+    /// Identifier of a query: query type, source type, source and assns tags
+    using Key_t
+      = std::tuple<std::type_index, std::type_index, std::string, std::string>;
+
+    /// A query, and the source objects it was built from
+    struct Entry_t {
+      void const* first = nullptr; ///< address of the first source object
+      std::size_t size = 0; ///< number of source objects
+      std::shared_ptr<void> query; ///< the query object
+    }; // Entry_t
+
+    util::EventChangeTracker_t fEvent; ///< the event the queries refer to
+
+    std::map<Key_t, Entry_t> fQueries; ///< all the cached queries
+
+    /// Forgets all the queries if the event is not the current one
+    void UpdateEvent(art::Event const& evt);
+
+    /// Returns the query, building it if needed
+    template <typename Query, typename Source>
+    Query const& Find(
+      art::Event const& evt,
+      art::InputTag const& sourceTag, Source const& source,
+      art::InputTag const& assnsTag
+      );
+
+    /// Returns the address of the first object in a view
+    template <typename T>
+    static void const* FirstObject(art::View<T> const& source)
+      { return source.vals().empty()? nullptr: source.vals().front(); }
+
+    /// Returns the address of the first object in a data product
+    template <typename T>
+    static void const* FirstObject(art::Handle<std::vector<T>> const& source)
+      { return source->empty()? nullptr: source->data(); }
+
+    /// Returns the address of the first object in a collection of pointers
+    template <typename Coll>
+    static void const* FirstObject(Coll const& source)
+      { return source.empty()? nullptr: source.front().get(); }
+
+    /// Returns the number of objects in a view
+    template <typename T>
+    static std::size_t NObjects(art::View<T> const& source)
+      { return source.vals().size(); }
+
+    /// Returns the number of objects in a data product
+    template <typename T>
+    static std::size_t NObjects(art::Handle<std::vector<T>> const& source)
+      { return source->size(); }
+
+    /// Returns the number of objects in a collection of pointers
+    template <typename Coll>
+    static std::size_t NObjects(Coll const& source)
+      { return source.size(); }
+
+  }; // class AssociationCache
+
+
+  //......................................................................
+  template <typename Query, typename Source>
+  Query const& AssociationCache::Find(
+    art::Event const& evt,
+    art::InputTag const& sourceTag, Source const& source,
+    art::InputTag const& assnsTag
+    )
+  {
+    UpdateEvent(evt);
+
+    Entry_t& entry = fQueries[Key_t{
+      std::type_index(typeid(Query)), std::type_index(typeid(Source)),
+      sourceTag.encode(), assnsTag.encode()
+      }];
+
+    // the same event may have been read anew, with its data somewhere else
+    void const* first = FirstObject(source);
+    std::size_t const size = NObjects(source);
+    if (!entry.query || (entry.first != first) || (entry.size != size)) {
+      entry.query = std::make_shared<Query>(source, evt, assnsTag);
+      entry.first = first;
+      entry.size = size;
+    }
+
+    return *static_cast<Query const*>(entry.query.get());
+  } // AssociationCache::Find()
+
+} // namespace evd
+
+#endif // EVD_ASSOCIATIONCACHE_H
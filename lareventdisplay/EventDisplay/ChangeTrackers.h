@@ -18,8 +18,11 @@
 
 // C/C++ standard libraries
 #include <string> // std::to_string()
+#include <limits> // std::numeric_limits<>
 #include <ostream>
+#include <sstream>
 #include <type_traits> // std::enable_if_t
+#include <vector>
 
 
 namespace util {
@@ -320,6 +323,118 @@ namespace util {
     { out << std::string(trk); return out; }
 
 
+
+  /** **************************************************************************
+   * @brief Detects changes in the input of a drawing layer
+   *
+   * A drawing layer is the set of graphic objects one drawer produces for a
+   * wire plane, and it needs to be drawn anew only when its input changes.
+   * The state of this class describes that input as the current event, the
+   * wire plane, and any other input the drawer depends on (data product
+   * labels, drawing options, the visible range...), added with `with()`:
+   *
+   *     util::LayerChangeTracker_t input(evt, planeID);
+   *     input.with(rawopt->fMinSignal).with(rawopt->fConfigurationID.to_string());
+   *     if (layerInput.update(input)) { ... draw the layer again ... }
+   *
+   * Inputs are compared by their text representation, so anything that can be
+   * written to a `std::ostream` can be used.
+   */
+  class LayerChangeTracker_t: private EventChangeTracker_t {
+      public:
+
+    /// Default constructor: no current layer input
+    LayerChangeTracker_t() = default;
+
+    /// Constructor: specifies current event and plane, and no other input
+    LayerChangeTracker_t(art::Event const& evt, geo::PlaneID const& pid):
+      EventChangeTracker_t(evt), state{pid, {}}
+      {}
+
+
+    /// Adds an input to the ones of the layer; returns this object
+    template <typename T>
+    LayerChangeTracker_t& with(T const& input)
+      {
+        std::ostringstream sstr;
+        sstr.precision(std::numeric_limits<double>::max_digits10);
+        sstr << input;
+        state.inputs.push_back(sstr.str());
+        return *this;
+      }
+
+
+    /// @name State query
+    /// @{
+    /// Returns the current plane ID
+    geo::PlaneID const& planeID() const { return state.plane_id; }
+
+    /// Returns whether we are in the same event (the rest could differ)
+    bool sameEvent(LayerChangeTracker_t const& as) const
+      { return EventChangeTracker_t::same(as); }
+
+    /// Returns whether we have the same plane and inputs as "as"
+    bool same(LayerChangeTracker_t const& as) const
+      {
+        return sameEvent(as) && (planeID() == as.planeID())
+          && (state.inputs == as.state.inputs);
+      }
+
+    /// Returns whether there is an event and plane
+    bool isValid() const
+      { return EventChangeTracker_t::isValid() && planeID().isValid; }
+
+    /// Returns whether event, plane and inputs are the same as in "as"
+    bool operator== (LayerChangeTracker_t const& as) const
+      { return same(as); }
+
+    /// Returns whether event, plane or inputs are different than in "than"
+    bool operator!= (LayerChangeTracker_t const& than) const
+      { return !same(than); }
+    /// @}
+
+
+    /// @name State change
+    /// @{
+    /// Forget the current input, so that the layer is drawn anew next time
+    void clear()
+      { EventChangeTracker_t::clear(); state = LocalState_t(); }
+
+    /// Update to a new input, return true if it has changed
+    bool update(LayerChangeTracker_t const& new_input)
+      {
+        if (same(new_input)) return false;
+        *this = new_input;
+        return true;
+      }
+
+    /// @}
+
+    /// Returns a string representation of event, plane and inputs
+    operator std::string() const
+      {
+        std::string s = EventChangeTracker_t::operator std::string()
+          + " " + std::string(planeID()) + " {";
+        for (std::string const& input: state.inputs) s += " " + input;
+        return s + " }";
+      }
+
+      private:
+    struct LocalState_t {
+      geo::PlaneID plane_id;
+      std::vector<std::string> inputs; ///< text of all the other inputs
+    }; // LocalState_t
+
+    LocalState_t state;
+
+  }; // LayerChangeTracker_t
+
+
+  inline std::ostream& operator<<
+    (std::ostream& out, LayerChangeTracker_t const& trk)
+    { out << std::string(trk); return out; }
+
+
 } // namespace util
 
 #endif // UTIL_CHANGETRACKERS_H
@@ -0,0 +1,118 @@
+/// \file    ChannelConditions.cxx
+/// \brief   Per-event cache of the conditions of the readout channels
+
+#include "lareventdisplay/EventDisplay/ChannelConditions.h"
+
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
+#include "larcore/Geometry/Geometry.h"
+#include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
+#include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
+#include "larevt/CalibrationDBI/Interface/DetPedestalProvider.h"
+#include "larevt/CalibrationDBI/Interface/DetPedestalService.h"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace evd {
+
+  //......................................................................
+  ChannelConditionTable::Selection_t::Selection_t
+    (evd::RawDrawingOptions const& rawopt)
+    : minStatus(rawopt.fMinChannelStatus)
+    , maxStatus(rawopt.fMaxChannelStatus)
+    , seeBadChannels(rawopt.fSeeBadChannels)
+  {}
+
+  //......................................................................
+  ChannelConditionTable& ChannelConditionTable::Instance()
+  {
+    static ChannelConditionTable table;
+    return table;
+  } // ChannelConditionTable::Instance()
+
+  //......................................................................
+  bool ChannelConditionTable::Update(art::Event const& evt)
+  {
+    if (!fEvent.update(util::EventChangeTracker_t(evt))) return false;
+
+    lariov::ChannelStatusProvider const& channelStatus
+      = art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
+    geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
+
+    raw::ChannelID_t const nChannels = geom.Nchannels();
+    fConditions.assign(nChannels, Conditions_t());
+    fBadWires.clear();
+    for (raw::ChannelID_t channel = 0; channel < nChannels; ++channel) {
+      Conditions_t& conditions = fConditions[channel];
+      conditions.present = channelStatus.IsPresent(channel);
+      if (!conditions.present) continue;
+      conditions.status = channelStatus.Status(channel);
+      conditions.bad = channelStatus.IsBad(channel);
+    } // for
+
+    MF_LOG_DEBUG("ChannelConditionTable")
+      << "Channel conditions collected for " << nChannels << " channels";
+    return true;
+  } // ChannelConditionTable::Update()
+
+  //......................................................................
+  void ChannelConditionTable::Clear()
+  {
+    fEvent.clear();
+    fConditions.clear();
+    fBadWires.clear();
+  } // ChannelConditionTable::Clear()
+
+  //......................................................................
+  bool ChannelConditionTable::isSelected
+    (raw::ChannelID_t channel, Selection_t const& selection) const
+  {
+    Conditions_t const& conditions = (*this)[channel];
+    if (!conditions.present) return false;
+
+    // if we don't have a valid status, we can't reject the channel
+    if (!lariov::ChannelStatusProvider::IsValidStatus(conditions.status))
+      return true;
+
+    // is the status "too bad"?
+    return (conditions.status >= selection.minStatus)
+      && (conditions.status <= selection.maxStatus);
+  } // ChannelConditionTable::isSelected()
+
+  //......................................................................
+  float ChannelConditionTable::Pedestal(raw::ChannelID_t channel) const
+  {
+    if (channel >= fConditions.size()) {
+      return lar::providerFrom<lariov::DetPedestalService>()->PedMean(channel);
+    }
+    Conditions_t& conditions = fConditions[channel];
+    if (!conditions.hasPedestal) {
+      conditions.pedestal
+        = lar::providerFrom<lariov::DetPedestalService>()->PedMean(channel);
+      conditions.hasPedestal = true;
+    }
+    return conditions.pedestal;
+  } // ChannelConditionTable::Pedestal()
+
+  //......................................................................
+  std::vector<geo::WireID::WireID_t> const& ChannelConditionTable::BadWires
+    (geo::PlaneID const& pid) const
+  {
+    auto const iPlane = fBadWires.find(pid);
+    if (iPlane != fBadWires.end()) return iPlane->second;
+
+    geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
+
+    std::vector<geo::WireID::WireID_t>& badWires = fBadWires[pid];
+    geo::WireID::WireID_t const nWires = geom.Nwires(pid);
+    for (geo::WireID::WireID_t wire = 0; wire < nWires; ++wire) {
+      raw::ChannelID_t const channel
+        = geom.PlaneWireToChannel(geo::WireID(pid, wire));
+      if ((*this)[channel].bad) badWires.push_back(wire);
+    } // for
+
+    return badWires;
+  } // ChannelConditionTable::BadWires()
+
+} // namespace evd
@@ -0,0 +1,106 @@
+/// \file    ChannelConditions.h
+/// \brief   Per-event cache of the conditions of the readout channels
+#ifndef EVD_CHANNELCONDITIONS_H
+#define EVD_CHANNELCONDITIONS_H
+
+#include <map>
+#include <vector>
+
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::PlaneID, ...
+#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+
+namespace art { class Event; }
+
+namespace evd {
+
+  class RawDrawingOptions;
+
+  /**
+   * @brief Caches the conditions of all the readout channels for one event
+   *
+   * The channel status and pedestal providers may be database-backed, and
+   * asking them about each channel on each redraw is expensive.
+   * This table is filled when a new event is presented (`Update()`), with one
+   * entry per channel in a dense vector indexed by channel ID.
+   *
+   * Presence, status and "badness" of all the channels are collected at once.
+   * Pedestals are retrieved only when first asked for, since they are needed
+   * only for the channels with data and only with some drawing options; for
+   * the same reason, `Pedestal()` is not thread-safe. The list of the bad
+   * wires of a plane is also collected when first asked for, with the same
+   * caveat.
+   *
+   * The table is shared by all the drawers of all the views through
+   * `Instance()`, so that the conditions are collected only once per event.
+   */
+  class ChannelConditionTable {
+  public:
+
+    using Status_t = lariov::ChannelStatusProvider::Status_t;
+
+    /// Conditions of a single channel
+    struct Conditions_t {
+      Status_t status = lariov::ChannelStatusProvider::InvalidStatus;
+      float pedestal = 0.F;     ///< mean pedestal from the pedestal service
+      bool present = false;     ///< whether the channel is present
+      bool bad = false;         ///< whether the channel is marked bad
+      bool hasPedestal = false; ///< whether `pedestal` was already retrieved
+    }; // Conditions_t
+
+    /// Channel selection from the raw drawing options
+    struct Selection_t {
+      Status_t minStatus = 0;  ///< lowest status of channels to be processed
+      Status_t maxStatus = lariov::ChannelStatusProvider::InvalidStatus - 1;
+      bool seeBadChannels = false; ///< whether bad channels are processed
+
+      Selection_t() = default;
+      explicit Selection_t(evd::RawDrawingOptions const& rawopt);
+    }; // Selection_t
+
+    /// Returns the table shared by the whole event display
+    static ChannelConditionTable& Instance();
+
+    /// Refills the table if the event is not the current one; true if refilled
+    bool Update(art::Event const& evt);
+
+    /// Forgets all the conditions
+    void Clear();
+
+    /// Returns the conditions of the specified channel
+    Conditions_t const& operator[] (raw::ChannelID_t channel) const
+      { return (channel < fConditions.size())? fConditions[channel]: fNoChannel; }
+
+    /// Returns whether the channel is present and its status is accepted
+    bool isSelected
+      (raw::ChannelID_t channel, Selection_t const& selection) const;
+
+    /// Returns whether the channel is marked as bad and should not be shown
+    bool isHiddenBad
+      (raw::ChannelID_t channel, Selection_t const& selection) const
+      { return !selection.seeBadChannels && (*this)[channel].bad; }
+
+    /// Returns the pedestal of the channel from the pedestal service
+    float Pedestal(raw::ChannelID_t channel) const;
+
+    /// Returns the wires of the plane on bad channels, in increasing order
+    std::vector<geo::WireID::WireID_t> const& BadWires
+      (geo::PlaneID const& pid) const;
+
+  private:
+    util::EventChangeTracker_t fEvent; ///< the event the table refers to
+
+    mutable std::vector<Conditions_t> fConditions; ///< conditions, by channel
+
+    Conditions_t fNoChannel; ///< conditions for channels not in the table
+
+    /// Wires on bad channels, by plane
+    mutable std::map<geo::PlaneID, std::vector<geo::WireID::WireID_t>> fBadWires;
+
+  }; // class ChannelConditionTable
+
+} // namespace evd
+
+#endif // EVD_CHANNELCONDITIONS_H
@@ -0,0 +1,159 @@
+/// \file    ChannelDataIndex.cxx
+/// \brief   Per-event lookup of raw digits, wires and hits by channel
+
+#include "lareventdisplay/EventDisplay/ChannelDataIndex.h"
+
+#include <algorithm> // std::sort()
+
+#include "lardataobj/RawData/RawDigit.h"
+#include "lardataobj/RecoBase/Hit.h"
+#include "lardataobj/RecoBase/Wire.h"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace {
+
+  /// Sorts the hits of each channel by peak time
+  void SortChannelData(
+    std::vector<recob::Hit> const& hits,
+    std::vector<std::size_t> const& first, std::vector<std::size_t>& positions
+    )
+  {
+    for (std::size_t channel = 0; channel + 1 < first.size(); ++channel) {
+      std::sort(positions.begin() + first[channel],
+        positions.begin() + first[channel + 1],
+        [&hits](std::size_t a, std::size_t b)
+          { return hits[a].PeakTime() < hits[b].PeakTime(); }
+        );
+    } // for
+  }
+
+  /// Data other than hits are kept in the order of the data product
+  template <typename T>
+  void SortChannelData
+    (std::vector<T> const&, std::vector<std::size_t> const&, std::vector<std::size_t>&)
+    {}
+
+} // local namespace
+
+
+namespace evd {
+
+  //......................................................................
+  ChannelDataIndex& ChannelDataIndex::Instance()
+  {
+    static ChannelDataIndex index;
+    return index;
+  } // ChannelDataIndex::Instance()
+
+  //......................................................................
+  std::size_t ChannelDataIndex::DigitPosition
+    (art::Event const& evt, art::InputTag const& label, raw::ChannelID_t channel)
+  {
+    return FirstPosition
+      (Index<raw::RawDigit>(fDigits, evt, label).Channel(channel));
+  } // ChannelDataIndex::DigitPosition()
+
+  //......................................................................
+  std::size_t ChannelDataIndex::WirePosition
+    (art::Event const& evt, art::InputTag const& label, raw::ChannelID_t channel)
+  {
+    return FirstPosition
+      (Index<recob::Wire>(fWires, evt, label).Channel(channel));
+  } // ChannelDataIndex::WirePosition()
+
+  //......................................................................
+  ChannelDataIndex::PositionRange_t ChannelDataIndex::HitPositions
+    (art::Event const& evt, art::InputTag const& label, raw::ChannelID_t channel)
+  {
+    return Index<recob::Hit>(fHits, evt, label).Channel(channel);
+  } // ChannelDataIndex::HitPositions()
+
+  //......................................................................
+  void ChannelDataIndex::Clear()
+  {
+    fEvent.clear();
+    fDigits.clear();
+    fWires.clear();
+    fHits.clear();
+  } // ChannelDataIndex::Clear()
+
+  //......................................................................
+  ChannelDataIndex::PositionRange_t ChannelDataIndex::ProductIndex_t::Channel
+    (raw::ChannelID_t channel) const
+  {
+    if (std::size_t(channel) + 1 >= first.size()) return { positions.cend(), positions.cend() };
+    return {
+      positions.cbegin() + first[channel],
+      positions.cbegin() + first[channel + 1]
+      };
+  } // ChannelDataIndex::ProductIndex_t::Channel()
+
+  //......................................................................
+  void ChannelDataIndex::UpdateEvent(art::Event const& evt)
+  {
+    if (!fEvent.update(util::EventChangeTracker_t(evt))) return;
+    fDigits.clear();
+    fWires.clear();
+    fHits.clear();
+  } // ChannelDataIndex::UpdateEvent()
+
+  //......................................................................
+  template <typename T>
+  ChannelDataIndex::ProductIndex_t const& ChannelDataIndex::Index(
+    std::map<std::string, ProductIndex_t>& indices,
+    art::Event const& evt, art::InputTag const& label
+    )
+  {
+    static ProductIndex_t const NoData;
+
+    UpdateEvent(evt);
+
+    art::Handle<std::vector<T>> handle;
+    if (!evt.getByLabel(label, handle)) return NoData;
+    std::vector<T> const& data = *handle;
+
+    // the same event may have been read anew, with its data somewhere else
+    ProductIndex_t& index = indices[label.encode()];
+    if (index.product == &data) return index;
+
+    // a counting sort by channel, which keeps the order within each channel;
+    // data on no valid channel can't be asked for, and are not indexed
+    // (the table would otherwise stretch up to `raw::InvalidChannelID`)
+    raw::ChannelID_t maxChannel = 0;
+    std::size_t nValid = 0;
+    for (T const& item: data) {
+      if (!raw::isValidChannelID(item.Channel())) continue;
+      maxChannel = std::max(maxChannel, item.Channel());
+      ++nValid;
+    } // for
+
+    index.first.assign((nValid == 0)? 1: std::size_t(maxChannel) + 2, 0);
+    for (T const& item: data) {
+      if (!raw::isValidChannelID(item.Channel())) continue;
+      ++index.first[std::size_t(item.Channel()) + 1];
+    } // for
+    for (std::size_t i = 1; i < index.first.size(); ++i)
+      index.first[i] += index.first[i - 1];
+
+    index.positions.resize(nValid);
+    std::vector<std::size_t> next(index.first.begin(), index.first.end() - 1);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      if (!raw::isValidChannelID(data[i].Channel())) continue;
+      index.positions[next[data[i].Channel()]++] = i;
+    } // for
+
+    SortChannelData(data, index.first, index.positions);
+
+    index.product = &data;
+
+    MF_LOG_DEBUG("ChannelDataIndex") << "Indexed " << nValid << "/"
+      << data.size() << " objects from '" << label.encode() << "' on channels up to "
+      << maxChannel;
+
+    return index;
+  } // ChannelDataIndex::Index()
+
+} // namespace evd
@@ -0,0 +1,107 @@
+/// \file    ChannelDataIndex.h
+/// \brief   Per-event lookup of raw digits, wires and hits by channel
+#ifndef EVD_CHANNELDATAINDEX_H
+#define EVD_CHANNELDATAINDEX_H
+
+#include <cstddef> // std::size_t
+#include <limits>
+#include <map>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+
+#include "canvas/Utilities/InputTag.h"
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+
+namespace art { class Event; }
+
+namespace evd {
+
+  /**
+   * @brief Positions of the data of each channel in the event data products
+   *
+   * The waveform drawing tools are asked for a single channel at a time.
+   * Instead of scanning the whole data product on each request, the first
+   * request on a product in an event indexes all of it by channel, and the
+   * following ones (for any channel) are direct lookups.
+   *
+   * Raw digits (`raw::RawDigit`), calibrated waveforms (`recob::Wire`) and
+   * hits (`recob::Hit`) are supported. The index returns the position of
+   * the data in the product, so that `art::Ptr` or auxiliary data products
+   * parallel to the original one can be used directly. Hits of each channel
+   * are sorted by peak time.
+   *
+   * The index is shared by all the tools through `Instance()`, and it is
+   * forgotten as soon as a different event is asked about. It is not
+   * thread-safe.
+   */
+  class ChannelDataIndex {
+  public:
+
+    /// Value returned when there is no data for the channel
+    static constexpr std::size_t NoPosition
+      = std::numeric_limits<std::size_t>::max();
+
+    /// Range of positions in the data product
+    using PositionRange_t = std::pair<
+      std::vector<std::size_t>::const_iterator,
+      std::vector<std::size_t>::const_iterator
+      >;
+
+    /// Returns the index shared by the whole event display
+    static ChannelDataIndex& Instance();
+
+    /// Returns the position of the digit of the channel (`NoPosition` if none)
+    std::size_t DigitPosition
+      (art::Event const& evt, art::InputTag const& label, raw::ChannelID_t channel);
+
+    /// Returns the position of the wire of the channel (`NoPosition` if none)
+    std::size_t WirePosition
+      (art::Event const& evt, art::InputTag const& label, raw::ChannelID_t channel);
+
+    /// Returns the positions of the hits on the channel, sorted by peak time
+    PositionRange_t HitPositions
+      (art::Event const& evt, art::InputTag const& label, raw::ChannelID_t channel);
+
+    /// Forgets all the indices
+    void Clear();
+
+  private:
+
+    /// Positions of all the data of a product, grouped by channel
+    struct ProductIndex_t {
+      void const* product = nullptr; ///< address of the indexed data product
+      std::vector<std::size_t> first; ///< first entry in `positions`, by channel
+      std::vector<std::size_t> positions; ///< positions in the product
+
+      /// Returns the positions of the data of the channel
+      PositionRange_t Channel(raw::ChannelID_t channel) const;
+    }; // ProductIndex_t
+
+    util::EventChangeTracker_t fEvent; ///< the event the indices refer to
+
+    /// Indices of the products, by type and encoded input tag
+    std::map<std::string, ProductIndex_t> fDigits, fWires, fHits;
+
+    /// Forgets all the indices if the event is not the current one
+    void UpdateEvent(art::Event const& evt);
+
+    /// Returns the index of the product, building it if needed
+    template <typename T>
+    ProductIndex_t const& Index(
+      std::map<std::string, ProductIndex_t>& indices,
+      art::Event const& evt, art::InputTag const& label
+      );
+
+    /// Returns the first position in a range, `NoPosition` if empty
+    static std::size_t FirstPosition(PositionRange_t const& range)
+      { return (range.first == range.second)? NoPosition: *(range.first); }
+
+  }; // class ChannelDataIndex
+
+} // namespace evd
+
+#endif // EVD_CHANNELDATAINDEX_H
@@ -0,0 +1,92 @@
+/// \file    ChannelWireMap.cxx
+/// \brief   Lookup table of the wires of each channel, from the geometry
+
+#include "lareventdisplay/EventDisplay/ChannelWireMap.h"
+
+#include <algorithm> // std::sort(), std::lower_bound(), std::find_if(), ...
+#include <memory> // std::unique_ptr
+
+#include "larcore/CoreUtils/ServiceUtil.h" // lar::providerFrom()
+#include "larcore/Geometry/Geometry.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace evd {
+
+  //......................................................................
+  ChannelWireMap const& ChannelWireMap::Instance()
+  {
+    static std::unique_ptr<ChannelWireMap> table;
+
+    geo::GeometryCore const& geom = *(lar::providerFrom<geo::Geometry>());
+    if (!table || (table->fGeom != &geom) || (table->NChannels() != geom.Nchannels()))
+      table = std::make_unique<ChannelWireMap>(geom);
+    return *table;
+  } // ChannelWireMap::Instance()
+
+  //......................................................................
+  ChannelWireMap::ChannelWireMap(geo::GeometryCore const& geom)
+    : fGeom(&geom)
+  {
+    std::size_t const nChannels = geom.Nchannels();
+
+    fFirst.reserve(nChannels + 1);
+    fFirst.push_back(0);
+    for (std::size_t channel = 0; channel < nChannels; ++channel) {
+      for (geo::WireID const& wid: geom.ChannelToWire(channel)) {
+        fWires.push_back(wid);
+        fPlanes.push_back(wid.planeID());
+      }
+      fFirst.push_back(fWires.size());
+    } // for channels
+
+    std::sort(fPlanes.begin(), fPlanes.end());
+    fPlanes.erase(std::unique(fPlanes.begin(), fPlanes.end()), fPlanes.end());
+
+    fPlaneChannels.assign(fPlanes.size(), std::vector<bool>(nChannels, false));
+    for (std::size_t channel = 0; channel < nChannels; ++channel) {
+      for (std::size_t i = fFirst[channel]; i < fFirst[channel + 1]; ++i) {
+        std::size_t const iPlane = std::lower_bound
+          (fPlanes.begin(), fPlanes.end(), fWires[i].planeID()) - fPlanes.begin();
+        fPlaneChannels[iPlane][channel] = true;
+      }
+    } // for channels
+
+    MF_LOG_DEBUG("ChannelWireMap") << "Mapped " << fWires.size()
+      << " wires of " << nChannels << " channels on " << fPlanes.size()
+      << " planes";
+  } // ChannelWireMap::ChannelWireMap()
+
+  //......................................................................
+  ChannelWireMap::WireRange_t ChannelWireMap::Wires
+    (raw::ChannelID_t channel) const
+  {
+    if (!hasChannel(channel)) return { fWires.cend(), fWires.cend() };
+    return {
+      fWires.cbegin() + fFirst[channel],
+      fWires.cbegin() + fFirst[channel + 1]
+      };
+  } // ChannelWireMap::Wires()
+
+  //......................................................................
+  bool ChannelWireMap::isOnPlane
+    (raw::ChannelID_t channel, geo::PlaneID const& pid) const
+  {
+    if (!hasChannel(channel)) return false;
+    auto const iPlane = std::lower_bound(fPlanes.begin(), fPlanes.end(), pid);
+    if ((iPlane == fPlanes.end()) || (*iPlane != pid)) return false;
+    return fPlaneChannels[iPlane - fPlanes.begin()][channel];
+  } // ChannelWireMap::isOnPlane()
+
+  //......................................................................
+  geo::WireID const* ChannelWireMap::PlaneWire
+    (raw::ChannelID_t channel, geo::PlaneID const& pid) const
+  {
+    if (!isOnPlane(channel, pid)) return nullptr;
+    auto const wires = Wires(channel);
+    auto const iWire = std::find_if(wires.begin(), wires.end(),
+      [&pid](geo::WireID const& wid){ return wid.planeID() == pid; });
+    return &*iWire;
+  } // ChannelWireMap::PlaneWire()
+
+} // namespace evd
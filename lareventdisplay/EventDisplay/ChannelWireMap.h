@@ -0,0 +1,86 @@
+/// \file    ChannelWireMap.h
+/// \brief   Lookup table of the wires of each channel, from the geometry
+#ifndef EVD_CHANNELWIREMAP_H
+#define EVD_CHANNELWIREMAP_H
+
+#include <cstddef> // std::size_t
+#include <vector>
+
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::ChannelID_t
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h"
+
+namespace geo { class GeometryCore; }
+
+namespace evd {
+
+  /**
+   * @brief Wires of each TPC channel, and channels of each plane
+   *
+   * `geo::GeometryCore::ChannelToWire()` returns a new vector on each call,
+   * and the drawers would ask it for each channel on each redraw. This table
+   * asks the geometry once for each channel, and then it answers without
+   * allocating memory: the wires of all the channels are stored contiguously
+   * (the wires of `channel` are between `fFirst[channel]` and
+   * `fFirst[channel + 1]`), and each plane has a bit for each channel, set
+   * when the channel has a wire on that plane.
+   *
+   * The table is shared by the whole event display through `Instance()`,
+   * which builds it anew when the geometry changes. It is not thread-safe.
+   */
+  class ChannelWireMap {
+  public:
+
+    /// Range of wires of a channel
+    class WireRange_t {
+    public:
+      using const_iterator = std::vector<geo::WireID>::const_iterator;
+
+      WireRange_t(const_iterator b, const_iterator e): fBegin(b), fEnd(e) {}
+
+      const_iterator begin() const { return fBegin; }
+      const_iterator end() const { return fEnd; }
+      std::size_t size() const { return fEnd - fBegin; }
+      bool empty() const { return fBegin == fEnd; }
+
+    private:
+      const_iterator fBegin, fEnd;
+    }; // WireRange_t
+
+    /// Returns the table of the current geometry (ask once per loop, not per channel)
+    static ChannelWireMap const& Instance();
+
+    /// Builds the table from the specified geometry
+    explicit ChannelWireMap(geo::GeometryCore const& geom);
+
+    /// Returns the number of channels in the table
+    std::size_t NChannels() const { return fFirst.size() - 1; }
+
+    /// Returns the wires of the channel (empty if the channel is not valid)
+    WireRange_t Wires(raw::ChannelID_t channel) const;
+
+    /// Returns whether the channel has a wire on the plane
+    bool isOnPlane(raw::ChannelID_t channel, geo::PlaneID const& pid) const;
+
+    /// Returns the first wire of the channel on the plane (`nullptr` if none)
+    geo::WireID const* PlaneWire
+      (raw::ChannelID_t channel, geo::PlaneID const& pid) const;
+
+  private:
+
+    geo::GeometryCore const* fGeom = nullptr; ///< geometry the table is from
+
+    std::vector<std::size_t> fFirst; ///< first wire in `fWires`, by channel
+    std::vector<geo::WireID> fWires; ///< wires of all the channels
+
+    std::vector<geo::PlaneID> fPlanes; ///< all planes, sorted
+    std::vector<std::vector<bool>> fPlaneChannels; ///< channels, by plane
+
+    /// Returns whether the channel is in the table
+    bool hasChannel(raw::ChannelID_t channel) const
+      { return raw::isValidChannelID(channel) && (channel < NChannels()); }
+
+  }; // class ChannelWireMap
+
+} // namespace evd
+
+#endif // EVD_CHANNELWIREMAP_H
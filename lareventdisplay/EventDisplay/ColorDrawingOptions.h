@@ -32,6 +32,8 @@ namespace evd {
     std::vector<double> fRecoQLow;    ///< low  edge of ADC values for drawing raw digits
     std::vector<double> fRecoQHigh;   ///< high edge of ADC values for drawing raw digits
 
+    fhicl::ParameterSetID fConfigurationID; ///< ID of the configuration last applied by reconfigure()
+
   private:
 
     void CheckInputVectorSizes();
@@ -122,6 +122,8 @@ namespace evd{
       fGrayScaleReco[i] .SetBounds(fRecoQLow[i], fRecoQHigh[i]);
     }
 
+    fConfigurationID = pset.id();
+
     return;
   }
 
@@ -0,0 +1,206 @@
+/// \file    ColorRaster.cxx
+/// \brief   Single histogram rendering of a grid of colored cells
+
+#include <algorithm> // std::min()
+#include <functional>
+
+#include "TColor.h"
+#include "TExec.h"
+#include "TFrame.h"
+#include "TH2.h"
+#include "TStyle.h"
+#include "TVirtualPad.h"
+
+#include "lareventdisplay/EventDisplay/ColorRaster.h"
+
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace {
+
+  /// Runs a compiled action when painted, without going through the interpreter
+  class ActionExec: public TExec {
+  public:
+    ActionExec(std::string const& name, std::function<void()> action)
+      : TExec(name.c_str(), ""), fAction(std::move(action))
+      {}
+
+    virtual void Exec(const char* /* command */ = "") override { fAction(); }
+
+  private:
+    std::function<void()> fAction;
+  }; // class ActionExec
+
+  /// Contour levels matching one palette entry per integral bin content
+  std::vector<double> const& PaletteLevels()
+  {
+    static std::vector<double> const levels = [](){
+      std::vector<double> levels(evd::ColorRaster::MaxColors);
+      for (unsigned int i = 0; i < levels.size(); ++i) levels[i] = i + 0.5;
+      return levels;
+    }();
+    return levels;
+  }
+
+} // local namespace
+
+
+namespace evd {
+
+  //......................................................................
+  ColorRaster::ColorRaster(std::string name)
+    : fName(std::move(name))
+    , fSetPalette(std::make_unique<ActionExec>
+        (fName + "SetPalette", [this](){ SetPalette(); }))
+    , fRestorePalette(std::make_unique<ActionExec>
+        (fName + "RestorePalette", [this](){ RestorePalette(); }))
+  {}
+
+  //......................................................................
+  ColorRaster::~ColorRaster() = default;
+
+  //......................................................................
+  void ColorRaster::Reset(
+    unsigned int nX, double xMin, double xMax,
+    unsigned int nY, double yMin, double yMax
+    )
+  {
+    nX = std::max(nX, 1U);
+    nY = std::max(nY, 1U);
+    if (!fHisto) {
+      fHisto = std::make_unique<TH2S>
+        (fName.c_str(), "", nX, xMin, xMax, nY, yMin, yMax);
+      fHisto->SetDirectory(nullptr);
+      fHisto->SetStats(false);
+      fHisto->SetBit(kCannotPick);
+      fHisto->SetContour(MaxColors, PaletteLevels().data());
+      fHisto->SetMinimum(0.5);
+      fHisto->SetMaximum(MaxColors + 0.5);
+    }
+    else {
+      fHisto->SetBins(nX, xMin, xMax, nY, yMin, yMax);
+      fHisto->Reset();
+    }
+    fNX = nX;
+    fNY = nY;
+    fNPainted = 0;
+  } // ColorRaster::Reset()
+
+  //......................................................................
+  void ColorRaster::Clear()
+  {
+    if (fHisto && (fNPainted > 0)) fHisto->Reset();
+    fNPainted = 0;
+  } // ColorRaster::Clear()
+
+  //......................................................................
+  void ColorRaster::UsePalette(std::string const& paletteID)
+  {
+    if (paletteID == fPaletteID) return;
+
+    // the codes in the histogram refer to the old palette
+    Clear();
+    fPaletteColors.clear();
+    fColorCodes.clear();
+    fPaletteID = paletteID;
+  } // ColorRaster::UsePalette()
+
+  //......................................................................
+  void ColorRaster::PaintCell(unsigned int iX, unsigned int iY, int color)
+  {
+    if (!fHisto || (iX >= fNX) || (iY >= fNY)) return;
+    int const bin = fHisto->GetBin(iX + 1, iY + 1);
+    if (fHisto->GetBinContent(bin) == 0.) ++fNPainted;
+    fHisto->SetBinContent(bin, ColorCode(color));
+  } // ColorRaster::PaintCell()
+
+  //......................................................................
+  void ColorRaster::Paint(double x, double y, int color)
+  {
+    if (!fHisto) return;
+    int const iX = fHisto->GetXaxis()->FindFixBin(x) - 1;
+    int const iY = fHisto->GetYaxis()->FindFixBin(y) - 1;
+    if ((iX < 0) || (iY < 0)) return;
+    PaintCell(iX, iY, color);
+  } // ColorRaster::Paint()
+
+  //......................................................................
+  void ColorRaster::Draw() const
+  {
+    if (!fHisto || empty()) return;
+
+    MF_LOG_DEBUG("ColorRaster") << "Drawing " << fNPainted << "/"
+      << (fNX * fNY) << " cells of raster '" << fName << "'";
+
+    // the palette is switched only while the histogram is painted
+    fSetPalette->Draw();
+    fHisto->Draw("COL SAME");
+    fRestorePalette->Draw();
+  } // ColorRaster::Draw()
+
+  //......................................................................
+  ColorRaster::Frame_t ColorRaster::ExtractFrame
+    (TVirtualPad* pPad, std::vector<double> const* zoom /* = nullptr */)
+  {
+    Frame_t frame;
+    TFrame const* pFrame = pPad? pPad->GetFrame(): nullptr;
+    if (!pFrame) return frame;
+
+    frame.xMin = pFrame->GetX1();
+    frame.xMax = pFrame->GetX2();
+    frame.yMin = pFrame->GetY1();
+    frame.yMax = pFrame->GetY2();
+    frame.width = (unsigned int)
+      (pPad->XtoAbsPixel(frame.xMax) - pPad->XtoAbsPixel(frame.xMin));
+    frame.height = (unsigned int)
+      -(pPad->YtoAbsPixel(frame.yMax) - pPad->YtoAbsPixel(frame.yMin));
+
+    // the frame coordinates are an unreliable estimation of the zoom
+    if (zoom) {
+      frame.xMin = (*zoom)[0];
+      frame.xMax = (*zoom)[1];
+      frame.yMin = (*zoom)[2];
+      frame.yMax = (*zoom)[3];
+    }
+    return frame;
+  } // ColorRaster::ExtractFrame()
+
+  //......................................................................
+  short ColorRaster::ColorCode(int color)
+  {
+    auto const iCode = fColorCodes.find(color);
+    if (iCode != fColorCodes.end()) return iCode->second;
+
+    if (fPaletteColors.size() >= MaxColors) {
+      mf::LogWarning("ColorRaster") << "Color " << color
+        << " can't be added to the palette of raster '" << fName
+        << "', which is full (" << MaxColors << " colors): using color "
+        << fPaletteColors.back();
+      return fColorCodes[color] = MaxColors;
+    }
+    fPaletteColors.push_back(color);
+    // bin content 0 is for empty cells
+    return fColorCodes[color] = fPaletteColors.size();
+  } // ColorRaster::ColorCode()
+
+  //......................................................................
+  void ColorRaster::SetPalette()
+  {
+    TArrayI const& current = TColor::GetPalette();
+    fSavedPalette.assign
+      (current.GetArray(), current.GetArray() + current.GetSize());
+
+    if (fPaletteColors.empty()) return;
+    std::vector<int> colors = fPaletteColors;
+    // unused palette entries are never painted
+    colors.resize(MaxColors, colors.back());
+    gStyle->SetPalette(colors.size(), colors.data());
+  } // ColorRaster::SetPalette()
+
+  //......................................................................
+  void ColorRaster::RestorePalette()
+  {
+    if (fSavedPalette.empty()) return;
+    gStyle->SetPalette(fSavedPalette.size(), fSavedPalette.data());
+  } // ColorRaster::RestorePalette()
+
+} // namespace evd
@@ -0,0 +1,117 @@
+/// \file    ColorRaster.h
+/// \brief   Single histogram rendering of a grid of colored cells
+#ifndef EVD_COLORRASTER_H
+#define EVD_COLORRASTER_H
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TExec;
+class TH2S;
+class TVirtualPad;
+
+namespace evd {
+
+  /**
+   * @brief Paints a grid of colored cells into a single 2D histogram
+   *
+   * This is an alternative to adding one `TBox` per cell to a view: all the
+   * cells are stored as bins of a single histogram, which is drawn with the
+   * `COL` option. The cost of painting is then bounded by the number of bins,
+   * which is chosen to match the resolution of the pad.
+   *
+   * Colors are ROOT color indices (as returned by `evdb::ColorScale`).
+   * Each raster has its own palette, collecting the colors used so far;
+   * each bin content is the position in that palette (plus one, so that
+   * empty bins are not painted).
+   * The palette is started anew when `UsePalette()` is given a different
+   * identifier, which is meant to follow the configuration of the color
+   * scale. It has room for `MaxColors` colors; the cells with colors in
+   * excess of that are painted with the last color of the palette.
+   *
+   * The histogram palette is global in ROOT: the raster makes its palette
+   * current only while it is painted, and then restores the previous one.
+   */
+  class ColorRaster {
+  public:
+
+    /// Extent of a pad frame, in user coordinates and in pixels
+    struct Frame_t {
+      double xMin = 0., xMax = 0.; ///< horizontal extent of the frame
+      double yMin = 0., yMax = 0.; ///< vertical extent of the frame
+      unsigned int width = 0;      ///< horizontal size of the frame in pixels
+      unsigned int height = 0;     ///< vertical size of the frame in pixels
+
+      /// Returns whether the frame information is available
+      bool isValid() const { return (width != 0) && (height != 0); }
+    }; // Frame_t
+
+    /// Maximum number of different colors supported by the palette
+    static constexpr unsigned int MaxColors = 255;
+
+    explicit ColorRaster(std::string name);
+    ~ColorRaster();
+
+    /// Prepares an empty raster of nX x nY cells covering the specified area
+    void Reset(
+      unsigned int nX, double xMin, double xMax,
+      unsigned int nY, double yMin, double yMax
+      );
+
+    /// Removes all the painted cells; the raster will not be drawn
+    void Clear();
+
+    /// Starts a new palette if `paletteID` differs from the current one
+    void UsePalette(std::string const& paletteID);
+
+    /// Paints the cell with the specified indices (from 0)
+    void PaintCell(unsigned int iX, unsigned int iY, int color);
+
+    /// Paints the cell including the specified point (ignored if outside)
+    void Paint(double x, double y, int color);
+
+    /// Number of cells on each axis
+    unsigned int NCellsX() const { return fNX; }
+    unsigned int NCellsY() const { return fNY; }
+
+    /// Returns whether no cell has been painted
+    bool empty() const { return fNPainted == 0; }
+
+    /// Draws the raster into the current pad, on top of the existing frame
+    void Draw() const;
+
+    /// Returns the frame of the pad, with zoom range if specified
+    static Frame_t ExtractFrame
+      (TVirtualPad* pPad, std::vector<double> const* zoom = nullptr);
+
+  private:
+    std::string fName;             ///< name of the histogram
+    std::unique_ptr<TH2S> fHisto;  ///< the histogram holding the cells
+    unsigned int fNX = 0;          ///< number of cells on x axis
+    unsigned int fNY = 0;          ///< number of cells on y axis
+    unsigned int fNPainted = 0;    ///< number of cells painted so far
+
+    std::string fPaletteID;                    ///< identifier of the palette
+    std::vector<int> fPaletteColors;           ///< palette, in order of first use
+    std::unordered_map<int, short> fColorCodes; ///< palette content of each color
+    std::vector<int> fSavedPalette;            ///< palette before painting
+
+    std::unique_ptr<TExec> fSetPalette;     ///< sets the palette when painted
+    std::unique_ptr<TExec> fRestorePalette; ///< restores it when painted
+
+    /// Returns the palette content for the specified color
+    short ColorCode(int color);
+
+    /// Saves the current palette and sets the one of this raster
+    void SetPalette();
+
+    /// Restores the palette saved by `SetPalette()`
+    void RestorePalette();
+
+  }; // class ColorRaster
+
+} // namespace evd
+
+#endif // EVD_COLORRASTER_H
@@ -6,7 +6,10 @@
 #include "TPad.h"
 #include "TView3D.h"
 
+#include <typeinfo> // typeid
+
 #include "lareventdisplay/EventDisplay/Display3DPad.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 #include "nuevdb/EventDisplayBase/View3D.h"
 #include "nuevdb/EventDisplayBase/EventHolder.h"
 #include "larcore/Geometry/Geometry.h"
@@ -20,6 +23,7 @@
 #include "art/Framework/Principal/fwd.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Utilities/make_tool.h"
+#include "cetlib_except/demangle.h"
 
 namespace evd{
 
@@ -55,6 +59,8 @@ Display3DPad::Display3DPad(const char* nm, const char* ti,
         const fhicl::ParameterSet& draw3DToolParamSet = drawSim3DTools.get<fhicl::ParameterSet>(draw3DTool);
         
         fSim3DDrawerVec.push_back(art::make_tool<evdb_tool::ISim3DDrawer>(draw3DToolParamSet));
+        auto const& drawer = *(fSim3DDrawerVec.back());
+        fSim3DDrawerNames.push_back(cet::demangle_symbol(typeid(drawer).name()));
     }
     
     // Set up the 3D drawing tools for the reconstruction
@@ -68,6 +74,8 @@ Display3DPad::Display3DPad(const char* nm, const char* ti,
         const fhicl::ParameterSet& draw3DToolParamSet = drawReco3DTools.get<fhicl::ParameterSet>(draw3DTool);
         
         fReco3DDrawerVec.push_back(art::make_tool<evdb_tool::I3DDrawer>(draw3DToolParamSet));
+        auto const& drawer = *(fReco3DDrawerVec.back());
+        fReco3DDrawerNames.push_back(cet::demangle_symbol(typeid(drawer).name()));
     }
 
     return;
@@ -91,39 +99,69 @@ void Display3DPad::Draw()
     // grab the event from the singleton
     const art::Event *evt = evdb::EventHolder::Instance()->GetEvent();
 
+    // the pad and its 3D view are ready before drawing: some drawers
+    // adapt the level of detail to the region being shown;
+    // clearing the pad deletes its view, so the region (zoom) and the angles
+    // of the current view are carried over to the new one
+    double rmin[]={-2.1*geo->DetHalfWidth(),-2.1*geo->DetHalfHeight(),-0.5*geo->DetLength()};
+    double rmax[]={ 2.1*geo->DetHalfWidth(), 2.1*geo->DetHalfHeight(), 0.5*geo->DetLength()};
+    double longitude = 0.0, latitude = 260.0, psi = 270.0;
+    if (TView* oldView = fPad->GetView()) {
+        oldView->GetRange(rmin, rmax);
+        longitude = oldView->GetLongitude();
+        latitude  = oldView->GetLatitude();
+        psi       = oldView->GetPsi();
+    }
+    this->Pad()->Clear();
+    this->Pad()->cd();
+    if (fPad->GetView()==0) {
+        int irep;
+        TView3D* v = new TView3D(1,rmin,rmax);
+        v->SetPerspective();
+        v->SetView(longitude,latitude,psi,irep);
+        fPad->SetView(v); // ROOT takes ownership of object *v
+    }
+
     if(evt){
+        DrawingProfiler::Scope profile(fPad->GetName(), "DetOutline3D");
         this->GeometryDraw()->DetOutline3D(fView);
 //        this->SimulationDraw()->MCTruth3D    (*evt, fView);
+        profile.Next("PFParticle3D");
         this->RecoBaseDraw()->  PFParticle3D (*evt, fView);
+        profile.Next("Edge3D");
         this->RecoBaseDraw()->  Edge3D       (*evt, fView);
+        profile.Next("SpacePoint3D");
         this->RecoBaseDraw()->  SpacePoint3D (*evt, fView);
+        profile.Next("Prong3D");
         this->RecoBaseDraw()->  Prong3D      (*evt, fView);
+        profile.Next("Seed3D");
         this->RecoBaseDraw()->  Seed3D       (*evt, fView);
+        profile.Next("Vertex3D");
         this->RecoBaseDraw()->  Vertex3D     (*evt, fView);
+        profile.Next("Event3D");
         this->RecoBaseDraw()->  Event3D      (*evt, fView);
+        profile.Next("Slice3D");
         this->RecoBaseDraw()->  Slice3D      (*evt, fView);
 
         // Call the 3D simulation drawing tools
-        for(auto& draw3D : fSim3DDrawerVec) draw3D->Draw(*evt, fView);
+        for(size_t iDrawer = 0; iDrawer < fSim3DDrawerVec.size(); ++iDrawer) {
+            profile.Next(fSim3DDrawerNames[iDrawer].c_str());
+            fSim3DDrawerVec[iDrawer]->Draw(*evt, fView);
+        }
         
         // Call the 3D reco drawing tools
-        for(auto& draw3D : fReco3DDrawerVec) draw3D->Draw(*evt, fView);
+        for(size_t iDrawer = 0; iDrawer < fReco3DDrawerVec.size(); ++iDrawer) {
+            profile.Next(fReco3DDrawerNames[iDrawer].c_str());
+            fReco3DDrawerVec[iDrawer]->Draw(*evt, fView);
+        }
         
     }
 
-    this->Pad()->Clear();
-    this->Pad()->cd();
-    if (fPad->GetView()==0) {
-        int irep;
-        double rmin[]={-2.1*geo->DetHalfWidth(),-2.1*geo->DetHalfHeight(),-0.5*geo->DetLength()};
-        double rmax[]={ 2.1*geo->DetHalfWidth(), 2.1*geo->DetHalfHeight(), 0.5*geo->DetLength()};
-        TView3D* v = new TView3D(1,rmin,rmax);
-        v->SetPerspective();
-        v->SetView(0.0,260.0,270.0,irep);
-        fPad->SetView(v); // ROOT takes ownership of object *v
+    {
+        DrawingProfiler::Scope profile(fPad->GetName(), "View3D::Draw", fPad);
+        fView->Draw();
+        fPad->Update();
     }
-    fView->Draw();
-    fPad->Update();
 }
 
 
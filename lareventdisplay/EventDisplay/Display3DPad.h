@@ -7,6 +7,7 @@
 #define EVD_DISPLAY3DPAD_H
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "lareventdisplay/EventDisplay/DrawingPad.h"
@@ -37,6 +38,10 @@ private:
 
     std::vector<std::unique_ptr<evdb_tool::ISim3DDrawer>> fSim3DDrawerVec;
     std::vector<std::unique_ptr<evdb_tool::I3DDrawer>>    fReco3DDrawerVec;
+
+    /// Names of the drawing tools, for profiling (outlive the drawing)
+    std::vector<std::string> fSim3DDrawerNames;
+    std::vector<std::string> fReco3DDrawerNames;
 };
 }
 
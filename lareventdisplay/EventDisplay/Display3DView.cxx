@@ -7,6 +7,7 @@
 #include "TVirtualViewer3D.h"
 #include "lareventdisplay/EventDisplay/Display3DView.h"
 #include "lareventdisplay/EventDisplay/Display3DPad.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 
 namespace evd{
 
@@ -39,6 +40,7 @@ namespace evd{
   //......................................................................
   void Display3DView::Draw(const char* /*opt*/)
   {
+    DrawingProfiler::Instance().UpdateEvent();
     fDisplay3DPad->Draw();
     evdb::Canvas::fCanvas->Update();
 
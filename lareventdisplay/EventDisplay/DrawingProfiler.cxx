@@ -0,0 +1,366 @@
+/// \file    DrawingProfiler.cxx
+/// \brief   Time and resources spent by each drawer of the event display pads
+
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
+
+#include <algorithm> // std::sort()
+#include <iomanip> // std::setw()
+#include <utility> // std::pair
+#include <vector>
+#if defined(__GLIBC__)
+#  include <malloc.h> // mallinfo2()
+#endif
+
+#include "TBox.h"
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TLine.h"
+#include "TList.h"
+#include "TMarker.h"
+#include "TPolyLine.h"
+#include "TPolyMarker.h"
+#include "TTree.h"
+#include "TVirtualPad.h"
+
+#include "lareventdisplay/EventDisplay/EvdLayoutOptions.h"
+#include "nuevdb/EventDisplayBase/EventHolder.h"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace {
+
+  /// Returns the string with quotes and backslashes escaped for JSON
+  std::string JSONescape(std::string const& s)
+  {
+    std::string escaped;
+    escaped.reserve(s.size());
+    for (char c: s) {
+      if ((c == '"') || (c == '\\')) escaped += '\\';
+      escaped += c;
+    }
+    return escaped;
+  } // JSONescape()
+
+  /// Returns the bytes currently allocated on the heap (0 if unknown)
+  long int HeapInUse()
+  {
+#if defined(__GLIBC__)
+#  if __GLIBC_PREREQ(2, 33)
+    struct mallinfo2 const info = ::mallinfo2();
+    return static_cast<long int>(info.uordblks + info.hblkhd);
+#  endif
+#endif
+    return 0L;
+  } // HeapInUse()
+
+  /// Returns the time in milliseconds
+  double ToMilliseconds(evd::DrawingProfiler::Clock_t::duration d)
+    { return std::chrono::duration<double, std::milli>(d).count(); }
+
+} // local namespace
+
+
+namespace evd {
+
+  //......................................................................
+  DrawingProfiler::Primitives_t& DrawingProfiler::Primitives_t::operator+=
+    (Primitives_t const& other)
+  {
+    boxes += other.boxes;
+    lines += other.lines;
+    markers += other.markers;
+    others += other.others;
+    return *this;
+  } // DrawingProfiler::Primitives_t::operator+=()
+
+  //......................................................................
+  DrawingProfiler::Primitives_t DrawingProfiler::Primitives_t::operator-
+    (Primitives_t const& other) const
+  {
+    Primitives_t diff;
+    diff.boxes = boxes - other.boxes;
+    diff.lines = lines - other.lines;
+    diff.markers = markers - other.markers;
+    diff.others = others - other.others;
+    return diff;
+  } // DrawingProfiler::Primitives_t::operator-()
+
+  //......................................................................
+  DrawingProfiler::Primitives_t DrawingProfiler::Primitives_t::CountIn
+    (TVirtualPad* pad)
+  {
+    Primitives_t counts;
+    TList const* primitives = pad? pad->GetListOfPrimitives(): nullptr;
+    if (!primitives) return counts;
+    for (TObject const* obj: *primitives) {
+      if (!obj) continue;
+      if (obj->InheritsFrom(TBox::Class())) ++counts.boxes;
+      else if (obj->InheritsFrom(TLine::Class())
+        || obj->InheritsFrom(TPolyLine::Class())) ++counts.lines;
+      else if (obj->InheritsFrom(TMarker::Class())
+        || obj->InheritsFrom(TPolyMarker::Class())) ++counts.markers;
+      else ++counts.others;
+    } // for
+    return counts;
+  } // DrawingProfiler::Primitives_t::CountIn()
+
+  //......................................................................
+  void DrawingProfiler::Scope::Start(DrawingProfiler& profiler)
+  {
+    fProfiler = &profiler;
+    if (fCountIn) fStartPrimitives = Primitives_t::CountIn(fCountIn);
+    fStartHeap = HeapInUse();
+    fStart = Clock_t::now();
+  } // DrawingProfiler::Scope::Start()
+
+  //......................................................................
+  void DrawingProfiler::Scope::Stop()
+  {
+    Clock_t::time_point const stop = Clock_t::now();
+    long int const heap = HeapInUse();
+    if (fCountIn) {
+      Primitives_t const primitives = Primitives_t::CountIn(fCountIn);
+      Primitives_t const added = primitives - fStartPrimitives;
+      fProfiler->Record
+        (fPad, fDrawer, fStart, stop, &added, heap - fStartHeap);
+      fStartPrimitives = primitives;
+    }
+    else
+      fProfiler->Record(fPad, fDrawer, fStart, stop, nullptr, heap - fStartHeap);
+
+    // the next drawer (if any) starts from here; counting is not timed
+    fStartHeap = heap;
+    fStart = Clock_t::now();
+  } // DrawingProfiler::Scope::Stop()
+
+
+  //......................................................................
+  DrawingProfiler& DrawingProfiler::Instance()
+  {
+    static DrawingProfiler profiler;
+    return profiler;
+  } // DrawingProfiler::Instance()
+
+  //......................................................................
+  DrawingProfiler::~DrawingProfiler()
+  {
+    // the tree file is left to ROOT, which may be gone by now
+    if (fTrace.is_open()) fTrace << "\n]\n";
+  } // DrawingProfiler::~DrawingProfiler()
+
+  //......................................................................
+  void DrawingProfiler::UpdateEvent()
+  {
+    art::Event const* evt = evdb::EventHolder::Instance()->GetEvent();
+    if (!evt) return;
+    util::EventChangeTracker_t const current(*evt);
+    if (current != fEvent) {
+      Summarize(); // the statistics so far belong to the previous event
+      fEvent = current;
+      fEventID = evt->id();
+    }
+    Configure();
+  } // DrawingProfiler::UpdateEvent()
+
+  //......................................................................
+  void DrawingProfiler::Record(
+    std::string const& pad, std::string const& drawer,
+    Clock_t::time_point start, Clock_t::time_point stop,
+    Primitives_t const* primitives, long int heapBytes
+    )
+  {
+    Stats_t& stats = fStats[{ pad, drawer }];
+    ++stats.nCalls;
+    stats.time += ToMilliseconds(stop - start);
+    stats.heapBytes += heapBytes;
+    if (primitives) {
+      stats.countsPrimitives = true;
+      stats.primitives += *primitives;
+    }
+
+    if (fTrace.is_open())
+      Trace(pad, drawer, start, stop, primitives, heapBytes);
+  } // DrawingProfiler::Record()
+
+  //......................................................................
+  void DrawingProfiler::Summarize()
+  {
+    if (fStats.empty()) return;
+
+    // slowest drawers first
+    using Entry_t = std::pair<std::pair<std::string, std::string>, Stats_t>;
+    std::vector<Entry_t> entries(fStats.begin(), fStats.end());
+    std::sort(entries.begin(), entries.end(),
+      [](Entry_t const& a, Entry_t const& b)
+        { return a.second.time > b.second.time; }
+      );
+
+    double totalTime = 0.;
+    for (Entry_t const& entry: entries) totalTime += entry.second.time;
+
+    mf::LogInfo log("DrawingProfiler");
+    log << "Drawing time of " << std::string(fEvent) << ": "
+      << totalTime << " ms in " << entries.size() << " drawers";
+    for (auto const& [ id, stats ]: entries) {
+      log << "\n  " << std::setw(16) << id.first << "  "
+        << std::setw(24) << id.second << "  " << std::setw(10) << stats.time
+        << " ms  " << std::setw(4) << stats.nCalls << " calls  "
+        << std::setw(8) << (stats.heapBytes / 1024) << " kiB";
+      if (stats.countsPrimitives) {
+        Primitives_t const& primitives = stats.primitives;
+        log << "  " << primitives.total() << " primitives ("
+          << primitives.boxes << " boxes, " << primitives.lines << " lines, "
+          << primitives.markers << " markers)";
+      }
+    } // for
+
+    if (fTree) {
+      fTreeEntry.run = fEventID.run();
+      fTreeEntry.subRun = fEventID.subRun();
+      fTreeEntry.event = fEventID.event();
+      for (auto const& [ id, stats ]: entries) {
+        fTreeEntry.pad = id.first;
+        fTreeEntry.drawer = id.second;
+        fTreeEntry.stats = stats;
+        fTree->Fill();
+      } // for
+      // keeps the file readable while the display is still running
+      fTree->AutoSave("SaveSelf");
+    } // if tree
+
+    fStats.clear();
+  } // DrawingProfiler::Summarize()
+
+  //......................................................................
+  void DrawingProfiler::Close()
+  {
+    Summarize();
+
+    if (fTrace.is_open()) {
+      fTrace << "\n]\n";
+      fTrace.close();
+    }
+    fTraceFileName.clear();
+
+    if (fTreeFile) {
+      fTreeFile->Write();
+      delete fTreeFile; // also deletes the tree
+      fTreeFile = nullptr;
+      fTree = nullptr;
+    }
+    fTreeFileName.clear();
+  } // DrawingProfiler::Close()
+
+  //......................................................................
+  void DrawingProfiler::Configure()
+  {
+    art::ServiceHandle<evd::EvdLayoutOptions const> evdlayoutopt;
+
+    // when profiling is switched off, what was collected is reported at once
+    bool const enabled = evdlayoutopt->fProfileDrawing;
+    if (fEnabled && !enabled) Summarize();
+    fEnabled = enabled;
+    if (!fEnabled) return;
+
+    if (evdlayoutopt->fDrawingTraceFile != fTraceFileName)
+      OpenTrace(evdlayoutopt->fDrawingTraceFile);
+    if (evdlayoutopt->fDrawingProfileFile != fTreeFileName)
+      OpenTree(evdlayoutopt->fDrawingProfileFile);
+  } // DrawingProfiler::Configure()
+
+  //......................................................................
+  void DrawingProfiler::OpenTrace(std::string const& fileName)
+  {
+    if (fTrace.is_open()) {
+      fTrace << "\n]\n";
+      fTrace.close();
+    }
+    fTraceFileName = fileName;
+    if (fTraceFileName.empty()) return;
+
+    fTrace.open(fTraceFileName);
+    if (!fTrace) {
+      mf::LogWarning("DrawingProfiler")
+        << "Can't write the drawing trace into '" << fTraceFileName << "'";
+      return;
+    }
+    fTrace << "[";
+    fTraceStart = Clock_t::now();
+    mf::LogInfo("DrawingProfiler")
+      << "Writing the drawing trace into '" << fTraceFileName << "'";
+  } // DrawingProfiler::OpenTrace()
+
+  //......................................................................
+  void DrawingProfiler::OpenTree(std::string const& fileName)
+  {
+    if (fTreeFile) {
+      fTreeFile->Write();
+      delete fTreeFile;
+      fTreeFile = nullptr;
+      fTree = nullptr;
+    }
+    fTreeFileName = fileName;
+    if (fTreeFileName.empty()) return;
+
+    // ROOT keeps the tree in the current directory: do not change it
+    TDirectory::TContext const context;
+    fTreeFile = TFile::Open(fTreeFileName.c_str(), "RECREATE");
+    if (!fTreeFile || fTreeFile->IsZombie()) {
+      mf::LogWarning("DrawingProfiler")
+        << "Can't write the drawing profile into '" << fTreeFileName << "'";
+      delete fTreeFile;
+      fTreeFile = nullptr;
+      return;
+    }
+
+    fTree = new TTree
+      ("DrawingProfile", "Time and resources spent by each drawer");
+    fTree->SetDirectory(fTreeFile);
+    TreeEntry_t& entry = fTreeEntry;
+    fTree->Branch("run", &entry.run);
+    fTree->Branch("subRun", &entry.subRun);
+    fTree->Branch("event", &entry.event);
+    fTree->Branch("pad", &entry.pad);
+    fTree->Branch("drawer", &entry.drawer);
+    fTree->Branch("nCalls", &entry.stats.nCalls);
+    fTree->Branch("time", &entry.stats.time); // [ms]
+    fTree->Branch("heapBytes", &entry.stats.heapBytes);
+    fTree->Branch("countsPrimitives", &entry.stats.countsPrimitives);
+    fTree->Branch("boxes", &entry.stats.primitives.boxes);
+    fTree->Branch("lines", &entry.stats.primitives.lines);
+    fTree->Branch("markers", &entry.stats.primitives.markers);
+    fTree->Branch("others", &entry.stats.primitives.others);
+
+    mf::LogInfo("DrawingProfiler")
+      << "Writing the drawing profile into '" << fTreeFileName << "'";
+  } // DrawingProfiler::OpenTree()
+
+  //......................................................................
+  void DrawingProfiler::Trace(
+    std::string const& pad, std::string const& drawer,
+    Clock_t::time_point start, Clock_t::time_point stop,
+    Primitives_t const* primitives, long int heapBytes
+    )
+  {
+    using microseconds = std::chrono::duration<double, std::micro>;
+
+    // entries are separated by commas; the first one follows the "["
+    if (fTrace.tellp() > 1) fTrace << ",";
+    fTrace << "\n{\"name\":\"" << JSONescape(drawer)
+      << "\",\"cat\":\"" << JSONescape(pad)
+      << "\",\"ph\":\"X\",\"ts\":" << microseconds(start - fTraceStart).count()
+      << ",\"dur\":" << microseconds(stop - start).count()
+      << ",\"pid\":0,\"tid\":0,\"args\":{\"event\":\""
+      << std::string(fEvent) << "\",\"heapBytes\":" << heapBytes;
+    if (primitives) {
+      fTrace << ",\"boxes\":" << primitives->boxes
+        << ",\"lines\":" << primitives->lines
+        << ",\"markers\":" << primitives->markers
+        << ",\"others\":" << primitives->others;
+    }
+    fTrace << "}}";
+  } // DrawingProfiler::Trace()
+
+} // namespace evd
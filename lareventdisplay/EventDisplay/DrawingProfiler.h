@@ -0,0 +1,202 @@
+/// \file    DrawingProfiler.h
+/// \brief   Time and resources spent by each drawer of the event display pads
+#ifndef EVD_DRAWINGPROFILER_H
+#define EVD_DRAWINGPROFILER_H
+
+#include <chrono>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility> // std::pair
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+#include "canvas/Persistency/Provenance/EventID.h"
+
+class TFile;
+class TTree;
+class TVirtualPad;
+
+namespace evd {
+
+  /**
+   * @brief Collects the time spent in each drawer call, event by event
+   *
+   * The pads open a `Scope` around each call to a drawer. When profiling is
+   * enabled (`ProfileDrawing` in `EvdLayoutOptions`), the time of each scope
+   * is added to the statistics of its pad and drawer, together with the
+   * change of the memory allocated on the heap while the scope was open.
+   * The heap is shared by the whole process, so this change includes the
+   * work of other threads (like the background uncompression of raw
+   * digits), and it is not tracked at all where the C library can't report
+   * it. A scope can also count the graphic primitives (boxes, lines,
+   * markers and others) added to a ROOT pad while it was open: the pads use
+   * this when painting their views.
+   *
+   * The statistics of an event are reported when the display moves to
+   * another event, when profiling is switched off, when `Summarize()` is
+   * called and at the end of the job (`Close()`). The report is printed on
+   * the message facility (category `DrawingProfiler`) and, if
+   * `DrawingProfileFile` is set, written into a ROOT tree `DrawingProfile`
+   * in that file, one entry per event, pad and drawer.
+   *
+   * If `DrawingTraceFile` is set, each scope is also written into that file
+   * as a "complete" event of the Chrome trace event format (JSON array
+   * format, which allows the file to be read also while still open).
+   *
+   * The views call `UpdateEvent()` before drawing their pads, which is where
+   * the event and the configuration are checked: the scopes only check
+   * whether profiling is enabled, and do nothing else if it is not.
+   * The profiler is not thread-safe: scopes must be opened in the thread
+   * drawing the pads.
+   */
+  class DrawingProfiler {
+  public:
+
+    using Clock_t = std::chrono::steady_clock;
+
+    /// Number of graphic primitives, by kind
+    struct Primitives_t {
+      long int boxes = 0; ///< boxes
+      long int lines = 0; ///< lines and polylines
+      long int markers = 0; ///< markers and polymarkers
+      long int others = 0; ///< anything else (text, histograms, frames...)
+
+      /// Returns the total number of primitives
+      long int total() const { return boxes + lines + markers + others; }
+
+      /// Adds the counts of `other`
+      Primitives_t& operator+= (Primitives_t const& other);
+
+      /// Returns the counts of this object minus the ones of `other`
+      Primitives_t operator- (Primitives_t const& other) const;
+
+      /// Returns the primitives in `pad`, by kind
+      static Primitives_t CountIn(TVirtualPad* pad);
+    }; // Primitives_t
+
+    /// Times the code until the scope is closed, or the next drawer starts
+    class Scope {
+    public:
+      /**
+       * @brief Starts timing `drawer` of `pad`; counts primitives in `countIn`
+       *
+       * The names are not copied, and they must outlive the scope.
+       */
+      Scope(char const* pad, char const* drawer, TVirtualPad* countIn = nullptr)
+        : fPad(pad), fDrawer(drawer), fCountIn(countIn)
+        {
+          DrawingProfiler& profiler = DrawingProfiler::Instance();
+          if (profiler.isEnabled()) Start(profiler);
+        }
+
+      Scope(Scope const&) = delete;
+      Scope& operator= (Scope const&) = delete;
+
+      /// Records the current drawer and starts timing `drawer`
+      void Next(char const* drawer)
+        { if (fProfiler) { Stop(); fDrawer = drawer; } }
+
+      ~Scope() { if (fProfiler) Stop(); }
+
+    private:
+      DrawingProfiler* fProfiler = nullptr; ///< where to record (if enabled)
+      char const* fPad; ///< name of the pad being drawn
+      char const* fDrawer; ///< name of the drawer being timed
+      TVirtualPad* fCountIn; ///< pad whose primitives are counted
+      Primitives_t fStartPrimitives; ///< primitives in `fCountIn` at start
+      long int fStartHeap = 0; ///< bytes allocated on the heap at start
+      Clock_t::time_point fStart; ///< start of the current timing
+
+      /// Starts timing into `profiler`
+      void Start(DrawingProfiler& profiler);
+
+      /// Records the current timing, and starts counting anew from now
+      void Stop();
+
+    }; // class Scope
+
+    /// Returns the profiler shared by the whole event display
+    static DrawingProfiler& Instance();
+
+    ~DrawingProfiler();
+
+    /// Returns whether drawing is currently being profiled
+    bool isEnabled() const { return fEnabled; }
+
+    /// Moves to the current event, summarizing the previous one if different,
+    /// and reads the configuration
+    void UpdateEvent();
+
+    /// Adds a timing of `drawer` of `pad`; null `primitives` if not counted
+    void Record(
+      std::string const& pad, std::string const& drawer,
+      Clock_t::time_point start, Clock_t::time_point stop,
+      Primitives_t const* primitives, long int heapBytes
+      );
+
+    /// Reports the statistics of the current event, and resets them
+    void Summarize();
+
+    /// Reports the statistics of the current event, and closes the files
+    void Close();
+
+  private:
+
+    /// Statistics of one drawer of one pad
+    struct Stats_t {
+      unsigned int nCalls = 0; ///< number of timed calls
+      double time = 0.; ///< total wall time [ms]
+      long int heapBytes = 0; ///< change of the memory allocated on the heap
+      bool countsPrimitives = false; ///< whether primitives were counted
+      Primitives_t primitives; ///< primitives added to the pad
+    }; // Stats_t
+
+    /// Content of an entry of the profile tree
+    struct TreeEntry_t {
+      unsigned int run = 0;
+      unsigned int subRun = 0;
+      unsigned int event = 0;
+      std::string pad;
+      std::string drawer;
+      Stats_t stats;
+    }; // TreeEntry_t
+
+    util::EventChangeTracker_t fEvent; ///< the event being profiled
+    art::EventID fEventID; ///< ID of the event being profiled
+    bool fEnabled = false; ///< whether profiling is enabled
+
+    /// Statistics by pad and drawer
+    std::map<std::pair<std::string, std::string>, Stats_t> fStats;
+
+    std::string fTraceFileName; ///< name of the trace file (if any)
+    std::ofstream fTrace; ///< trace file (if open)
+    Clock_t::time_point fTraceStart; ///< time of the start of the trace
+
+    std::string fTreeFileName; ///< name of the profile tree file (if any)
+    TFile* fTreeFile = nullptr; ///< profile tree file (if open)
+    TTree* fTree = nullptr; ///< profile tree (owned by `fTreeFile`)
+    TreeEntry_t fTreeEntry; ///< the entry being written into `fTree`
+
+    DrawingProfiler() = default;
+
+    /// Reads the configuration, opening the output files if needed
+    void Configure();
+
+    /// Closes the current trace file, and opens the one with `fileName`
+    void OpenTrace(std::string const& fileName);
+
+    /// Closes the current tree file, and opens the one with `fileName`
+    void OpenTree(std::string const& fileName);
+
+    /// Writes a trace event
+    void Trace(
+      std::string const& pad, std::string const& drawer,
+      Clock_t::time_point start, Clock_t::time_point stop,
+      Primitives_t const* primitives, long int heapBytes
+      );
+
+  }; // class DrawingProfiler
+
+} // namespace evd
+
+#endif // EVD_DRAWINGPROFILER_H
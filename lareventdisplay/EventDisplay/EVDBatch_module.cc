@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////
+/// \file EVDBatch_module.cc
+///
+/// \brief Renders the event display views of selected events into files,
+///        without graphical interface
+
+// C/C++ standard libraries
+#include <algorithm> // std::find()
+#include <array>
+#include <iterator> // std::next()
+#include <memory> // std::unique_ptr
+#include <string>
+#include <vector>
+
+// ROOT libraries
+#include "TCanvas.h"
+#include "TROOT.h"
+#include "TString.h" // Form()
+
+// Framework includes
+#include "art/Framework/Core/EDAnalyzer.h"
+#include "art/Framework/Core/ModuleMacros.h"
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Services/Registry/ServiceHandle.h"
+#include "canvas/Utilities/Exception.h"
+#include "fhiclcpp/ParameterSet.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+//LArSoft includes
+#include "larcore/Geometry/Geometry.h"
+#include "lareventdisplay/EventDisplay/Display3DPad.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
+#include "lareventdisplay/EventDisplay/HeaderPad.h"
+#include "lareventdisplay/EventDisplay/OrthoProj.h"
+#include "lareventdisplay/EventDisplay/Ortho3DPad.h"
+#include "lareventdisplay/EventDisplay/RawDataDrawer.h"
+#include "lareventdisplay/EventDisplay/TWireProjPad.h"
+#include "nuevdb/EventDisplayBase/EventHolder.h"
+
+namespace evd{
+
+  /**
+   * @brief Saves pictures of the event display views, with no display needed
+   *
+   * The module draws the selected events with the same pads the interactive
+   * event display uses (`EVD` module), each view on its own canvas, and saves
+   * each canvas into one file per requested format.
+   * ROOT is put in batch mode, so no X display is required.
+   * The drawing options are taken from the usual event display services.
+   *
+   * Configuration parameters:
+   * * `Views` (default: `[ "WirePlanes" ]`): the views to be rendered, among
+   *   `WirePlanes` (time vs. wire, one pad per plane), `Ortho3D` (XZ and YZ
+   *   projections) and `Display3D`
+   * * `Events` (default: empty): list of `[ run, subrun, event ]` to be
+   *   rendered; all the events are rendered if empty
+   * * `OutputPattern` (default: `"evd_%v_r%r_s%s_e%e"`): name of the output
+   *   files, without suffix; `%v` is replaced by the view name, `%r`, `%s`
+   *   and `%e` by run, subrun and event number
+   * * `FileFormats` (default: `[ "png" ]`): formats of the output files, as
+   *   accepted by `TCanvas::SaveAs()` (e.g. `png`, `pdf`, `svg`)
+   * * `CanvasWidth`, `CanvasHeight` (default: `1400`, `1000`): size of the
+   *   canvases, in pixels
+   *
+   * The data of all the wire planes is prepared in parallel before drawing
+   * (see `TWireProjPad::PrepareDraw()`); the drawing itself happens in the
+   * module thread, since ROOT graphics are not thread-safe.
+   */
+  class EVDBatch : public art::EDAnalyzer
+  {
+   public:
+     explicit EVDBatch(fhicl::ParameterSet const &pset);
+
+     void analyze(art::Event const& evt) override;
+     void beginJob() override;
+     void endJob() override;
+
+  private:
+
+    /// A view: a canvas with its pads
+    struct View_t {
+      std::string name; ///< name of the view, used in the output file name
+      std::unique_ptr<TCanvas> canvas; ///< the canvas hosting the pads
+      std::unique_ptr<HeaderPad> header; ///< event header pad, if any
+      std::vector<std::unique_ptr<TWireProjPad>> planes; ///< wire plane pads
+      std::vector<std::unique_ptr<Ortho3DPad>> orthoPads; ///< projection pads
+      std::unique_ptr<Display3DPad> display3D; ///< 3D pad, if any
+
+      /// Draws all the pads of the view
+      void Draw();
+
+      /// Deletes all the pads (the canvas stays)
+      void ClearPads();
+    }; // View_t
+
+    using EventID_t = std::array<unsigned int, 3U>; ///< run, subrun, event
+
+    std::vector<std::string> fViewNames; ///< names of the views to render
+    std::vector<EventID_t> fEvents; ///< events to be rendered (empty: all)
+    std::string fOutputPattern; ///< pattern of the output file name
+    std::vector<std::string> fFileFormats; ///< formats of the output files
+    unsigned int fCanvasWidth; ///< width of the canvases [pixel]
+    unsigned int fCanvasHeight; ///< height of the canvases [pixel]
+
+    std::vector<View_t> fViews; ///< the views being rendered
+    unsigned int fNRendered = 0U; ///< number of events rendered so far
+
+    /// Returns whether the event is among the ones to be rendered
+    bool isSelected(art::Event const& evt) const;
+
+    /// Creates the canvas and the pads of the specified view
+    View_t makeView(std::string const& name) const;
+
+    /// Returns the name of the output file of a view, without suffix
+    std::string outputFileName
+      (std::string const& viewName, art::Event const& evt) const;
+
+   };
+}
+
+
+namespace evd{
+
+  //----------------------------------------------------
+  EVDBatch::EVDBatch(fhicl::ParameterSet const& pset)
+    : EDAnalyzer(pset)
+    , fViewNames(pset.get<std::vector<std::string>>
+        ("Views", std::vector<std::string>{ "WirePlanes" }))
+    , fOutputPattern(pset.get<std::string>
+        ("OutputPattern", "evd_%v_r%r_s%s_e%e"))
+    , fFileFormats(pset.get<std::vector<std::string>>
+        ("FileFormats", std::vector<std::string>{ "png" }))
+    , fCanvasWidth(pset.get<unsigned int>("CanvasWidth", 1400U))
+    , fCanvasHeight(pset.get<unsigned int>("CanvasHeight", 1000U))
+  {
+    using EventList_t = std::vector<std::vector<unsigned int>>;
+    for (auto const& eventID: pset.get<EventList_t>("Events", EventList_t{})) {
+      if (eventID.size() != 3U) {
+        throw art::Exception(art::errors::Configuration)
+          << "EVDBatch: each entry in 'Events' must be [ run, subrun, event ]"
+          ", found one with " << eventID.size() << " numbers instead.\n";
+      }
+      fEvents.push_back(EventID_t{{ eventID[0], eventID[1], eventID[2] }});
+    } // for
+
+    if (fFileFormats.empty()) {
+      throw art::Exception(art::errors::Configuration)
+        << "EVDBatch: no output format ('FileFormats') requested.\n";
+    }
+  }
+
+  //----------------------------------------------------
+  void EVDBatch::beginJob()
+  {
+    // no window, ever: canvases are drawn in memory only
+    gROOT->SetBatch(kTRUE);
+
+    for (std::string const& name: fViewNames)
+      fViews.push_back(makeView(name));
+  }
+
+  //----------------------------------------------------
+  void EVDBatch::analyze(const art::Event& evt)
+  {
+    if (!isSelected(evt)) return;
+
+    evdb::EventHolder::Instance()->SetEvent(&evt);
+    DrawingProfiler::Instance().UpdateEvent();
+
+    for (View_t& view: fViews) {
+      view.canvas->cd();
+      view.Draw();
+      view.canvas->Modified();
+      view.canvas->Update();
+
+      std::string const fileName = outputFileName(view.name, evt);
+      for (std::string const& format: fFileFormats) {
+        view.canvas->SaveAs((fileName + "." + format).c_str());
+      }
+      mf::LogInfo("EVDBatch") << "View '" << view.name << "' of "
+        << evt.id() << " saved into '" << fileName << ".*'";
+    } // for views
+
+    // nothing may keep working on this event after it is released
+    RawDataDrawer::CancelBackgroundWork();
+    evdb::EventHolder::Instance()->SetEvent(nullptr);
+    ++fNRendered;
+  }
+
+  //----------------------------------------------------
+  void EVDBatch::endJob()
+  {
+    // pads first, since they live inside the canvases
+    for (View_t& view: fViews) view.ClearPads();
+    fViews.clear();
+
+    // the last event is reported here, since no other event follows it
+    DrawingProfiler::Instance().Close();
+
+    mf::LogInfo("EVDBatch")
+      << "Rendered " << fNRendered << " events in " << fViewNames.size()
+      << " views.";
+  }
+
+  //----------------------------------------------------
+  bool EVDBatch::isSelected(art::Event const& evt) const
+  {
+    if (fEvents.empty()) return true;
+    EventID_t const id{ evt.run(), evt.subRun(), evt.event() };
+    return std::find(fEvents.begin(), fEvents.end(), id) != fEvents.end();
+  }
+
+  //----------------------------------------------------
+  EVDBatch::View_t EVDBatch::makeView(std::string const& name) const
+  {
+    View_t view;
+    view.name = name;
+    view.canvas = std::make_unique<TCanvas>(("EVDBatch" + name).c_str(),
+      name.c_str(), fCanvasWidth, fCanvasHeight);
+    view.canvas->cd();
+
+    if (name == "WirePlanes") {
+      geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
+
+      // same layout as TWQProjectionView, without the charge pads
+      view.header = std::make_unique<HeaderPad>
+        ("fHeaderPad", "Header", 0.0, 0.0, 0.15, 0.13, "");
+      unsigned int const nPlanes = geom.Nplanes();
+      for (unsigned int i = 0; i < nPlanes; ++i) {
+        double const y1 = 0.17 +   (i)*(1.0-0.171)/(1.*nPlanes);
+        double const y2 = 0.17 + (i+1)*(1.0-0.171)/(1.*nPlanes);
+
+        view.canvas->cd();
+        view.planes.push_back(std::make_unique<TWireProjPad>(
+          Form("fWireProjP%u", i), Form("Plane%u", i), 0.0, y1, 1.0, y2, i
+          ));
+      } // for planes
+    }
+    else if (name == "Ortho3D") {
+      // same layout as Ortho3DView
+      std::array<std::pair<evd::OrthoProj_t, std::string>, 2U> const projs
+        {{ { kXZ, "XZ" }, { kYZ, "YZ" } }};
+      unsigned int const nPads = projs.size();
+      for (unsigned int iPad = 0; iPad < nPads; ++iPad) {
+        double const ylo = double(nPads - iPad - 1) / double(nPads);
+        double const yhi = double(nPads - iPad) / double(nPads);
+
+        view.canvas->cd();
+        view.orthoPads.push_back(std::make_unique<Ortho3DPad>(
+          ("Ortho3DPad" + projs[iPad].second).c_str(),
+          (projs[iPad].second + " View").c_str(),
+          projs[iPad].first, 0.0, ylo, 1.0, yhi
+          ));
+      } // for projections
+    }
+    else if (name == "Display3D") {
+      view.display3D = std::make_unique<Display3DPad>
+        ("fDisplay3DPad", "3D Display", 0.0, 0.0, 1.0, 1.0, "");
+    }
+    else {
+      throw art::Exception(art::errors::Configuration)
+        << "EVDBatch: unknown view '" << name
+        << "' (supported: 'WirePlanes', 'Ortho3D', 'Display3D').\n";
+    }
+
+    return view;
+  }
+
+  //----------------------------------------------------
+  void EVDBatch::View_t::Draw()
+  {
+    if (header) header->Draw();
+
+    // the data of the wire planes is prepared in parallel
+    if (!planes.empty()) {
+      std::vector<TWireProjPad*> toPrepare;
+      for (auto const& plane: planes) toPrepare.push_back(plane.get());
+      TWireProjPad::PrepareDraw(toPrepare);
+    }
+    for (auto const& plane: planes) {
+      plane->Draw();
+      plane->Pad()->Update();
+    }
+
+    for (auto const& pad: orthoPads) pad->Draw();
+
+    if (display3D) display3D->Draw();
+  }
+
+  //----------------------------------------------------
+  void EVDBatch::View_t::ClearPads()
+  {
+    header.reset();
+    planes.clear();
+    orthoPads.clear();
+    display3D.reset();
+  }
+
+  //----------------------------------------------------
+  std::string EVDBatch::outputFileName
+    (std::string const& viewName, art::Event const& evt) const
+  {
+    std::string fileName;
+    for (auto iChar = fOutputPattern.cbegin(); iChar != fOutputPattern.cend();
+      ++iChar
+    ) {
+      if ((*iChar != '%') || (std::next(iChar) == fOutputPattern.cend())) {
+        fileName += *iChar;
+        continue;
+      }
+      switch (*++iChar) {
+        case 'v': fileName += viewName;                        break;
+        case 'r': fileName += std::to_string(evt.run());       break;
+        case 's': fileName += std::to_string(evt.subRun());    break;
+        case 'e': fileName += std::to_string(evt.event());     break;
+        case '%': fileName += '%';                             break;
+        default:  fileName += '%'; fileName += *iChar;         break;
+      } // switch
+    } // for
+    return fileName;
+  }
+
+}//namespace
+
+namespace evd {
+
+  DEFINE_ART_MODULE(EVDBatch)
+
+} // namespace evd
@@ -14,6 +14,7 @@
 #include "lareventdisplay/EventDisplay/Display3DView.h"
 #include "lareventdisplay/EventDisplay/Ortho3DView.h"
 #include "lareventdisplay/EventDisplay/CalorView.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 
 // Framework includes
 #include "art/Framework/Principal/fwd.h"
@@ -38,6 +39,7 @@ namespace evd{
 
      void analyze(art::Event const& evt);
      void beginJob();
+     void endJob();
 
   private:
 
@@ -142,6 +144,13 @@ namespace evd{
     evdb::DisplayWindow::OpenWindow(0);
   }
 
+  //----------------------------------------------------
+  void EVD::endJob()
+  {
+    // the last event displayed is reported here, since no other follows it
+    evd::DrawingProfiler::Instance().Close();
+  }
+
   //----------------------------------------------------
   void EVD::analyze(const art::Event& /*evt*/)
   {
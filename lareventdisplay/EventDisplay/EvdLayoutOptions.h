@@ -38,6 +38,14 @@ namespace evd {
       bool        fDrawAxes;                   ///< true to draw coordinate axes
       bool        fDrawBadChannels;            ///< true to draw bad channels
 
+      bool         fProgressiveDrawing;        ///< true to draw the planes coarsely first, then refine them
+      unsigned int fCoarseDrawingScale;        ///< pixels per cell side in the first, coarse drawing
+      double       fDrawingTimeBudget;         ///< time for each step of refinement [ms]
+
+      bool        fProfileDrawing;             ///< true to time each drawer, event by event
+      std::string fDrawingTraceFile;           ///< file to write the drawer timings into (Chrome trace format)
+      std::string fDrawingProfileFile;         ///< ROOT file to write the drawer statistics into
+
       std::string fDisplayName;                ///< Name to apply to 2D display
   };
 }//namespace
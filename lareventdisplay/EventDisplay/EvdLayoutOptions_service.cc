@@ -33,6 +33,14 @@ namespace evd {
       fDrawAxes                = pset.get<     bool    >("DrawAxes",        true);
       fDrawBadChannels         = pset.get<     bool    >("DrawBadChannels", true);
 
+      fProgressiveDrawing      = pset.get<     bool    >("ProgressiveDrawing", false);
+      fCoarseDrawingScale      = pset.get<unsigned int >("CoarseDrawingScale", 8);
+      fDrawingTimeBudget       = pset.get<    double   >("DrawingTimeBudget",  100.);
+
+      fProfileDrawing          = pset.get<     bool    >("ProfileDrawing",   false);
+      fDrawingTraceFile        = pset.get< std::string >("DrawingTraceFile", "");
+      fDrawingProfileFile      = pset.get< std::string >("DrawingProfileFile", "");
+
       fDisplayName             = pset.get< std::string >("DisplayName",     "LArSoft");
   }
 }
@@ -0,0 +1,228 @@
+/// \file    HitGrid.cxx
+/// \brief   Spatial index of the hits of each plane, for interactive hit picking
+
+#include "lareventdisplay/EventDisplay/HitGrid.h"
+
+#include <algorithm> // std::minmax_element(), std::sort(), ...
+#include <cmath> // std::sqrt(), std::floor(), std::ceil(), ...
+#include <cstddef> // std::ptrdiff_t
+#include <utility> // std::move()
+
+#include "lardata/Utilities/PxHitConverter.h"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace {
+
+  /// Average number of hits in a cell of the grid
+  constexpr double HitsPerCell = 2.;
+
+  /// Smallest extent of the grid on each side [cm]
+  constexpr double MinSpan = 1e-3;
+
+} // local namespace
+
+
+namespace evd {
+
+  //......................................................................
+  HitGrid::HitGrid
+    (std::vector<art::Ptr<recob::Hit>> hits, std::vector<util::PxHit> pxHits)
+    : fHits(std::move(hits))
+    , fPxHits(std::move(pxHits))
+  {
+    if (fPxHits.empty()) return;
+
+    auto const byW = [](util::PxHit const& a, util::PxHit const& b)
+      { return a.w < b.w; };
+    auto const byT = [](util::PxHit const& a, util::PxHit const& b)
+      { return a.t < b.t; };
+    auto const rangeW = std::minmax_element(fPxHits.begin(), fPxHits.end(), byW);
+    auto const rangeT = std::minmax_element(fPxHits.begin(), fPxHits.end(), byT);
+    fMinW = rangeW.first->w;
+    fMinT = rangeT.first->t;
+
+    // cells about as wide as tall, with a few hits each on average
+    double const spanW = std::max(rangeW.second->w - fMinW, MinSpan);
+    double const spanT = std::max(rangeT.second->t - fMinT, MinSpan);
+    double const nCells = std::max(1.0, fPxHits.size() / HitsPerCell);
+    double const cellSide = std::sqrt(spanW * spanT / nCells);
+    double const maxCells = fPxHits.size();
+    fNCellsW = std::max(1.0, std::min(std::ceil(spanW / cellSide), maxCells));
+    fNCellsT = std::max(1.0, std::min(std::ceil(spanT / cellSide), maxCells));
+    fCellW = spanW / fNCellsW;
+    fCellT = spanT / fNCellsT;
+
+    // a counting sort by cell, which keeps the order of the hits in each cell
+    std::vector<std::size_t> cells(fPxHits.size());
+    fCellFirst.assign(fNCellsW * fNCellsT + 1, 0);
+    for (std::size_t i = 0; i < fPxHits.size(); ++i) {
+      cells[i] = Cell(CellW(fPxHits[i].w), CellT(fPxHits[i].t));
+      ++fCellFirst[cells[i] + 1];
+    } // for
+    for (std::size_t i = 1; i < fCellFirst.size(); ++i)
+      fCellFirst[i] += fCellFirst[i - 1];
+
+    fCellHits.resize(fPxHits.size());
+    std::vector<std::size_t> next(fCellFirst.begin(), fCellFirst.end() - 1);
+    for (std::size_t i = 0; i < fPxHits.size(); ++i)
+      fCellHits[next[cells[i]]++] = i;
+
+  } // HitGrid::HitGrid()
+
+  //......................................................................
+  std::size_t HitGrid::ClosestHit(double w, double t) const
+  {
+    if (empty()) return NoHit;
+
+    std::ptrdiff_t const iW0 = CellW(w), iT0 = CellT(t);
+    std::ptrdiff_t const nW = fNCellsW, nT = fNCellsT;
+    double const minCellSide = std::min(fCellW, fCellT);
+
+    std::size_t closest = NoHit;
+    double minDist2 = std::numeric_limits<double>::max();
+
+    auto const visitCell = [&](std::ptrdiff_t iW, std::ptrdiff_t iT)
+      {
+        if ((iW < 0) || (iW >= nW) || (iT < 0) || (iT >= nT)) return;
+        std::size_t const cell = Cell(iW, iT);
+        for (std::size_t i = fCellFirst[cell]; i < fCellFirst[cell + 1]; ++i) {
+          std::size_t const index = fCellHits[i];
+          double const dW = fPxHits[index].w - w, dT = fPxHits[index].t - t;
+          double const dist2 = dW * dW + dT * dT;
+          // on a tie, the first hit in the collection wins
+          if ((dist2 < minDist2) || ((dist2 == minDist2) && (index < closest))) {
+            minDist2 = dist2;
+            closest = index;
+          }
+        } // for
+      };
+
+    // visit rings of cells around the point, until they can't be closer
+    std::ptrdiff_t const maxRing = std::max(nW, nT);
+    for (std::ptrdiff_t ring = 0; ring <= maxRing; ++ring) {
+      if (ring > 0) {
+        double const ringDist = (ring - 1) * minCellSide;
+        if (ringDist * ringDist > minDist2) break;
+      }
+      for (std::ptrdiff_t iW = iW0 - ring; iW <= iW0 + ring; ++iW) {
+        if ((iW == iW0 - ring) || (iW == iW0 + ring)) {
+          for (std::ptrdiff_t iT = iT0 - ring; iT <= iT0 + ring; ++iT)
+            visitCell(iW, iT);
+        }
+        else {
+          visitCell(iW, iT0 - ring);
+          visitCell(iW, iT0 + ring);
+        }
+      } // for wire cells
+    } // for rings
+
+    return closest;
+  } // HitGrid::ClosestHit()
+
+  //......................................................................
+  std::vector<std::size_t> HitGrid::HitsInBox(
+    util::PxPoint const& center, double slope,
+    double halfLength, double halfWidth
+    ) const
+  {
+    std::vector<std::size_t> selected;
+    if (empty()) return selected;
+
+    // direction of the line
+    double const norm = std::hypot(1., slope);
+    double const dirW = 1. / norm, dirT = slope / norm;
+
+    // the cells covering the box
+    double const extentW = std::abs(dirW) * halfLength + std::abs(dirT) * halfWidth;
+    double const extentT = std::abs(dirT) * halfLength + std::abs(dirW) * halfWidth;
+    std::size_t const firstW = CellW(center.w - extentW);
+    std::size_t const lastW = CellW(center.w + extentW);
+    std::size_t const firstT = CellT(center.t - extentT);
+    std::size_t const lastT = CellT(center.t + extentT);
+
+    for (std::size_t iW = firstW; iW <= lastW; ++iW) {
+      for (std::size_t iT = firstT; iT <= lastT; ++iT) {
+        std::size_t const cell = Cell(iW, iT);
+        for (std::size_t i = fCellFirst[cell]; i < fCellFirst[cell + 1]; ++i) {
+          std::size_t const index = fCellHits[i];
+          double const dW = fPxHits[index].w - center.w;
+          double const dT = fPxHits[index].t - center.t;
+          double const along = dW * dirW + dT * dirT;
+          double const across = dT * dirW - dW * dirT;
+          if ((std::abs(across) < halfWidth) && (std::abs(along) < halfLength))
+            selected.push_back(index);
+        } // for hits
+      } // for time cells
+    } // for wire cells
+
+    std::sort(selected.begin(), selected.end());
+    return selected;
+  } // HitGrid::HitsInBox()
+
+  //......................................................................
+  std::size_t HitGrid::CellW(double w) const
+  {
+    double const cell = std::floor((w - fMinW) / fCellW);
+    if (cell <= 0.) return 0;
+    return (cell >= fNCellsW)? fNCellsW - 1: std::size_t(cell);
+  } // HitGrid::CellW()
+
+  //......................................................................
+  std::size_t HitGrid::CellT(double t) const
+  {
+    double const cell = std::floor((t - fMinT) / fCellT);
+    if (cell <= 0.) return 0;
+    return (cell >= fNCellsT)? fNCellsT - 1: std::size_t(cell);
+  } // HitGrid::CellT()
+
+
+  //......................................................................
+  HitGrid const& HitGridIndex::Plane
+    (art::Event const& evt, art::InputTag const& label, unsigned int plane)
+  {
+    static HitGrid const NoHits;
+
+    if (fEvent.update(util::EventChangeTracker_t(evt))) fCollections.clear();
+
+    art::Handle<std::vector<recob::Hit>> handle;
+    if (!evt.getByLabel(label, handle)) return NoHits;
+    std::vector<recob::Hit> const& hits = *handle;
+
+    // the same event may have been read anew, with its data somewhere else
+    CollectionGrids_t& collection = fCollections[label.encode()];
+    if (collection.hits != &hits) {
+      collection = CollectionGrids_t();
+
+      std::map<unsigned int, std::vector<art::Ptr<recob::Hit>>> planeHits;
+      for (std::size_t i = 0; i < hits.size(); ++i)
+        planeHits[hits[i].WireID().Plane].emplace_back(handle, i);
+
+      util::PxHitConverter converter;
+      for (auto& planeInfo: planeHits) {
+        std::vector<util::PxHit> pxHits;
+        converter.GeneratePxHit(planeInfo.second, pxHits);
+        collection.planes.emplace(planeInfo.first,
+          HitGrid(std::move(planeInfo.second), std::move(pxHits)));
+      } // for
+
+      collection.hits = &hits;
+
+      MF_LOG_DEBUG("HitGridIndex") << "Binned " << hits.size() << " hits from '"
+        << label.encode() << "' on " << collection.planes.size() << " planes";
+    }
+
+    auto const iPlane = collection.planes.find(plane);
+    return (iPlane == collection.planes.end())? NoHits: iPlane->second;
+  } // HitGridIndex::Plane()
+
+  //......................................................................
+  void HitGridIndex::Clear()
+  {
+    fEvent.clear();
+    fCollections.clear();
+  } // HitGridIndex::Clear()
+
+} // namespace evd
@@ -0,0 +1,138 @@
+/// \file    HitGrid.h
+/// \brief   Spatial index of the hits of each plane, for interactive hit picking
+#ifndef EVD_HITGRID_H
+#define EVD_HITGRID_H
+
+#include <cstddef> // std::size_t
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "lardata/Utilities/PxUtils.h" // util::PxHit, util::PxPoint
+#include "lardataobj/RecoBase/Hit.h"
+
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Utilities/InputTag.h"
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+
+namespace art { class Event; }
+
+namespace evd {
+
+  /**
+   * @brief Hits of a plane, binned in a uniform grid on the wire/time plane
+   *
+   * Hit positions are in centimetres on both axes, as converted by
+   * `util::PxHitConverter`. The grid is sized to hold a few hits per cell,
+   * and it serves the two queries of interactive hit picking: the hit closest
+   * to a point, and the hits in a box oriented along a line. Both queries only
+   * visit the cells around the region of interest, instead of all the hits of
+   * the plane.
+   *
+   * Hits are identified by their position in `Hits()` (and `PxHits()`), which
+   * follows the order of the hit collection.
+   */
+  class HitGrid {
+  public:
+
+    /// Value returned when there is no hit
+    static constexpr std::size_t NoHit = std::numeric_limits<std::size_t>::max();
+
+    /// Creates an empty grid
+    HitGrid() = default;
+
+    /// Bins the hits; `pxHits` are the positions of `hits`, in the same order
+    HitGrid(std::vector<art::Ptr<recob::Hit>> hits, std::vector<util::PxHit> pxHits);
+
+    /// Returns the hits in the grid
+    std::vector<art::Ptr<recob::Hit>> const& Hits() const { return fHits; }
+
+    /// Returns the positions of the hits in the grid
+    std::vector<util::PxHit> const& PxHits() const { return fPxHits; }
+
+    /// Returns whether there is no hit in the grid
+    bool empty() const { return fHits.empty(); }
+
+    /// Returns the position of the hit closest to the point (`NoHit` if none)
+    std::size_t ClosestHit(double w, double t) const;
+
+    /**
+     * @brief Returns the hits in a box oriented along a line
+     * @param center center of the box
+     * @param slope slope of the line (time over wire)
+     * @param halfLength half the size of the box along the line
+     * @param halfWidth half the size of the box across the line
+     * @return the positions of the hits in the box, in increasing order
+     *
+     * The selection is the one of
+     * `util::GeometryUtilities::SelectLocalHitlistIndex()`, with `halfLength`
+     * as linear limit and `halfWidth` as orthogonal limit.
+     */
+    std::vector<std::size_t> HitsInBox(
+      util::PxPoint const& center, double slope,
+      double halfLength, double halfWidth
+      ) const;
+
+  private:
+
+    std::vector<art::Ptr<recob::Hit>> fHits; ///< the hits
+    std::vector<util::PxHit> fPxHits; ///< positions of the hits
+
+    double fMinW = 0., fMinT = 0.; ///< lower corner of the grid
+    double fCellW = 1., fCellT = 1.; ///< size of a cell
+    std::size_t fNCellsW = 0, fNCellsT = 0; ///< number of cells on each side
+
+    std::vector<std::size_t> fCellFirst; ///< first entry in `fCellHits`, by cell
+    std::vector<std::size_t> fCellHits; ///< positions of the hits, by cell
+
+    /// Returns the wire cell of the coordinate (clamped into the grid)
+    std::size_t CellW(double w) const;
+
+    /// Returns the time cell of the coordinate (clamped into the grid)
+    std::size_t CellT(double t) const;
+
+    /// Returns the number of the cell
+    std::size_t Cell(std::size_t iW, std::size_t iT) const
+      { return iW * fNCellsT + iT; }
+
+  }; // class HitGrid
+
+
+  /**
+   * @brief Hit grids of each plane, for the current event
+   *
+   * A hit collection is binned, all planes at once, the first time it is
+   * asked for in an event, and it is kept until a different event is asked
+   * for. Planes are identified by their number alone, as the hit selection
+   * does.
+   */
+  class HitGridIndex {
+  public:
+
+    /// Returns the grid of the hits of the collection on the plane
+    HitGrid const& Plane
+      (art::Event const& evt, art::InputTag const& label, unsigned int plane);
+
+    /// Forgets all the grids
+    void Clear();
+
+  private:
+
+    /// Grids of a single hit collection
+    struct CollectionGrids_t {
+      std::vector<recob::Hit> const* hits = nullptr; ///< the data product
+      std::map<unsigned int, HitGrid> planes; ///< grids by plane number
+    }; // CollectionGrids_t
+
+    util::EventChangeTracker_t fEvent; ///< the event the grids refer to
+
+    /// Grids of the collections, by encoded input tag
+    std::map<std::string, CollectionGrids_t> fCollections;
+
+  }; // class HitGridIndex
+
+} // namespace evd
+
+#endif // EVD_HITGRID_H
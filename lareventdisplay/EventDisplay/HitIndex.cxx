@@ -0,0 +1,131 @@
+/// \file    HitIndex.cxx
+/// \brief   Per-event index of the reconstructed hits by plane and wire
+
+#include "lareventdisplay/EventDisplay/HitIndex.h"
+
+#include <algorithm> // std::sort(), std::lower_bound(), ...
+
+#include "lareventdisplay/EventDisplay/ChannelWireMap.h"
+
+#include "art/Framework/Principal/Event.h"
+#include "art/Framework/Principal/Handle.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace evd {
+
+  //......................................................................
+  std::vector<recob::Hit> const& HitIndex::Hits
+    (art::Event const& evt, art::InputTag const& label)
+  {
+    return *(Collection(evt, label).hits);
+  } // HitIndex::Hits()
+
+  //......................................................................
+  HitIndex::PlaneHits_t const& HitIndex::PlaneHits
+    (art::Event const& evt, art::InputTag const& label, geo::PlaneID const& pid)
+  {
+    return Plane(evt, label, pid).hits;
+  } // HitIndex::PlaneHits()
+
+  //......................................................................
+  HitIndex::HitRange_t HitIndex::WireHits
+    (art::Event const& evt, art::InputTag const& label, geo::WireID const& wid)
+  {
+    return WireRangeHits(evt, label, wid.planeID(), wid.Wire, wid.Wire);
+  } // HitIndex::WireHits()
+
+  //......................................................................
+  HitIndex::HitRange_t HitIndex::WireRangeHits(
+    art::Event const& evt, art::InputTag const& label, geo::PlaneID const& pid,
+    geo::WireID::WireID_t firstWire, geo::WireID::WireID_t lastWire
+    )
+  {
+    PlaneIndex_t const& plane = Plane(evt, label, pid);
+    auto const wBegin = plane.wires.cbegin();
+    auto const iFirst
+      = std::lower_bound(wBegin, plane.wires.cend(), firstWire);
+    auto const iLast
+      = std::upper_bound(iFirst, plane.wires.cend(), lastWire);
+    return {
+      plane.hits.cbegin() + (iFirst - wBegin),
+      plane.hits.cbegin() + (iLast - wBegin)
+      };
+  } // HitIndex::WireRangeHits()
+
+  //......................................................................
+  std::size_t HitIndex::HitPosition
+    (art::Event const& evt, art::InputTag const& label, recob::Hit const& hit)
+  {
+    return &hit - Collection(evt, label).hits->data();
+  } // HitIndex::HitPosition()
+
+  //......................................................................
+  void HitIndex::Clear()
+  {
+    fEvent.clear();
+    fCollections.clear();
+  } // HitIndex::Clear()
+
+  //......................................................................
+  HitIndex::CollectionIndex_t const& HitIndex::Collection
+    (art::Event const& evt, art::InputTag const& label)
+  {
+    if (fEvent.update(util::EventChangeTracker_t(evt))) fCollections.clear();
+
+    // throws if the collection is not available, and we'll try again next time
+    std::vector<recob::Hit> const& hits
+      = *(evt.getValidHandle<std::vector<recob::Hit>>(label));
+
+    // the same event may have been read anew, with its data somewhere else
+    CollectionIndex_t& collection = fCollections[label.encode()];
+    if (collection.hits == &hits) return collection;
+    collection = CollectionIndex_t();
+
+    // each hit is listed on all the wires of its channel
+    ChannelWireMap const& channelWires = ChannelWireMap::Instance();
+    std::map<geo::PlaneID, std::vector<std::pair<geo::WireID::WireID_t, recob::Hit const*>>>
+      planeHits;
+    for (recob::Hit const& hit: hits) {
+      for (geo::WireID const& wid: channelWires.Wires(hit.Channel()))
+        planeHits[wid.planeID()].emplace_back(wid.Wire, &hit);
+    } // for
+
+    for (auto& planeInfo: planeHits) {
+      auto& wireHits = planeInfo.second;
+      std::sort(wireHits.begin(), wireHits.end(),
+        [](auto const& a, auto const& b)
+          {
+            return (a.first != b.first)
+              ? (a.first < b.first): (a.second->PeakTime() < b.second->PeakTime());
+          }
+        );
+
+      PlaneIndex_t& plane = collection.planes[planeInfo.first];
+      plane.wires.reserve(wireHits.size());
+      plane.hits.reserve(wireHits.size());
+      for (auto const& wireHit: wireHits) {
+        plane.wires.push_back(wireHit.first);
+        plane.hits.push_back(wireHit.second);
+      } // for
+    } // for planes
+
+    collection.hits = &hits;
+
+    MF_LOG_DEBUG("HitIndex") << "Indexed " << hits.size() << " hits from '"
+      << label.encode() << "' on " << collection.planes.size() << " planes";
+
+    return collection;
+  } // HitIndex::Collection()
+
+  //......................................................................
+  HitIndex::PlaneIndex_t const& HitIndex::Plane
+    (art::Event const& evt, art::InputTag const& label, geo::PlaneID const& pid)
+  {
+    static PlaneIndex_t const NoHits;
+
+    CollectionIndex_t const& collection = Collection(evt, label);
+    auto const iPlane = collection.planes.find(pid);
+    return (iPlane == collection.planes.end())? NoHits: iPlane->second;
+  } // HitIndex::Plane()
+
+} // namespace evd
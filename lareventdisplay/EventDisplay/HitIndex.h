@@ -0,0 +1,102 @@
+/// \file    HitIndex.h
+/// \brief   Per-event index of the reconstructed hits by plane and wire
+#ifndef EVD_HITINDEX_H
+#define EVD_HITINDEX_H
+
+#include <cstddef> // std::size_t
+#include <map>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::PlaneID
+#include "lardataobj/RecoBase/Hit.h"
+
+#include "canvas/Utilities/InputTag.h"
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+
+namespace art { class Event; }
+
+namespace evd {
+
+  /**
+   * @brief Index of the hits of an event, by plane and wire
+   *
+   * Hits are associated to wires by their channel, so that on detectors
+   * where a channel is read by more than one wire each hit is listed on all
+   * of them. Resolving channels into wires is the expensive part: each hit
+   * collection is indexed in a single pass, the first time it is asked for
+   * in an event, and the index is kept until a different event is asked for.
+   *
+   * On each plane, hits are sorted by wire and then by peak time.
+   * Pointers and positions refer to the data product, which art keeps
+   * available as long as the event is.
+   */
+  class HitIndex {
+  public:
+
+    /// Hits on a plane
+    using PlaneHits_t = std::vector<recob::Hit const*>;
+
+    /// Range of hits, as iterators
+    using HitRange_t = std::pair
+      <PlaneHits_t::const_iterator, PlaneHits_t::const_iterator>;
+
+    /// Returns all the hits of the collection, in their original order
+    std::vector<recob::Hit> const& Hits
+      (art::Event const& evt, art::InputTag const& label);
+
+    /// Returns the hits on the plane, sorted by wire and peak time
+    PlaneHits_t const& PlaneHits
+      (art::Event const& evt, art::InputTag const& label, geo::PlaneID const& pid);
+
+    /// Returns the hits on the wire, sorted by peak time
+    HitRange_t WireHits
+      (art::Event const& evt, art::InputTag const& label, geo::WireID const& wid);
+
+    /// Returns the hits on wires from `firstWire` to `lastWire` (included)
+    HitRange_t WireRangeHits(
+      art::Event const& evt, art::InputTag const& label, geo::PlaneID const& pid,
+      geo::WireID::WireID_t firstWire, geo::WireID::WireID_t lastWire
+      );
+
+    /// Returns the position of the hit in its collection
+    std::size_t HitPosition
+      (art::Event const& evt, art::InputTag const& label, recob::Hit const& hit);
+
+    /// Forgets all the hits
+    void Clear();
+
+  private:
+
+    /// Hits on a plane with the wire they are listed on, in the same order
+    struct PlaneIndex_t {
+      std::vector<geo::WireID::WireID_t> wires; ///< wire of each hit
+      PlaneHits_t hits; ///< the hits
+    }; // PlaneIndex_t
+
+    /// Index of a single hit collection
+    struct CollectionIndex_t {
+      std::vector<recob::Hit> const* hits = nullptr; ///< the data product
+      std::map<geo::PlaneID, PlaneIndex_t> planes; ///< hits by plane
+    }; // CollectionIndex_t
+
+    util::EventChangeTracker_t fEvent; ///< the event the index refers to
+
+    /// Indices of the collections, by encoded input tag
+    std::map<std::string, CollectionIndex_t> fCollections;
+
+    /// Returns the index of the collection, building it if needed
+    CollectionIndex_t const& Collection
+      (art::Event const& evt, art::InputTag const& label);
+
+    /// Returns the index of the plane (empty if no hit is on it)
+    PlaneIndex_t const& Plane
+      (art::Event const& evt, art::InputTag const& label, geo::PlaneID const& pid);
+
+  }; // class HitIndex
+
+} // namespace evd
+
+#endif // EVD_HITINDEX_H
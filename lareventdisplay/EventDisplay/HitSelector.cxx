@@ -4,7 +4,6 @@
 /// \author ellen.klein@yale.edu
 ////////////////////////////////////////////////
 
-
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Framework/Principal/Event.h"
 #include "art/Framework/Principal/Handle.h"
@@ -13,8 +12,8 @@
 #include "larcore/Geometry/Geometry.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/HitSelector.h"
+#include "lareventdisplay/EventDisplay/HitGrid.h"
 #include "lardata/Utilities/GeometryUtilities.h"
-#include "lardata/Utilities/PxHitConverter.h"
 #include "lareventdisplay/EventDisplay/InfoTransfer.h"
 #include "lardataobj/RecoBase/Seed.h"
 #include "TMath.h"
@@ -110,7 +109,6 @@ namespace evd{
     //std::vector < recob::Hit> hits_to_point; //needed to convert art::Ptr<recob:: Hit> to Hit* to pass to Hit2D
    // std::vector< const recob::Hit*> hits_to_draw; //draw selected hits in a different color
 
-    art::Handle< std::vector<recob::Hit> > HitListHandle;
     //  recob::Hit * startHit;
     //  recob::Hit * endHit;
     //preprocess event - load up all the hits with std::vector, as in BackTracker
@@ -138,67 +136,42 @@ namespace evd{
      for (size_t imod = 0; imod < recoOpt->fHitLabels.size(); ++imod) {
          art::InputTag const which = recoOpt->fHitLabels[imod];
 
-     std::vector<art::Ptr<recob::Hit>> hitlist;
-     hitlist.clear();
-     evt.getByLabel(which,HitListHandle);
-
-    for(unsigned int ii = 0; ii < HitListHandle->size(); ++ii){
-       art::Ptr<recob::Hit> hit(HitListHandle, ii);
-       if(hit->WireID().Plane==plane)
-	  hitlist.push_back(hit);
-      }
-
-
-    // Select Local Hit List
-     util::PxHitConverter PxC;
-     std::vector <util::PxHit> pxhitlist;
-     PxC.GeneratePxHit(hitlist,pxhitlist);
-     std::vector< unsigned int > pxhitlist_local_index;
-     std::vector< util::PxHit > pxhitlist_local;
-     pxhitlist_local.clear();
+     // Select Local Hit List
+     HitGrid const& grid = fHitGrids.Plane(evt, which, plane);
+     if (grid.empty()) continue;
 
      util::PxPoint startHit;
-     startHit.plane=pxhitlist.at(0).plane;
+     startHit.plane=plane;
      startHit.w=(x+x1)/2;
      startHit.t=(y+y1)/2;
 
 
-//      double orttemp=TMath::Sqrt((y1-y)*(y1-y)*gser.TimeToCm()*gser.TimeToCm() + (x1-x)*(x1-x)*gser.WireToCm()*gser.WireToCm())/2;
       double orttemp=TMath::Sqrt((y1-y)*(y1-y) + (x1-x)*(x1-x))/2;
 
 
-     gser.SelectLocalHitlistIndex(pxhitlist, pxhitlist_local_index, startHit,
-			     orttemp,
-			     distance, lslope);
+     std::vector< std::size_t > pxhitlist_local_index
+       = grid.HitsInBox(startHit, lslope, orttemp, distance);
+     if (pxhitlist_local_index.empty()) continue;
 
-
-     for(unsigned int idx=0;idx<pxhitlist_local_index.size();idx++)
+     // the selected hit closest to the selection point
+     std::size_t closest_index = pxhitlist_local_index.front();
+     double closest_dist2 = std::numeric_limits<double>::max();
+     for(std::size_t idx: pxhitlist_local_index)
        {
-        hits_to_save.push_back(hitlist.at(pxhitlist_local_index.at(idx)));
-	pxhitlist_local.push_back(pxhitlist.at(pxhitlist_local_index.at(idx)));
-       }
-
+        hits_to_save.push_back(grid.Hits()[idx]);
 
-   /*  gser.SelectLocalHitlist( hitlist,
-			 hits_to_save,
-			   (x+x1)/2,
-			   (y+y1)/2,
-			   TMath::Sqrt((y1-y)*(y1-y)*gser.TimeToCm()*gser.TimeToCm() + (x1-x)*(x1-x)*gser.WireToCm()*gser.WireToCm())/2,
-			   distance,
-			   lslope);*/
-    //const_cast<recob::Hit *> (nearHit.get())
+        util::PxHit const& pxhit = grid.PxHits()[idx];
+        double const dist2 = (pxhit.w - x)*(pxhit.w - x) + (pxhit.t - y)*(pxhit.t - y);
+        if (dist2 < closest_dist2) { closest_dist2 = dist2; closest_index = idx; }
+       }
 
-     recob::Hit * hit=  const_cast<recob::Hit *> ((hits_to_save[gser.FindClosestHitIndex(pxhitlist_local,x,y)]).get());
-     //gser.FindClosestHit(hits_to_save,
-	//		      x, y);
+     recob::Hit const* hit = grid.Hits()[closest_index].get();
 
        starthitout[plane][1] = hit->PeakTime() ;
        starthitout[plane][0] = hit->WireID().Wire;
 
 //        // this obviously not correct, the fact that x,y are used for both start and end point, A.S. -> to debug
-       recob::Hit * endhit= const_cast<recob::Hit *> ((hits_to_save[gser.FindClosestHitIndex(pxhitlist_local,x,y)]).get());
-       //FindClosestHit(hits_to_save,
-	//		      x, y);
+       recob::Hit const* endhit = grid.Hits()[closest_index].get();
 
         endhitout[plane][1] = endhit->PeakTime() ;
         endhitout[plane][0] = endhit->WireID().Wire;
@@ -235,34 +208,17 @@ namespace evd{
     util::GeometryUtilities  gser;
 
 
-    //get hits from info transfer, see if our selected hit is in it
-    std::vector < art::Ptr<recob::Hit> > hits_saved;
-    std::vector < art::Ptr<recob::Hit> > hitlist;
    // std::vector < art::Ptr < recob::Hit> > hits_to_save;
-     hitlist.clear();
 
      double x = xin*gser.WireToCm();
      double y = yin*gser.TimeToCm();
 
-    art::Handle< std::vector<recob::Hit> > HitListHandle;
-
-    //preprocess event - load up all the hits with std::vector, as in BackTracker
     for (size_t imod = 0; imod < recoOpt->fHitLabels.size(); ++imod) {
         art::InputTag const which = recoOpt->fHitLabels[imod];
-      evt.getByLabel(which,HitListHandle);
-
-     for(unsigned int ii = 0; ii < HitListHandle->size(); ++ii){
-       art::Ptr<recob::Hit> hit(HitListHandle, ii);
-        if(hit->WireID().Plane==plane)
-	  hitlist.push_back(hit);
-      }
-
-     util::PxHitConverter PxC;
-     std::vector <util::PxHit> pxhitlist;
-     PxC.GeneratePxHit(hitlist,pxhitlist);
+      HitGrid const& grid = fHitGrids.Plane(evt, which, plane);
 
 //       art::Ptr < recob::Hit > selected_hit= hitlist[gser.FindClosestHitIndex(pxhitlist,x,y)];
-      unsigned int hitindex=gser.FindClosestHitIndex(pxhitlist,x,y);
+      std::size_t hitindex=grid.ClosestHit(x,y);
       //FindClosestHitPtr(hitlist, x, y);
 
       // find selected hit in evD
@@ -282,31 +238,23 @@ namespace evd{
     //}
       // for c2: unsigned int hitindex cannot be < 0
       //if(hitlist[hitindex].isNull() || (hitindex<0 || hitindex > hitlist.size())){
-      if(hitlist[hitindex].isNull() || ( hitindex > hitlist.size())){
+      if(hitindex == HitGrid::NoHit || grid.Hits()[hitindex].isNull()){
 	WriteMsg("no luck finding hit in evd, please try again");
 	break;
       }
 
 
+      art::Ptr<recob::Hit> const& selected_hit = grid.Hits()[hitindex];
+
       art::ServiceHandle<evd::InfoTransfer>   infot;
-      hits_saved=infot->GetSelectedHitList(plane);
-      int found_it=0;
-      for(unsigned int jj=0; jj<hits_saved.size(); ++jj){
-	if(hitlist[hitindex]->PeakTime() == hits_saved[jj]->PeakTime()){
-	  if(hitlist[hitindex]->Channel() == hits_saved[jj]->Channel()){
-	    found_it=1;
-	    hits_saved.erase(hits_saved.begin()+jj);
-	  }
-	}
-      }
 
-      //if didn't find it, add it
-      if(found_it!=1){
-	hits_saved.push_back(hitlist[hitindex]);
-      }
+      // a selected hit is unselected; hits are told apart by product and key
+      if(infot->IsSelectedHit(plane, selected_hit))
+	infot->DeselectHit(plane, selected_hit);
+      else
+	infot->SelectHit(plane, selected_hit);
 
-      //update the info transfer list
-      infot->SetHitList(plane,hits_saved);
+      //update the info transfer state
       infot->SetTestFlag(1);
       infot->SetEvtNumber(evt.id().event());
     }
@@ -11,6 +11,7 @@
 #include "canvas/Persistency/Common/Ptr.h"
 
 #include "lardataobj/RecoBase/Seed.h"
+#include "lareventdisplay/EventDisplay/HitGrid.h"
 
 namespace evdb {
   class View2D;
@@ -65,6 +66,8 @@ namespace evd {
       //int test;
       std::vector<recob::Seed> fSeedVector;
 
+      HitGridIndex fHitGrids; ///< hits of each plane binned for picking
+
       std::vector < std::vector <double > > starthitout;
       std::vector < std::vector <double > > endhitout;
 
@@ -12,12 +12,16 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <unordered_set>
+#include <utility>
 
 #include "fhiclcpp/ParameterSet.h"
 #include "art/Framework/Services/Registry/ActivityRegistry.h"
 #include "art/Framework/Services/Registry/ServiceHandle.h"
 #include "art/Framework/Services/Registry/ServiceMacros.h"
 #include "art/Persistency/Provenance/ScheduleContext.h"
+#include "canvas/Persistency/Common/Ptr.h"
+#include "canvas/Persistency/Provenance/ProductID.h"
 #include "nuevdb/EventDisplayBase/Reconfigurable.h"
 
 #include "lardataobj/RecoBase/Hit.h"
@@ -58,8 +62,16 @@ namespace evd {
     int GetEvtNumber() const { return fEvt; }
 
 
-    void SetHitList(unsigned int p,std::vector<art::Ptr < recob::Hit> > hits_to_save)
-    { fSelectedHitlist[p].clear(); fSelectedHitlist[p]=hits_to_save; }
+    void SetHitList(unsigned int p,std::vector<art::Ptr < recob::Hit> > hits_to_save);
+
+    /// Returns whether the hit is in the selection of the plane
+    bool IsSelectedHit(unsigned int plane, art::Ptr<recob::Hit> const& hit) const;
+
+    /// Adds the hit to the selection of the plane, unless already there
+    void SelectHit(unsigned int plane, art::Ptr<recob::Hit> const& hit);
+
+    /// Removes the hit from the selection of the plane, if there
+    void DeselectHit(unsigned int plane, art::Ptr<recob::Hit> const& hit);
 
     std::vector < art::Ptr < recob::Hit> > const& GetHitList(unsigned int plane) const
     { return fRefinedHitlist[plane];  }
@@ -71,6 +83,7 @@ namespace evd {
   {
   if (fSelectedHitlist.size()==0) {return; std::cout<<"no size"<<std::endl;}
   fSelectedHitlist[plane].clear();
+  fSelectedHitKeys[plane].clear();
   for(unsigned int i=0; i<fRefStartHit.size(); i++){
     fRefStartHit[i]=NULL;
     fRefEndHit[i]=NULL;
@@ -117,6 +130,22 @@ namespace evd {
 
   private:
 
+    /// A hit is identified by its data product and its position in it
+    using HitKey_t = std::pair<art::ProductID, std::size_t>;
+
+    struct HitKeyHash {
+      std::size_t operator()(HitKey_t const& hitKey) const
+        { return std::hash<std::size_t>()((std::size_t(hitKey.first.value()) << 32) ^ hitKey.second); }
+    };
+
+    using HitKeySet_t = std::unordered_set<HitKey_t, HitKeyHash>;
+
+    static HitKey_t MakeHitKey(art::Ptr<recob::Hit> const& hit)
+    { return { hit.id(), hit.key() }; }
+
+    /// Refreshes the keys of the selected hits of the plane from the hit list
+    void UpdateSelectedHitKeys(unsigned int plane);
+
     void FillStartEndHitCoords(unsigned int plane);
 
     int testflag;
@@ -124,8 +153,8 @@ namespace evd {
     int fRun;
     int fSubRun;
     std::vector < std::vector< art::Ptr < recob::Hit > > > fSelectedHitlist; ///< the list selected by the GUI (one for each plane)
+    std::vector < HitKeySet_t > fSelectedHitKeys; ///< keys of the hits in fSelectedHitlist (one set for each plane)
     std::vector < std::vector< art::Ptr < recob::Hit > > > fRefinedHitlist; ///< the refined hitlist after rebuild (one for each plane)
-    std::vector< art::Ptr < recob::Hit > > fFullHitlist;   ///< the full Hit list from the Hitfinder.
     std::string                            fHitModuleLabel;         ///< label for geant4 module
 
     std::vector < recob::Hit * >  fStartHit; ///< The Starthit
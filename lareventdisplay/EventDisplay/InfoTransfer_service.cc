@@ -20,11 +20,22 @@
 #include "lareventdisplay/EventDisplay/InfoTransfer.h"
 #include "nuevdb/EventDisplayBase/NavState.h"
 
+#include <algorithm>
+#include <functional>
+
 namespace{
   void WriteMsg(const char* fcn)
   {
     mf::LogWarning("InfoTransfer") << "InfoTransfer::" << fcn << " \n";
   }
+
+  // whether the hit is one of the hits in the collection
+  bool IsInCollection(recob::Hit const* hit, std::vector<recob::Hit> const& hits)
+  {
+    std::less<recob::Hit const*> const before;
+    return hit && !hits.empty()
+      && !before(hit, hits.data()) && before(hit, hits.data() + hits.size());
+  }
 }
 
 namespace evd {
@@ -44,6 +55,7 @@ namespace evd {
     unsigned int nplanes = geo->Nplanes();
 
     fSelectedHitlist.resize(nplanes);
+    fSelectedHitKeys.resize(nplanes);
     fStartHit.resize(nplanes);
     fRefStartHit.resize(nplanes);
     fEndHit.resize(nplanes);
@@ -74,9 +86,11 @@ namespace evd {
     //clear everything
     fRefinedHitlist.resize(nplanes);
     fSelectedHitlist.resize(nplanes);
+    fSelectedHitKeys.resize(nplanes);
     for (unsigned int i=0;i<nplanes;i++){
       fRefinedHitlist[i].clear();
       fSelectedHitlist[i].clear();
+      fSelectedHitKeys[i].clear();
     }
     fHitModuleLabel  = pset.get<std::string>("HitModuleLabel",  "ffthit");
   }
@@ -93,9 +107,11 @@ namespace evd {
       //unless we're reloading we want to clear all the selected and refined hits
       fRefinedHitlist.resize(nplanes);
       fSelectedHitlist.resize(nplanes);
+      fSelectedHitKeys.resize(nplanes);
       for(unsigned int j=0; j<nplanes;j++){
 	fRefinedHitlist[j].clear();
 	fSelectedHitlist[j].clear();
+	fSelectedHitKeys[j].clear();
 	starthitout[j].clear();
 	endhitout[j].clear();
 	starthitout[j].resize(2);
@@ -106,9 +122,8 @@ namespace evd {
 	refendhitout[j].resize(2);
       }
       //also clear start and end points
-      fRefStartHit.clear();
-      fRefEndHit.clear();
-      fFullHitlist.clear();
+      fRefStartHit.assign(nplanes, nullptr);
+      fRefEndHit.assign(nplanes, nullptr);
     }
     art::Handle< std::vector<recob::Hit> > hHandle;
 
@@ -131,7 +146,6 @@ namespace evd {
     }
 
 
-    fFullHitlist.clear();
     for(unsigned int i=0; i<fRefStartHit.size(); i++){
       fRefStartHit[i]=NULL;
       fRefEndHit[i]=NULL;
@@ -153,11 +167,6 @@ namespace evd {
 	endhitout[i].resize(2);
       }
 
-    for(size_t p = 0; p < hHandle->size(); ++p){
-      art::Ptr<recob::Hit> hit(hHandle, p);
-      fFullHitlist.push_back(hit);
-    }
-
     // fill the selected Hits into the fRefinedHitList from the fSelectedHitList
     char buf[200];
     for(unsigned int j=0; j<nplanes; j++){
@@ -165,34 +174,77 @@ namespace evd {
       WriteMsg(buf);
     }
 
-    for(size_t t = 0; t < fFullHitlist.size(); ++t){
-      for(unsigned int ip=0;ip<nplanes;ip++)	{
-	for(size_t xx = 0; xx < fSelectedHitlist[ip].size(); ++xx){
-	  if(fFullHitlist[t]==fSelectedHitlist[ip][xx]) {
-	    fRefinedHitlist[ip].push_back(fFullHitlist[t]);
-	    break;
-	  }
-	}
+    // only the selected hits are looked up, and they are kept in the order
+    // of the hit collection; with no selection, there is nothing to do
+    std::vector<recob::Hit> const& hits = *hHandle;
+    art::ProductID const hitsID = hHandle.id();
 
-	if(fStartHit[ip] && fFullHitlist[t].get()==fStartHit[ip]){
-	  fRefStartHit[ip]=const_cast<recob::Hit *>(fFullHitlist[t].get());
-	}
+    for(unsigned int ip=0;ip<nplanes;ip++){
+      std::vector<std::size_t> keys;
+      keys.reserve(fSelectedHitKeys[ip].size());
+      for(HitKey_t const& hitKey: fSelectedHitKeys[ip]){
+	if(hitKey.first == hitsID && hitKey.second < hits.size()) keys.push_back(hitKey.second);
+      }
+      std::sort(keys.begin(), keys.end());
 
-	if(fEndHit[ip] && fFullHitlist[t].get()==fEndHit[ip]){
-	  fRefEndHit[ip]=const_cast<recob::Hit *>(fFullHitlist[t].get());
-	}
+      fRefinedHitlist[ip].reserve(keys.size());
+      for(std::size_t key: keys) fRefinedHitlist[ip].push_back(art::Ptr<recob::Hit>(hHandle, key));
 
-      }
+      if(IsInCollection(fStartHit[ip], hits)) fRefStartHit[ip]=fStartHit[ip];
+      if(IsInCollection(fEndHit[ip], hits)) fRefEndHit[ip]=fEndHit[ip];
     }
     //for(int ip=0;ip<nplanes;ip++)
     //  FillStartEndHitCoords(ip);
 
     fSelectedHitlist.clear();
     fSelectedHitlist=fRefinedHitlist;
+    for(unsigned int ip=0;ip<nplanes;ip++) UpdateSelectedHitKeys(ip);
 
     return;
   }
 
+  //......................................................................
+  void InfoTransfer::SetHitList(unsigned int p,std::vector<art::Ptr < recob::Hit> > hits_to_save)
+  {
+    fSelectedHitlist[p].clear();
+    fSelectedHitlist[p]=hits_to_save;
+    UpdateSelectedHitKeys(p);
+  }
+
+  //......................................................................
+  bool InfoTransfer::IsSelectedHit(unsigned int plane, art::Ptr<recob::Hit> const& hit) const
+  {
+    return fSelectedHitKeys[plane].count(MakeHitKey(hit)) > 0;
+  }
+
+  //......................................................................
+  void InfoTransfer::SelectHit(unsigned int plane, art::Ptr<recob::Hit> const& hit)
+  {
+    if(fSelectedHitKeys[plane].insert(MakeHitKey(hit)).second)
+      fSelectedHitlist[plane].push_back(hit);
+  }
+
+  //......................................................................
+  void InfoTransfer::DeselectHit(unsigned int plane, art::Ptr<recob::Hit> const& hit)
+  {
+    HitKey_t const hitKey = MakeHitKey(hit);
+    if(fSelectedHitKeys[plane].erase(hitKey) == 0) return;
+
+    std::vector< art::Ptr < recob::Hit > >& hits = fSelectedHitlist[plane];
+    hits.erase(std::remove_if(hits.begin(), hits.end(),
+      [&hitKey](art::Ptr<recob::Hit> const& selected)
+        { return MakeHitKey(selected) == hitKey; }
+      ), hits.end());
+  }
+
+  //......................................................................
+  void InfoTransfer::UpdateSelectedHitKeys(unsigned int plane)
+  {
+    fSelectedHitKeys[plane].clear();
+    for(art::Ptr<recob::Hit> const& hit: fSelectedHitlist[plane])
+      fSelectedHitKeys[plane].insert(MakeHitKey(hit));
+  }
+
   //......................................................................
   void InfoTransfer::SetSeedList(std::vector < util::PxLine > seedlines)
   {
@@ -0,0 +1,179 @@
+/// \file    MCVoxelIndex.cxx
+/// \brief   Per-event energy deposits of the simulated particles in voxels
+
+#include "lareventdisplay/EventDisplay/MCVoxelIndex.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include "larsim/Simulation/LArVoxelData.h"
+#include "larsim/Simulation/LArVoxelList.h"
+#include "larsim/Simulation/SimListUtils.h"
+#include "nusimdata/SimulationBase/MCParticle.h"
+
+#include "art/Framework/Principal/Event.h"
+#include "messagefacility/MessageLogger/MessageLogger.h"
+
+namespace evd {
+
+  //......................................................................
+  void TrackIDIndex::Build(std::vector<simb::MCParticle const*> const& particles)
+  {
+    std::size_t nSlots = 16;
+    while (nSlots < 2 * particles.size()) nSlots *= 2;
+
+    fSlots.assign(nSlots, Slot_t{});
+    fMask = nSlots - 1;
+    fSize = 0;
+
+    for (std::size_t iPart = 0; iPart < particles.size(); ++iPart) {
+      if (!particles[iPart]) continue;
+      int const trackID = particles[iPart]->TrackId();
+      std::size_t iSlot = Slot(trackID);
+      while ((fSlots[iSlot].index != npos) && (fSlots[iSlot].trackID != trackID))
+        iSlot = (iSlot + 1) & fMask;
+      if (fSlots[iSlot].index == npos) ++fSize;
+      fSlots[iSlot] = { trackID, iPart }; // the last one is kept
+    } // for
+  } // TrackIDIndex::Build()
+
+
+  //......................................................................
+  void MCVoxelIndex::Deposits_t::clear()
+  {
+    particles.clear();
+    first.assign(1U, 0U);
+    x.clear();
+    y.clear();
+    z.clear();
+    energy.clear();
+  } // MCVoxelIndex::Deposits_t::clear()
+
+
+  //......................................................................
+  MCVoxelIndex& MCVoxelIndex::Instance()
+  {
+    static MCVoxelIndex index;
+    return index;
+  } // MCVoxelIndex::Instance()
+
+  //......................................................................
+  MCVoxelIndex::Deposits_t const& MCVoxelIndex::Deposits(
+    art::Event const& evt, std::string const& voxelLabel,
+    std::string const& particleLabel,
+    std::vector<simb::MCParticle const*> const& particles
+    )
+  {
+    if (fEvent.update(util::EventChangeTracker_t(evt))) fBinnings.clear();
+
+    auto const iBinning = fBinnings.find(Key_t(voxelLabel, particleLabel));
+    if ((iBinning != fBinnings.end())
+      && (particles == iBinning->second.deposits.particles)
+    ) {
+      return iBinning->second.deposits;
+    }
+
+    Binning_t& binning = fBinnings[Key_t(voxelLabel, particleLabel)];
+    binning.deposits.clear();
+    binning.deposits.particles = particles;
+    binning.trackIDs.Build(particles);
+    Bin(evt, voxelLabel, binning);
+    return binning.deposits;
+  } // MCVoxelIndex::Deposits()
+
+  //......................................................................
+  void MCVoxelIndex::Clear()
+  {
+    fEvent.clear();
+    fBinnings.clear();
+  } // MCVoxelIndex::Clear()
+
+  //......................................................................
+  void MCVoxelIndex::Bin(
+    art::Event const& evt, std::string const& voxelLabel,
+    Binning_t& binning
+    ) const
+  {
+    TrackIDIndex const& trackIDs = binning.trackIDs;
+    Deposits_t& deposits = binning.deposits;
+
+    sim::LArVoxelList const voxels
+      = sim::SimListUtils::GetLArVoxelList(evt, voxelLabel);
+
+    // the voxel positions are computed by a service which is not required to
+    // be thread-safe, so they are collected here, together with the position
+    // of the first deposit of each voxel in a flat list of all the deposits
+    std::size_t const nVoxels = voxels.size();
+    std::vector<sim::LArVoxelData const*> voxelData;
+    std::vector<double> voxelX, voxelY, voxelZ;
+    std::vector<std::size_t> firstDeposit;
+    voxelData.reserve(nVoxels);
+    voxelX.reserve(nVoxels);
+    voxelY.reserve(nVoxels);
+    voxelZ.reserve(nVoxels);
+    firstDeposit.reserve(nVoxels + 1);
+    firstDeposit.push_back(0U);
+    for (auto const& voxel: voxels) {
+      sim::LArVoxelData const& vxd = voxel.second;
+      voxelData.push_back(&vxd);
+      voxelX.push_back(vxd.VoxelID().X());
+      voxelY.push_back(vxd.VoxelID().Y());
+      voxelZ.push_back(vxd.VoxelID().Z());
+      firstDeposit.push_back(firstDeposit.back() + vxd.NumberParticles());
+    } // for voxels
+
+    // each voxel fills its own deposits with the particle they belong to
+    std::size_t const nDeposits = firstDeposit.back();
+    std::vector<std::size_t> depositParticle(nDeposits);
+    std::vector<double> depositEnergy(nDeposits);
+    tbb::parallel_for(tbb::blocked_range<std::size_t>(0, nVoxels),
+      [&](tbb::blocked_range<std::size_t> const& range)
+      {
+        for (std::size_t iVoxel = range.begin(); iVoxel != range.end(); ++iVoxel) {
+          sim::LArVoxelData const& vxd = *(voxelData[iVoxel]);
+          std::size_t iDeposit = firstDeposit[iVoxel];
+          for (std::size_t partIdx = 0; partIdx < vxd.NumberParticles(); ++partIdx) {
+            depositParticle[iDeposit] = trackIDs.Find(vxd.TrackID(partIdx));
+            depositEnergy[iDeposit] = vxd.Energy(partIdx);
+            ++iDeposit;
+          } // for particles in voxel
+        } // for voxels
+      });
+
+    // group the deposits by particle, keeping the order of the voxels
+    std::size_t const nParticles = deposits.particles.size();
+    std::vector<std::size_t>& first = deposits.first;
+    first.assign(nParticles + 1, 0U);
+    for (std::size_t iPart: depositParticle)
+      if (iPart != TrackIDIndex::npos) ++first[iPart + 1];
+    for (std::size_t iPart = 0; iPart < nParticles; ++iPart)
+      first[iPart + 1] += first[iPart];
+
+    std::size_t const nAssigned = first.back();
+    deposits.x.resize(nAssigned);
+    deposits.y.resize(nAssigned);
+    deposits.z.resize(nAssigned);
+    deposits.energy.resize(nAssigned);
+
+    std::vector<std::size_t> next(first.begin(), first.end() - 1);
+    for (std::size_t iVoxel = 0; iVoxel < nVoxels; ++iVoxel) {
+      for (std::size_t iDeposit = firstDeposit[iVoxel];
+        iDeposit < firstDeposit[iVoxel + 1]; ++iDeposit
+      ) {
+        std::size_t const iPart = depositParticle[iDeposit];
+        if (iPart == TrackIDIndex::npos) continue;
+        std::size_t const iDest = next[iPart]++;
+        deposits.x[iDest] = voxelX[iVoxel];
+        deposits.y[iDest] = voxelY[iVoxel];
+        deposits.z[iDest] = voxelZ[iVoxel];
+        deposits.energy[iDest] = depositEnergy[iDeposit];
+      } // for deposits in voxel
+    } // for voxels
+
+    mf::LogDebug("MCVoxelIndex") << "Binned " << nAssigned << "/" << nDeposits
+      << " deposits from " << nVoxels << " voxels ('" << voxelLabel
+      << "') into " << nParticles << " particles ("
+      << trackIDs.size() << " track IDs) of " << std::string(fEvent);
+  } // MCVoxelIndex::Bin()
+
+} // namespace evd
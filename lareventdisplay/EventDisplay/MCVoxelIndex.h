@@ -0,0 +1,175 @@
+/// \file    MCVoxelIndex.h
+/// \brief   Per-event energy deposits of the simulated particles in voxels
+#ifndef EVD_MCVOXELINDEX_H
+#define EVD_MCVOXELINDEX_H
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <limits>
+#include <map>
+#include <string>
+#include <utility> // std::pair
+#include <vector>
+
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::EventChangeTracker_t
+
+namespace art { class Event; }
+namespace simb { class MCParticle; }
+
+namespace evd {
+
+  /**
+   * @brief Position of the particles in a list, by their track ID
+   *
+   * The index is a flat open-addressing hash table (linear probing) of the
+   * track IDs, sized at least twice the number of particles. Looking up a
+   * track ID which is not in the list returns `npos` and leaves the index
+   * unchanged.
+   */
+  class TrackIDIndex {
+  public:
+
+    /// Returned by `Find()` for a track ID not in the index
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    /// Indexes the particles of the list (null pointers are skipped)
+    void Build(std::vector<simb::MCParticle const*> const& particles);
+
+    /// Returns the position in the list of the particle with `trackID`
+    std::size_t Find(int trackID) const
+      {
+        if (fSlots.empty()) return npos;
+        for (std::size_t iSlot = Slot(trackID);; iSlot = (iSlot + 1) & fMask) {
+          Slot_t const& slot = fSlots[iSlot];
+          if (slot.index == npos) return npos;
+          if (slot.trackID == trackID) return slot.index;
+        } // for
+      } // Find()
+
+    /// Returns the number of particles in the index
+    std::size_t size() const { return fSize; }
+
+  private:
+
+    /// An entry of the table; unused if `index` is `npos`
+    struct Slot_t {
+      int trackID = 0; ///< track ID of the particle
+      std::size_t index = npos; ///< position of the particle in the list
+    }; // Slot_t
+
+    std::vector<Slot_t> fSlots; ///< the table (size is a power of 2)
+    std::size_t fMask = 0; ///< bits of the hash used for the slot number
+    std::size_t fSize = 0; ///< number of particles in the index
+
+    /// Returns the first slot to be probed for `trackID`
+    std::size_t Slot(int trackID) const
+      {
+        // Fibonacci hashing: consecutive IDs are spread over the table
+        return std::size_t((std::uint64_t(unsigned(trackID))
+          * 0x9E3779B97F4A7C15ULL) >> 32) & fMask;
+      }
+
+  }; // class TrackIDIndex
+
+
+  /**
+   * @brief Energy deposited by each simulated particle in the voxels
+   *
+   * The voxel list (`sim::LArVoxelList`) is built out of the simulated
+   * channels, and the energy deposits of each voxel are assigned to the
+   * particles by track ID. Both steps take a long time on events with many
+   * particles, and the 3D truth drawers ask for the same binning on each
+   * redraw: the binning is done the first time it is asked for in an event,
+   * and kept until a different event is asked for. Different drawers may ask
+   * for voxel lists from different simulated channels, or for particles from
+   * different sources: each combination of voxel and particle input labels is
+   * binned and kept on its own, so that they don't evict each other.
+   * No drawing option is involved, so that changing them does not require
+   * binning again: in particular, the energy threshold is applied by the
+   * drawers.
+   *
+   * The deposits are stored in columns (one vector per coordinate) and
+   * grouped by particle, in the order of the particle list; deposits from
+   * track IDs not in the list are dropped. The voxels are assigned to the
+   * particles in parallel.
+   *
+   * The index is shared by all the drawers through `Instance()`, and it is
+   * not thread-safe.
+   */
+  class MCVoxelIndex {
+  public:
+
+    /// Energy deposits in voxels, grouped by particle
+    struct Deposits_t {
+      /// The particles, in the order of the list they were binned for
+      std::vector<simb::MCParticle const*> particles;
+
+      /// First deposit of each particle, plus the end of the last one
+      std::vector<std::size_t> first;
+
+      std::vector<double> x; ///< x coordinate of the voxel center [cm]
+      std::vector<double> y; ///< y coordinate of the voxel center [cm]
+      std::vector<double> z; ///< z coordinate of the voxel center [cm]
+      std::vector<double> energy; ///< energy deposited in the voxel [GeV]
+
+      /// Returns the number of particles
+      std::size_t NParticles() const { return particles.size(); }
+
+      /// Returns the index of the first deposit of the particle `iPart`
+      std::size_t Begin(std::size_t iPart) const { return first[iPart]; }
+
+      /// Returns the index after the last deposit of the particle `iPart`
+      std::size_t End(std::size_t iPart) const { return first[iPart + 1]; }
+
+      /// Forgets all the deposits
+      void clear();
+    }; // Deposits_t
+
+    /// Returns the index shared by the whole event display
+    static MCVoxelIndex& Instance();
+
+    /**
+     * @brief Returns the deposits of the voxels from `voxelLabel` by `particles`
+     * @param evt the event to read the voxels from
+     * @param voxelLabel input label of the simulated channels of the voxels
+     * @param particleLabel input label `particles` were read from
+     * @param particles the particles to assign the deposits to
+     *
+     * The binning for the same labels is reused within the same event, unless
+     * the particle list is different.
+     */
+    Deposits_t const& Deposits(
+      art::Event const& evt, std::string const& voxelLabel,
+      std::string const& particleLabel,
+      std::vector<simb::MCParticle const*> const& particles
+      );
+
+    /// Forgets all the deposits
+    void Clear();
+
+  private:
+
+    /// Voxel and particle input labels
+    using Key_t = std::pair<std::string, std::string>;
+
+    /// Deposits binned for a voxel list and a particle list
+    struct Binning_t {
+      TrackIDIndex trackIDs; ///< index of the particles in `deposits`
+      Deposits_t deposits; ///< the deposits
+    }; // Binning_t
+
+    util::EventChangeTracker_t fEvent; ///< the event the deposits refer to
+
+    std::map<Key_t, Binning_t> fBinnings; ///< deposits, by input labels
+
+    /// Fills the deposits from the voxels with the specified label
+    void Bin(
+      art::Event const& evt, std::string const& voxelLabel,
+      Binning_t& binning
+      ) const;
+
+  }; // class MCVoxelIndex
+
+} // namespace evd
+
+#endif // EVD_MCVOXELINDEX_H
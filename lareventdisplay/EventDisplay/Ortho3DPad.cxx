@@ -18,6 +18,7 @@
 
 #include "larcore/Geometry/Geometry.h"
 #include "larcorealg/Geometry/TPCGeo.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 #include "lareventdisplay/EventDisplay/Ortho3DPad.h"
 #include "lareventdisplay/EventDisplay/RecoBaseDrawer.h"
 #include "lareventdisplay/EventDisplay/SimulationDrawer.h"
@@ -235,12 +236,19 @@ void evd::Ortho3DPad::Draw(const char* /*opt*/)
 
   if(evt)
     {
+      evd::DrawingProfiler::Scope profile(fPad->GetName(), "MCTruthOrtho");
       SimulationDraw()->MCTruthOrtho(*evt, fProj, fMSize, fView);
+      profile.Next("SpacePointOrtho");
       RecoBaseDraw()->SpacePointOrtho(*evt, fProj, fMSize, fView);
+      profile.Next("PFParticleOrtho");
       RecoBaseDraw()->PFParticleOrtho(*evt, fProj, fMSize, fView);
+      profile.Next("ProngOrtho");
       RecoBaseDraw()->ProngOrtho(*evt, fProj, fMSize, fView);
+      profile.Next("SeedOrtho");
       RecoBaseDraw()->SeedOrtho(*evt, fProj, fView);
+      profile.Next("OpFlashOrtho");
       RecoBaseDraw()->OpFlashOrtho(*evt, fProj, fView);
+      profile.Next("VertexOrtho");
       RecoBaseDraw()->VertexOrtho(*evt, fProj, fView);
     }
   // Draw objects on pad.
@@ -248,7 +256,10 @@ void evd::Ortho3DPad::Draw(const char* /*opt*/)
   fPad->cd();
   fPad->GetPainter()->SetFillColor(18);
   fHisto->Draw("X-");
-  fView->Draw();
+  {
+    evd::DrawingProfiler::Scope profile(fPad->GetName(), "View2D::Draw", fPad);
+    fView->Draw();
+  }
   TLatex latex;
   latex.SetTextColor(16);
   latex.SetTextSize(0.05);
@@ -13,6 +13,7 @@
 #include "TRootEmbeddedCanvas.h"
 #include "lareventdisplay/EventDisplay/Ortho3DView.h"
 #include "lareventdisplay/EventDisplay/Ortho3DPad.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 
 #include "cetlib_except/exception.h"
 
@@ -137,6 +138,7 @@ evd::Ortho3DView::~Ortho3DView()
 // Draw object in graphics pads.
 void evd::Ortho3DView::Draw(const char* /*opt*/)
 {
+  evd::DrawingProfiler::Instance().UpdateEvent();
   for(std::vector<Ortho3DPad*>::const_iterator i = fOrtho3DPads.begin();
       i != fOrtho3DPads.end(); ++i) {
     Ortho3DPad* pad = *i;
@@ -31,6 +31,8 @@
  * since rendering of all boxes is attempted.
  * The new code performs dynamic aggregation after discovering the actual size
  * of the graphical viewport, and it submits at most one TBox per pixel.
+ * Optionally (`DrawingBackend` in `RawDrawingOptions`), the cells are painted
+ * into a single histogram per plane instead, with no TBox at all.
  * Additional improvement is caching of the uncompressed raw data, so that
  * following zooming is faster, and especially a way to bypass the decompression
  * when the original data is not compressed in the first place, that saves
@@ -52,11 +54,17 @@
  *   blank)
  */
 #include <algorithm> // std::fill(), std::find_if(), ...
+#include <atomic>
 #include <cmath> // std::abs(), ...
 #include <cstddef> // std::ptrdiff_t
+#include <deque>
+#include <future> // std::async()
 #include <limits> // std::numeric_limits<>
+#include <map>
 #include <memory> // std::unique_ptr()
-#include <tuple>
+#include <new> // std::align_val_t
+#include <set>
+#include <tuple> // std::apply()
 #include <type_traits> // std::add_const_t<>, ...
 #include <typeinfo> // to use typeid()
 #include <utility> // std::move()
@@ -66,17 +74,23 @@
 #include "TH1F.h"
 #include "TVirtualPad.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardataalg/Utilities/StatCollector.h" // lar::util::MinMaxCollector<>
 #include "lardataobj/RawData/RawDigit.h"
 #include "lardataobj/RawData/raw.h"
+#include "lareventdisplay/EventDisplay/CellGrid.h"
 #include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::PlaneDataChangeTracker_t
+#include "lareventdisplay/EventDisplay/ChannelConditions.h"
+#include "lareventdisplay/EventDisplay/ChannelWireMap.h"
+#include "lareventdisplay/EventDisplay/ColorRaster.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RawDataDrawer.h"
+#include "lareventdisplay/EventDisplay/RawDigitCells.h"
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
-#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
-#include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 #include "larevt/CalibrationDBI/Interface/DetPedestalProvider.h"
 #include "larevt/CalibrationDBI/Interface/DetPedestalService.h"
 #include "nuevdb/EventDisplayBase/View2D.h"
@@ -170,11 +184,141 @@ namespace details {
         bool bOwned = false;   ///< whether we own our data
         pointer pData = nullptr; ///< pointer to data
     }; // class PointerToData_t<>
+    
+    
+    /// Allocator returning memory aligned for vectorized access
+    template <typename T, std::size_t Alignment = 64>
+    class AlignedAllocator {
+    public:
+        using value_type = T;
+        
+        /// Alignment of the allocated memory, in bytes
+        static constexpr std::size_t alignment = Alignment;
+        
+        template <typename U>
+        struct rebind { using other = AlignedAllocator<U, Alignment>; };
+        
+        AlignedAllocator() = default;
+        template <typename U>
+        AlignedAllocator(AlignedAllocator<U, Alignment> const&) {}
+        
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>
+            (::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+        
+        void deallocate(T* p, std::size_t)
+        { ::operator delete(p, std::align_val_t(Alignment)); }
+        
+        template <typename U>
+        bool operator== (AlignedAllocator<U, Alignment> const&) const
+        { return true; }
+        template <typename U>
+        bool operator!= (AlignedAllocator<U, Alignment> const&) const
+        { return false; }
+    }; // class AlignedAllocator<>
 }
 
 namespace evd {
     namespace details {
         
+        /// Non-owning view of a sequence of ADC samples
+        class ADCspan_t {
+        public:
+            using value_type = raw::RawDigit::ADCvector_t::value_type;
+            using const_iterator = value_type const*;
+            
+            /// Default constructor: an empty sequence
+            ADCspan_t() = default;
+            
+            /// Constructor: views n samples starting at start
+            ADCspan_t(value_type const* start, size_t n)
+            : b(start), e(start + n) {}
+            
+            /// Constructor: views the content of a vector
+            ADCspan_t(raw::RawDigit::ADCvector_t const& v)
+            : ADCspan_t(v.data(), v.size()) {}
+            
+            const_iterator begin() const { return b; }
+            const_iterator end() const { return e; }
+            size_t size() const { return e - b; }
+            bool empty() const { return b == e; }
+            value_type operator[] (size_t i) const { return b[i]; }
+            value_type const* data() const { return b; }
+            
+        private:
+            value_type const* b = nullptr; ///< first sample
+            value_type const* e = nullptr; ///< past the last sample
+        }; // class ADCspan_t
+        
+        
+        /**
+         * @brief Returns the pedestal of the digit according to the pedestal option
+         * @param digit the digit to get the pedestal of
+         * @param pedestalOption the pedestal option (see `RawDrawingOptions`)
+         * @param servicePedestal callable returning the pedestal of a channel
+         *                        from the pedestal service
+         */
+        template <typename ServicePedestal>
+        float DigitPedestal(
+                            raw::RawDigit const& digit, int pedestalOption,
+                            ServicePedestal&& servicePedestal
+                            )
+        {
+            switch (pedestalOption) {
+                case 0: return servicePedestal(digit.Channel());
+                case 1: return digit.GetPedestal();
+                case 2: return 0.F;
+                default:
+                    mf::LogWarning  ("RawDataDrawer") << " PedestalOption is not understood: " << pedestalOption << ".  Pedestals not subtracted.";
+                    return 0.F;
+            } // switch
+        } // DigitPedestal()
+        
+        
+        /// Uncompresses the data of a digit into the specified buffer
+        void UncompressDigit(
+                             raw::RawDigit const& digit, bool bUncompressWithPed,
+                             raw::RawDigit::ADCvector_t& buffer
+                             )
+        {
+            buffer.resize(digit.Samples());
+            if (bUncompressWithPed) {//Use pedestal in uncompression
+                Uncompress(digit.ADCs(), buffer,
+                           (int) digit.GetPedestal(), digit.Compression());
+            }
+            else
+                Uncompress(digit.ADCs(), buffer, digit.Compression());
+        } // UncompressDigit()
+        
+        
+        /**
+         * @brief Copies samples subtracting the pedestal, and finds their range
+         * @param src the samples to be copied
+         * @param dest where to copy the samples to (as many as in src)
+         * @param pedestal the (integral) pedestal to be subtracted
+         * @return the minimum and maximum of the copied samples
+         *
+         * This is a single pass meant to be vectorized by the compiler.
+         */
+        std::pair<short, short> CopyWithPedestal
+        (ADCspan_t src, short* dest, short pedestal)
+        {
+            short minCharge = std::numeric_limits<short>::max();
+            short maxCharge = std::numeric_limits<short>::min();
+            short const* source = src.data();
+            size_t const n = src.size();
+            for (size_t i = 0; i < n; ++i) {
+                short const adc = source[i] - pedestal;
+                dest[i] = adc;
+                minCharge = std::min(minCharge, adc);
+                maxCharge = std::max(maxCharge, adc);
+            } // for
+            return { minCharge, maxCharge };
+        } // CopyWithPedestal()
+        
+        
         /// Information about a RawDigit; may contain uncompressed duplicate of data
         class RawDigitInfo_t {
         public:
@@ -197,8 +341,25 @@ namespace evd {
             /// average charge
             //  short AverageCharge() const { return SampleInfo().average_charge; }
             
-            /// Returns the uncompressed data
-            raw::RawDigit::ADCvector_t const& Data() const;
+            /**
+             * @brief Returns the uncompressed data (uncompressing it if needed)
+             *
+             * The samples have the pedestal already subtracted, rounded to an
+             * integer; the remaining fraction is given by PedestalResidual().
+             */
+            ADCspan_t const& Data() const;
+            
+            /// Returns the pedestal still to be subtracted from the Data() samples
+            float PedestalResidual() const { Data(); return pedestal_residual; }
+            
+            /// Returns whether the uncompressed data is already available
+            bool hasData() const { return bHasData; }
+            
+            /// Uses the specified uncompressed data (not owned) and its range
+            void SetData(
+                         ADCspan_t samples, float residual,
+                         short min_charge, short max_charge
+                         );
             
             /// Parses the specified digit
             void Fill(art::Ptr<raw::RawDigit> const& src);
@@ -219,11 +380,23 @@ namespace evd {
             
             art::Ptr<raw::RawDigit> digit; ///< a pointer to the actual digit
             
-            /// Uncompressed data
+            /// View of the uncompressed data (wherever it is)
+            mutable ADCspan_t samples;
+            
+            /// Whether samples points to the uncompressed data
+            mutable bool bHasData = false;
+            
+            /// Part of the pedestal not subtracted from the samples yet
+            mutable float pedestal_residual = 0.F;
+            
+            /// Uncompressed data, if uncompressed by this object alone
             mutable ::details::PointerToData_t<raw::RawDigit::ADCvector_t const> data;
             
             /// Information collected from the uncompressed data
-            mutable std::unique_ptr<SampleInfo_t> sample_info;
+            mutable SampleInfo_t sample_info;
+            
+            /// Whether sample_info is up to date
+            mutable bool bHasSampleInfo = false;
             
             /// Fills the uncompressed data cache
             void UncompressData() const;
@@ -237,19 +410,323 @@ namespace evd {
         }; // class RawDigitInfo_t
         
         
+        /// A wire on a plane, and the information on the digit of its channel
+        struct WireDigitInfo_t {
+            geo::WireID wireID; ///< ID of the wire
+            RawDigitInfo_t const* digitInfo = nullptr; ///< digit of the channel
+            
+            /// Returns the information on the digit of this wire
+            RawDigitInfo_t const& DigitInfo() const { return *digitInfo; }
+        }; // struct WireDigitInfo_t
+        
+        
+        /**
+         * @brief Multi-resolution summary of the raw charge on a wire plane
+         *
+         * The pyramid is a set of levels, each one a grid of cells spanning
+         * 2^k ticks and 2^m wires (wire-major, like CellGridClass).
+         * Each cell holds the pedestal-subtracted ADC count with the largest
+         * magnitude among the samples from good channels in the cell, or
+         * `NoGoodADC` if no good channel contributes to it.
+         * The finest level (the base) has k = `MinTickShift` and m = 0 (finer
+         * tick resolution is not worth the memory).
+         *
+         * The base level is filled one sample at a time with Add(). The other
+         * levels are derived from it only when FindLevel() asks for them, and
+         * the ones used least recently are dropped to keep all the derived
+         * levels together not larger than the base. The memory is then at most
+         * twice the one of the base, rather than the four times needed for all
+         * the combinations of k and m.
+         *
+         * The sums of the charge in blocks of 2^`ChargeTickShift` ticks of each
+         * wire are also stored, so that the charge in the drawn area is known
+         * without going through the samples again (see SumCharge()).
+         */
+        class PlanePyramidClass {
+        public:
+            using ADC_t = short; ///< type of the stored ADC counts
+            
+            /// Value of cells without any good channel
+            static constexpr ADC_t NoGoodADC = std::numeric_limits<ADC_t>::min();
+            
+            /// Number of ticks in a cell of the finest level, as power of 2
+            static constexpr unsigned int MinTickShift = 2;
+            
+            /// Number of ticks in a block of the charge sums, as power of 2
+            static constexpr unsigned int ChargeTickShift = 6;
+            
+            /// Drawing settings the content of the pyramid depends on
+            struct Settings_t {
+                int pedestalOption = -1; ///< pedestal subtraction mode
+                bool seeBadChannels = false; ///< whether bad channels are included
+                unsigned int minChannelStatus = 0; ///< lowest included status
+                unsigned int maxChannelStatus = 0; ///< highest included status
+                size_t startTick = 0; ///< first tick included
+                size_t endTick = 0; ///< first tick not included
+                
+                bool operator== (Settings_t const& as) const
+                {
+                    return (pedestalOption == as.pedestalOption)
+                    && (seeBadChannels == as.seeBadChannels)
+                    && (minChannelStatus == as.minChannelStatus)
+                    && (maxChannelStatus == as.maxChannelStatus)
+                    && (startTick == as.startTick)
+                    && (endTick == as.endTick);
+                }
+                bool operator!= (Settings_t const& than) const
+                { return !operator==(than); }
+            }; // struct Settings_t
+            
+            /// A single resolution level of the pyramid
+            class Level_t {
+            public:
+                Level_t(
+                        unsigned int wire_shift, unsigned int tick_shift,
+                        size_t n_wire_cells, size_t n_tick_cells
+                        )
+                : wireShift(wire_shift), tickShift(tick_shift)
+                , nWireCells(n_wire_cells), nTickCells(n_tick_cells)
+                , cells(n_wire_cells * n_tick_cells, NoGoodADC)
+                {}
+                
+                /// Number of wires in each cell, as power of 2
+                unsigned int WireShift() const { return wireShift; }
+                
+                /// Number of ticks in each cell, as power of 2
+                unsigned int TickShift() const { return tickShift; }
+                
+                /// Number of cells on the wire direction
+                size_t NWireCells() const { return nWireCells; }
+                
+                /// Number of cells on the tick direction
+                size_t NTickCells() const { return nTickCells; }
+                
+                /// Total number of cells
+                size_t NCells() const { return cells.size(); }
+                
+                /// Returns the content of the specified cell
+                ADC_t operator() (size_t iWireCell, size_t iTickCell) const
+                { return cells[iWireCell * nTickCells + iTickCell]; }
+                
+                /// Returns the content of the specified cell
+                ADC_t& operator() (size_t iWireCell, size_t iTickCell)
+                { return cells[iWireCell * nTickCells + iTickCell]; }
+                
+            private:
+                unsigned int wireShift; ///< wires per cell, as power of 2
+                unsigned int tickShift; ///< ticks per cell, as power of 2
+                size_t nWireCells; ///< number of cells on the wire direction
+                size_t nTickCells; ///< number of cells on the tick direction
+                std::vector<ADC_t> cells; ///< content of the cells
+            }; // class Level_t
+            
+            /// Prepares an empty base level for nWires wires
+            void Init(Settings_t const& new_settings, size_t nWires);
+            
+            /// Adds a sample from a good channel, and its converted charge
+            void Add
+            (geo::WireID::WireID_t wire, size_t tick, float adc, float charge)
+            {
+                Level_t& base = levels.front();
+                size_t const iTick = tick - settings.startTick;
+                size_t const iTickCell = iTick >> MinTickShift;
+                if ((wire >= base.NWireCells()) || (iTickCell >= base.NTickCells()))
+                    return;
+                ADC_t& cell = base(wire, iTickCell);
+                cell = Merge(cell, ToADC(adc));
+                
+                ChargeSum_t& sum
+                = chargeSums[wire * nChargeBlocks + (iTick >> ChargeTickShift)];
+                sum.raw += adc;
+                sum.converted += charge;
+            } // Add()
+            
+            /// Declares the base level filled
+            void Complete();
+            
+            /// Returns whether the pyramid is complete and built with settings
+            bool isValid(Settings_t const& with_settings) const
+            { return bComplete && (settings == with_settings); }
+            
+            /// Removes all the content
+            void Clear();
+            
+            /// Returns the first tick covered by the pyramid
+            size_t StartTick() const { return settings.startTick; }
+            
+            /**
+             * @brief Returns the coarsest level with cells not larger than asked
+             * @param wire_cell_size size of the drawing cell in wires
+             * @param tick_cell_size size of the drawing cell in ticks
+             * @return the level, or nullptr if none is fine enough
+             *
+             * The level is derived now if it is not available; the returned
+             * pointer is valid until the next call.
+             */
+            Level_t const* FindLevel(float wire_cell_size, float tick_cell_size);
+            
+            /**
+             * @brief Sums the charge in the specified area
+             * @param minWire lower wire coordinate of the area
+             * @param maxWire upper wire coordinate of the area (excluded)
+             * @param minTick lower tick of the area
+             * @param maxTick upper tick of the area (excluded)
+             * @param[out] raw sum of the pedestal-subtracted ADC counts
+             * @param[out] converted sum of the converted charge
+             *
+             * The blocks of charge sums with the center in the area are included.
+             */
+            void SumCharge(
+                           float minWire, float maxWire, float minTick, float maxTick,
+                           double& raw, double& converted
+                           ) const;
+            
+            /// Returns the memory used by the pyramid [bytes]
+            size_t MemoryUsage() const;
+            
+            /// Returns the one of a and b with larger magnitude, ignoring no data
+            static ADC_t Merge(ADC_t a, ADC_t b)
+            {
+                if (b == NoGoodADC) return a;
+                if (a == NoGoodADC) return b;
+                return (std::abs(a) <= std::abs(b))? b: a;
+            } // Merge()
+            
+        private:
+            Settings_t settings; ///< settings used to fill the pyramid
+            
+            /// Charge of the samples in a block of ticks of a wire
+            struct ChargeSum_t {
+                float raw = 0.F; ///< sum of the pedestal-subtracted ADC counts
+                float converted = 0.F; ///< sum of the converted charge
+            }; // struct ChargeSum_t
+            
+            size_t nWireLevels = 0; ///< number of resolutions on wire direction
+            size_t nTickLevels = 0; ///< number of resolutions on tick direction
+            
+            /// The base level first, then the derived levels, the last used last
+            std::vector<Level_t> levels;
+            
+            size_t nChargeBlocks = 0; ///< number of charge sum blocks per wire
+            
+            /// Charge sums of each wire, in blocks of ticks (wire-major)
+            std::vector<ChargeSum_t> chargeSums;
+            
+            bool bComplete = false; ///< whether the base level is filled
+            
+            /// Returns the level with the specified resolution indices
+            Level_t const& GetLevel(size_t iTickLevel, size_t iWireLevel);
+            
+            /// Adds a new level merging the cells of the best suited one
+            Level_t const& DeriveLevel
+            (unsigned int wireShift, unsigned int tickShift);
+            
+            /// Converts a float ADC count into a stored one (truncating)
+            static ADC_t ToADC(float adc)
+            {
+                constexpr float maxADC = std::numeric_limits<ADC_t>::max();
+                return (ADC_t) std::max(-maxADC, std::min(maxADC, adc));
+            } // ToADC()
+            
+        }; // class PlanePyramidClass
+        
+        
         /// Cached set of RawDigitInfo_t
         class RawDigitCacheDataClass {
         public:
             
+            /// List of wires of a plane, with their digits
+            using PlaneDigits_t = std::vector<WireDigitInfo_t>;
+            
             /// Returns the list of digit info
             std::vector<RawDigitInfo_t> const& Digits() const { return digits; }
             
-            /// Returns a pointer to the digit info of given channel, nullptr if none
-            RawDigitInfo_t const* FindChannel(raw::ChannelID_t channel) const;
+            /**
+             * @brief Returns a pointer to the digit info of given channel, nullptr if none
+             *
+             * If the digit is being uncompressed in the background, this waits
+             * for the worker to complete, so that the data of the digit can be
+             * read (or uncompressed) safely.
+             */
+            RawDigitInfo_t const* FindChannel(raw::ChannelID_t channel);
+            
+            /**
+             * @brief Returns the digits of all the wires on the specified plane
+             * @param pid ID of the plane
+             * @return list of wire/digit information, empty if plane has none
+             *
+             * The wire IDs are resolved when the cache is filled, so that the
+             * returned list includes only channels with wires on plane `pid`.
+             * A channel with more than one wire on the plane appears once per
+             * wire, in consecutive entries.
+             */
+            PlaneDigits_t const& PlaneDigits(geo::PlaneID const& pid) const;
+            
+            /// Returns whether any cached digit has wires on the specified plane
+            bool hasPlane(geo::PlaneID const& pid) const
+            { return !PlaneDigits(pid).empty(); }
             
             /// Returns the largest number of samples in the unpacked raw digits
             size_t MaxSamples() const { return max_samples; }
             
+            /**
+             * @brief Uncompresses at once all the digits with wires on a plane
+             * @param pid ID of the plane whose digits need uncompressing
+             *
+             * The digits are uncompressed in parallel into a single block of
+             * memory, with rows of the same length, one per digit.
+             * The pedestal (according to the current `PedestalOption`) is
+             * subtracted and the sample range is collected at the same time.
+             * Digits already uncompressed are skipped, and so are planes
+             * already processed since the last refill. If the uncompression
+             * options change, all the digits are uncompressed again.
+             * Memory blocks are recycled from event to event.
+             */
+            void UncompressPlane(geo::PlaneID const& pid);
+            
+            /**
+             * @brief Starts uncompressing all the other planes in the background
+             *
+             * All the digits on planes (of any TPC) not uncompressed yet are
+             * uncompressed in a worker thread, the same way as
+             * `UncompressPlane()` does.
+             * Everything requiring services (pedestals and memory blocks) is
+             * prepared before the worker starts, and the worker reads its own
+             * copy of the digits, since the event may be released before it
+             * completes. Asking for a plane still being uncompressed, or for
+             * a channel (`FindChannel()`) with a digit still being uncompressed,
+             * waits for the worker to complete. Changing the content of the cache stops
+             * the worker (`CancelPrefetch()`). Only one prefetch is run at a
+             * time.
+             */
+            void PrefetchPlanes();
+            
+            /**
+             * @brief Stops the background uncompression, if any
+             *
+             * The worker is asked to stop and waited for. The digits it has
+             * already uncompressed are kept, and the others are uncompressed
+             * again when their plane is asked for.
+             */
+            void CancelPrefetch();
+            
+            /// Stops the background uncompression of all the shared caches
+            static void CancelAllPrefetches();
+            
+            /// Returns the charge pyramid of the plane (created empty if needed);
+            /// creating it is not thread-safe
+            PlanePyramidClass& Pyramid(geo::PlaneID const& pid)
+            { return pyramids[pid]; }
+            
+            /// Returns the charge pyramid of the plane, nullptr if not present
+            PlanePyramidClass const* FindPyramid(geo::PlaneID const& pid) const;
+            PlanePyramidClass* FindPyramid(geo::PlaneID const& pid);
+            
+            /// Returns the conditions of all channels for the current event
+            /// (the table is shared with all the other drawers)
+            ChannelConditionTable const& ChannelConditions() const
+            { return ChannelConditionTable::Instance(); }
+            
             /// Returns whether the cache is empty() (STL-like interface)
             bool empty() const { return digits.empty(); }
             
@@ -270,6 +747,20 @@ namespace evd {
             template <typename Stream>
             void Dump(Stream&& out) const;
             
+            ~RawDigitCacheDataClass();
+            
+            /**
+             * @brief Returns the cache of the digits from the specified input
+             * @param label input label of the raw digits
+             *
+             * All the drawers (one per pad) read the digits of the same
+             * product through the same cache, so that each digit is
+             * uncompressed only once, whatever the number of pads showing it.
+             * The caches live until the end of the job. This function is not
+             * thread-safe.
+             */
+            static RawDigitCacheDataClass& Shared(art::InputTag const& label);
+            
         private:
             
             struct BoolWithUpToDateMetadata {
@@ -286,231 +777,129 @@ namespace evd {
                 operator bool() const { return bUpToDate; }
             }; // struct BoolWithUpToDateMetadata
             
-            std::vector<RawDigitInfo_t> digits; ///< vector of raw digit information
-            
-            CacheID_t timestamp; ///< object expressing validity range of cached data
-            
-            size_t max_samples = 0; ///< the largest number of ticks in any digit
-            
-            /// Checks whether an update is needed; can load digits in the process
-            BoolWithUpToDateMetadata CheckUpToDate
-            (CacheID_t const& ts, art::Event const* evt = nullptr) const;
-            
-            static std::vector<raw::RawDigit> const* ReadProduct
-            (art::Event const& evt, art::InputTag label);
+            /// Index value for channels without a digit
+            static constexpr size_t NoDigit = std::numeric_limits<size_t>::max();
             
-        }; // struct RawDigitCacheDataClass
-        
-        
-        std::vector<evd::details::RawDigitInfo_t>::const_iterator begin
-        (RawDigitCacheDataClass const& cache)
-        { return cache.Digits().cbegin(); }
-        std::vector<evd::details::RawDigitInfo_t>::const_iterator end
-        (RawDigitCacheDataClass const& cache)
-        { return cache.Digits().cend(); }
-        
-        
-        
-        /// Manages a cell-like division of a coordinate
-        class GridAxisClass {
-        public:
-            /// Default constructor: an invalid range
-            GridAxisClass() { Init(0, 0., 0.); }
-            
-            /// Constructor: sets the limits and the number of cells
-            GridAxisClass(size_t nDiv, float new_min, float new_max)
-            { Init(nDiv, new_min, new_max); }
-            
-            //@{
-            /// Returns the index of the specified cell
-            std::ptrdiff_t GetCell(float coord) const;
-            std::ptrdiff_t operator() (float coord) const { return GetCell(coord); }
-            //@}
-            
-            /// Returns whether the cell is present or not
-            bool hasCell(std::ptrdiff_t iCell) const
-            { return (iCell >= 0) && ((size_t) iCell < NCells()); }
-            
-            /// Returns whether the coordinate is included in the range or not
-            bool hasCoord(float coord) const
-            { return (coord >= Min()) && (coord < Max()); }
-            
-            
-            //@{
-            /// Returns the extremes of the axis
-            float Min() const { return min; }
-            float Max() const { return max; }
-            //@}
-            
-            /// Returns the length of the axis
-            float Length() const { return max - min; }
-            
-            /// Returns the length of the axis
-            size_t NCells() const { return n_cells; }
-            
-            /// Returns whether minimum and maximum match
-            bool isEmpty() const { return max == min; }
-            
-            /// Returns the cell size
-            float CellSize() const { return cell_size; }
-            
-            /// Returns the lower edge of the cell
-            float LowerEdge(std::ptrdiff_t iCell) const
-            { return Min() + CellSize() * iCell; }
-            
-            /// Returns the upper edge of the cell
-            float UpperEdge(std::ptrdiff_t iCell) const
-            { return LowerEdge(iCell + 1); }
-            
-            /// Initialize the axis, returns whether cell size is finite
-            bool Init(size_t nDiv, float new_min, float new_max);
-            
-            /// Initialize the axis limits, returns whether cell size is finite
-            bool SetLimits(float new_min, float new_max);
-            
-            /// Expands the cell (at fixed range) to meet minimum cell size
-            /// @return Whether the cell size was changed
-            bool SetMinCellSize(float min_size);
-            
-            /// Expands the cell (at fixed range) to meet maximum cell size
-            /// @return Whether the cell size was changed
-            bool SetMaxCellSize(float max_size);
-            
-            /// Expands the cell (at fixed range) to meet maximum cell size
-            /// @return Whether the cell size was changed
-            bool SetCellSizeBoundary(float min_size, float max_size)
-            { return SetMinCellSize(min_size) || SetMaxCellSize(max_size); }
-            
-            template <typename Stream>
-            void Dump(Stream&& out) const;
+            std::vector<RawDigitInfo_t> digits; ///< vector of raw digit information
             
-        private:
-            size_t n_cells; ///< number of cells in the axis
-            float min, max; ///< extremes of the axis
+            /// Index in `digits` of the digit of each channel (`NoDigit` if none)
+            std::vector<size_t> channel_index;
             
-            float cell_size; ///< size of each cell
+            /// Wires of each plane with their digits
+            std::map<geo::PlaneID, PlaneDigits_t> plane_digits;
             
-        }; // GridAxisClass
-        
-        
-        /// Manages a grid-like division of 2D space
-        class CellGridClass {
-        public:
+            /// Charge summaries of the planes
+            std::map<geo::PlaneID, PlanePyramidClass> pyramids;
             
-            /// Default constructor: invalid ranges
-            CellGridClass(): wire_axis(), tdc_axis() {}
+            /// Type of memory block for uncompressed samples
+            using ADCarena_t = std::vector
+            <ADCspan_t::value_type, ::details::AlignedAllocator<ADCspan_t::value_type>>;
             
-            /// Constructor: sets the extremes and assumes one cell for each element
-            CellGridClass(unsigned int nWires, unsigned int nTDC);
+            /// A memory block for uncompressed samples, reused across events
+            struct ADCslab_t {
+                ADCarena_t samples; ///< the memory block
+                bool inUse = false; ///< whether the block holds current data
+            }; // struct ADCslab_t
             
-            /// Constructor: sets the wire and TDC ranges in detail
-            CellGridClass(
-                          float min_wire, float max_wire, unsigned int nWires,
-                          float min_tdc, float max_tdc, unsigned int nTDC
-                          );
+            /// Options the uncompressed samples depend on
+            struct UncompressSettings_t {
+                int pedestalOption = -1; ///< pedestal subtraction mode
+                bool uncompressWithPed = false; ///< pedestal used in uncompression
+                
+                bool operator!= (UncompressSettings_t const& than) const
+                {
+                    return (pedestalOption != than.pedestalOption)
+                    || (uncompressWithPed != than.uncompressWithPed);
+                }
+            }; // struct UncompressSettings_t
             
-            /// Returns the total number of cells in the grid
-            size_t NCells() const { return wire_axis.NCells() * tdc_axis.NCells(); }
+            /// Pool of blocks of uncompressed samples, one per UncompressPlane() call
+            std::deque<ADCslab_t> slabs;
             
-            /// Return the information about the wires
-            GridAxisClass const& WireAxis() const { return wire_axis; }
+            /// Planes whose digits have been already uncompressed
+            std::set<geo::PlaneID> uncompressed_planes;
             
-            /// Return the information about the TDCs
-            GridAxisClass const& TDCAxis() const { return tdc_axis; }
+            /// Options the current uncompressed samples were made with
+            UncompressSettings_t uncompress_settings;
             
+            /// Digits to be uncompressed together, with what they need from services
+            struct UncompressJob_t {
+                std::vector<RawDigitInfo_t*> digits; ///< digits to uncompress
+                std::vector<float> pedestals; ///< pedestal of each digit
+                ADCspan_t::value_type* arena = nullptr; ///< start of destination block
+                size_t stride = 0; ///< samples in each row of the destination block
+                bool uncompressWithPed = false; ///< pedestal used in uncompression
+                
+                /// Copy of each digit, read instead of the event data if present
+                std::vector<raw::RawDigit> digitCopies;
+                
+                /// When set, the digits not started yet are skipped
+                std::atomic<bool> const* cancel = nullptr;
+                
+                bool empty() const { return digits.empty(); }
+            }; // struct UncompressJob_t
             
-            /// Returns the index of specified cell, or -1 if out of range
-            std::ptrdiff_t GetCell(float wire, float tick) const;
+            /// Uncompression in progress in the background (see `PrefetchPlanes()`)
+            std::future<void> prefetch;
             
-            /// Returns the coordinates { w1, t1, w2, t2 } of specified cell
-            std::tuple<float, float, float, float> GetCellBox
-            (std::ptrdiff_t iCell) const;
+            /// Asks the uncompression in the background to stop
+            std::atomic<bool> cancel_prefetch { false };
             
-            //@{
-            /// Returns whether the range includes the specified wire
-            bool hasWire(float wire) const { return wire_axis.hasCoord(wire); }
-            bool hasWire(int wire) const { return hasWire((float) wire); }
-            //@}
+            /// Planes being uncompressed in the background
+            std::set<geo::PlaneID> prefetched_planes;
             
-            //@{
-            /// Returns whether the range includes the specified wire
-            bool hasTick(float tick) const { return tdc_axis.hasCoord(tick); }
-            bool hasTick(int tick) const { return hasTick((float) tick); }
-            //@}
+            /// Whether each digit is being uncompressed in the background
+            std::vector<bool> prefetched_digits;
             
+            /// Returns a block of at least the specified size from the pool
+            ADCarena_t& AcquireSlab(size_t size);
             
-            /// Increments the specified cell of cont with the value v
-            /// @return whether there was such a cell
-            template <typename CONT>
-            bool Add(CONT& cont, float wire, float tick, typename CONT::value_type v)
-            {
-                std::ptrdiff_t cell = GetCell(wire, tick);
-                if (cell < 0) return false;
-                cont[(size_t) cell] += v;
-                return true;
-            } // Add()
+            /// Forgets all the uncompressed samples, keeping the memory for reuse
+            void ReleaseUncompressedData();
             
+            /// Drops the uncompressed samples if the drawing options changed
+            void UpdateUncompressSettings();
             
-            /// @name Setters
-            /// @{
-            /// Sets a simple wire range: all the wires, one cell per wire
-            void SetWireRange(unsigned int nWires)
-            { SetWireRange(0., (float) nWires, nWires); }
+            /// Collects the digits on the planes still needing uncompression
+            UncompressJob_t PrepareUncompression(std::set<geo::PlaneID> const& pids);
             
-            /// Sets the wire range, leaving the number of wire cells unchanged
-            void SetWireRange(float min_wire, float max_wire)
-            { wire_axis.SetLimits(min_wire, max_wire); }
+            /// Uncompresses the digits of the job; does not use any service
+            static void Uncompress(UncompressJob_t const& job);
             
-            /// Sets the complete wire range
-            void SetWireRange(float min_wire, float max_wire, unsigned int nWires)
-            { wire_axis.Init(nWires, min_wire, max_wire); }
+            /// Waits for the background uncompression to complete, if any
+            void WaitForPrefetch();
             
-            /// Sets the complete wire range, with minimum cell size
-            void SetWireRange
-            (float min_wire, float max_wire, unsigned int nWires, float min_size)
-            {
-                wire_axis.Init(nWires, min_wire, max_wire);
-                wire_axis.SetMinCellSize(min_size);
-            }
+            /// Returns the digit info of the channel, whether its data is ready or not
+            RawDigitInfo_t const* LocateChannel(raw::ChannelID_t channel) const;
             
-            /// Sets a simple TDC range: all the ticks, one cell per tick
-            void SetTDCRange(unsigned int nTDC)
-            { SetTDCRange(0., (float) nTDC, nTDC); }
+            /// Returns all the caches created by Shared(), by input label
+            static std::map<std::string, std::unique_ptr<RawDigitCacheDataClass>>&
+            SharedCaches();
             
-            /// Sets the complete TDC range
-            void SetTDCRange(float min_tdc, float max_tdc, unsigned int nTDC)
-            { tdc_axis.Init(nTDC, min_tdc, max_tdc); }
-            
-            /// Sets the TDC range, leaving the number of ticks unchanged
-            void SetTDCRange(float min_tdc, float max_tdc)
-            { tdc_axis.SetLimits(min_tdc, max_tdc); }
-            
-            /// Sets the complete TDC range, with minimum cell size
-            void SetTDCRange
-            (float min_tdc, float max_tdc, unsigned int nTDC, float min_size)
-            {
-                tdc_axis.Init(nTDC, min_tdc, max_tdc);
-                tdc_axis.SetMinCellSize(min_size);
-            }
+            CacheID_t timestamp; ///< object expressing validity range of cached data
             
-            /// @}
+            size_t max_samples = 0; ///< the largest number of ticks in any digit
             
-            /// Sets the minimum size for wire cells
-            bool SetMinWireCellSize(float min_size)
-            { return wire_axis.SetMinCellSize(min_size); }
+            /// Fills the channel and plane indices from the current digits
+            void BuildIndices();
             
-            /// Sets the minimum size for TDC cells
-            bool SetMinTDCCellSize(float min_size)
-            { return tdc_axis.SetMinCellSize(min_size); }
+            /// Checks whether an update is needed; can load digits in the process
+            BoolWithUpToDateMetadata CheckUpToDate
+            (CacheID_t const& ts, art::Event const* evt = nullptr) const;
             
-            /// Prints the current axes on the specified stream
-            template <typename Stream>
-            void Dump(Stream&& out) const;
+            static std::vector<raw::RawDigit> const* ReadProduct
+            (art::Event const& evt, art::InputTag label);
             
-        protected:
-            GridAxisClass wire_axis;
-            GridAxisClass tdc_axis;
-        }; // CellGridClass
+        }; // struct RawDigitCacheDataClass
+        
+        
+        std::vector<evd::details::RawDigitInfo_t>::const_iterator begin
+        (RawDigitCacheDataClass const& cache)
+        { return cache.Digits().cbegin(); }
+        std::vector<evd::details::RawDigitInfo_t>::const_iterator end
+        (RawDigitCacheDataClass const& cache)
+        { return cache.Digits().cend(); }
+        
         
         
         //--------------------------------------------------------------------------
@@ -528,26 +917,78 @@ namespace evd {
             {
                 if (adc < 0.) return 0.;
                 double const dQdX = adc / wirePitch / electronsToADC;
-                detinfo::DetectorProperties const* detp = lar::providerFrom<detinfo::DetectorPropertiesService>();
                 return detp->BirksCorrection(dQdX);
             } // Correct()
             double operator() (float adc) const { return Correct(adc); }
             
+            /// Reads the constants of the plane from the services (main thread)
             void update(geo::PlaneID const& pid)
             {
                 art::ServiceHandle<geo::Geometry const> geo;
                 wirePitch = geo->WirePitch(pid);
                 
-                detinfo::DetectorProperties const* detp = lar::providerFrom<detinfo::DetectorPropertiesService>();
+                detp = lar::providerFrom<detinfo::DetectorPropertiesService>();
                 electronsToADC = detp->ElectronsToADC();
             } // update()
             
         protected:
-            float wirePitch; ///< wire pitch
-            float electronsToADC; ///< conversion constant
+            /// provider of the correction
+            detinfo::DetectorProperties const* detp = nullptr;
+            float wirePitch = 1.F; ///< wire pitch
+            float electronsToADC = 1.F; ///< conversion constant
             
         }; // ADCCorrectorClass
         //--------------------------------------------------------------------------
+        /// Returns the pyramid settings for the current drawing options
+        PlanePyramidClass::Settings_t MakePyramidSettings(
+                                                          evd::RawDrawingOptions const& rawopt,
+                                                          double startTick, double nTicks,
+                                                          size_t maxSamples
+                                                          )
+        {
+            PlanePyramidClass::Settings_t settings;
+            settings.pedestalOption = rawopt.fPedestalOption;
+            settings.seeBadChannels = rawopt.fSeeBadChannels;
+            settings.minChannelStatus = rawopt.fMinChannelStatus;
+            settings.maxChannelStatus = rawopt.fMaxChannelStatus;
+            settings.startTick = size_t(startTick);
+            settings.endTick = std::min(maxSamples, size_t(startTick + nTicks));
+            return settings;
+        } // MakePyramidSettings()
+        
+        
+        //--------------------------------------------------------------------------
+        /**
+         * @brief Information from the services needed by operations on a plane
+         *
+         * The operations on the samples may run on other threads than the main
+         * one (see RawDataDrawer::PrepareRawDigit2D()), where services must not
+         * be used: everything they need is read in advance into this object.
+         */
+        struct PlaneSettings_t {
+            geo::PlaneID planeID; ///< the plane these settings are for
+            
+            /// Channels to be processed
+            ChannelConditionTable::Selection_t channelSelection;
+            
+            /// Settings of the charge pyramid of the plane
+            PlanePyramidClass::Settings_t pyramid;
+            
+            float RoIthreshold = 0.F; ///< smallest signal in region of interest
+            
+            unsigned int nWires = 0; ///< number of wires on the plane
+            
+            ADCCorrectorClass ADCcorrector; ///< charge conversion on the plane
+            
+            BoxDrawingSettings_t boxes; ///< settings for drawing the cells
+            
+            /// Colors of the ADC counts on the plane (owned by the service)
+            evdb::ColorScale const* colors = nullptr;
+            
+            /// Identifier of the configuration `colors` comes from
+            std::string colorsID;
+        }; // struct PlaneSettings_t
+        //--------------------------------------------------------------------------
     } // namespace details
 } // namespace evd
 
@@ -558,7 +999,7 @@ namespace evd {
     
     //......................................................................
     RawDataDrawer::RawDataDrawer()
-    : digit_cache(new details::RawDigitCacheDataClass)
+    : digit_cache(&details::RawDigitCacheDataClass::Shared(art::InputTag()))
     , fStartTick(0),fTicks(2048)
     , fCacheID(new details::CacheID_t)
     , fDrawingRange(new details::CellGridClass)
@@ -579,16 +1020,42 @@ namespace evd {
         fTimeMax.resize(nplanes,-1);
         fRawCharge.resize(nplanes,0);
         fConvertedCharge.resize(nplanes,0);
+        fNewRoI.resize(nplanes, false);
     }
     
     //......................................................................
     RawDataDrawer::~RawDataDrawer()
     {
-        delete digit_cache;
         delete fDrawingRange;
         delete fCacheID;
     }
     
+    //......................................................................
+    ColorRaster& RawDataDrawer::Raster(geo::PlaneID::PlaneID_t plane)
+    {
+        if (plane >= fRasters.size()) fRasters.resize(plane + 1);
+        if (!fRasters[plane]) {
+            fRasters[plane] = std::make_unique<ColorRaster>
+            ("RawDataDrawerRaster" + std::to_string(plane));
+        }
+        return *(fRasters[plane]);
+    } // RawDataDrawer::Raster()
+    
+    
+    //......................................................................
+    void RawDataDrawer::DrawRaster(unsigned int plane) const
+    {
+        if ((plane >= fRasters.size()) || !fRasters[plane]) return;
+        fRasters[plane]->Draw();
+    } // RawDataDrawer::DrawRaster()
+    
+    
+    //......................................................................
+    void RawDataDrawer::ClearRaster(unsigned int plane)
+    {
+        if ((plane < fRasters.size()) && fRasters[plane]) fRasters[plane]->Clear();
+    } // RawDataDrawer::ClearRaster()
+    
     
     //......................................................................
     void RawDataDrawer::SetDrawingLimits
@@ -628,8 +1095,10 @@ namespace evd {
     } // RawDataDrawer::SetDrawingLimitsFromRoI()
     
     
-    void RawDataDrawer::ExtractRange
-    (TVirtualPad* pPad, std::vector<double> const* zoom /* = nullptr */)
+    void RawDataDrawer::ExtractRange(
+        TVirtualPad* pPad, std::vector<double> const* zoom /* = nullptr */,
+        unsigned int coarseness /* = 1 */
+        )
     {
         mf::LogDebug log("RawDataDrawer");
         log << "ExtractRange() on pad '" << pPad->GetName() << "'";
@@ -639,8 +1108,12 @@ namespace evd {
             // these coordinates are used to find the actual extent of pad in pixels
             double low_wire = pFrame->GetX1(), high_wire = pFrame->GetX2();
             double low_tdc = pFrame->GetY1(), high_tdc = pFrame->GetY2();
-            double const wire_pixels = pPad->XtoAbsPixel(high_wire) - pPad->XtoAbsPixel(low_wire);
-            double const tdc_pixels = -(pPad->YtoAbsPixel(high_tdc) - pPad->YtoAbsPixel(low_tdc));
+            // a coarse drawing has fewer, larger cells, as if pixels were larger
+            double const pixel_size = std::max(coarseness, 1U);
+            double const wire_pixels = std::ceil(
+              (pPad->XtoAbsPixel(high_wire) - pPad->XtoAbsPixel(low_wire)) / pixel_size);
+            double const tdc_pixels = std::ceil(
+              -(pPad->YtoAbsPixel(high_tdc) - pPad->YtoAbsPixel(low_tdc)) / pixel_size);
             
             PadResolution.width = (unsigned int) wire_pixels;
             PadResolution.height = (unsigned int) tdc_pixels;
@@ -677,28 +1150,27 @@ namespace evd {
     
     
     //......................................................................
+    /**
+     * @brief Base of the operations run by RunOperation()
+     *
+     * The operations are not polymorphic: RunOperation() is a template and it
+     * calls the methods of the actual operation class, which can then be
+     * inlined in the loop over the samples.
+     * Derived classes need to define at least `Operate()`, and they can hide
+     * any of the other methods of this class.
+     */
     class RawDataDrawer::OperationBaseClass {
     public:
         OperationBaseClass
         (geo::PlaneID const& pid, RawDataDrawer* data_drawer = nullptr)
         : pRawDataDrawer(data_drawer), planeID(pid) {}
         
-        virtual ~OperationBaseClass() = default;
-        
-        virtual bool Initialize() { return true; }
+        bool Initialize() { return true; }
         
-        virtual bool ProcessWire(geo::WireID const&) { return true; }
-        virtual bool ProcessTick(size_t) { return true; }
+        bool ProcessWire(geo::WireID const&) { return true; }
+        bool ProcessTick(size_t) { return true; }
         
-        virtual bool Operate(geo::WireID const& wireID, size_t tick, float adc) = 0;
-        
-        virtual bool Finish() { return true; }
-        
-        virtual std::string Name() const
-        { return cet::demangle_symbol(typeid(*this).name()); }
-        
-        bool operator() (geo::WireID const& wireID, size_t tick, float adc)
-        { return Operate(wireID, tick, adc); }
+        bool Finish() { return true; }
         
         geo::PlaneID const& PlaneID() const { return planeID; }
         RawDataDrawer* RawDataDrawerPtr() const { return pRawDataDrawer; }
@@ -711,204 +1183,147 @@ namespace evd {
     }; // class RawDataDrawer::OperationBaseClass
     
     //......................................................................
-    class RawDataDrawer::ManyOperations: public RawDataDrawer::OperationBaseClass
+    /**
+     * @brief Runs many operations in the same pass on the samples
+     * @tparam Ops types of the operations
+     * @see details::FusedKernels
+     *
+     * The operations must all work on the same plane for the same drawer.
+     */
+    template <typename... Ops>
+    class RawDataDrawer::FusedOperations:
+    public RawDataDrawer::OperationBaseClass,
+    public details::FusedKernels<Ops...>
     {
-        std::vector<std::unique_ptr<RawDataDrawer::OperationBaseClass>> operations;
+        using Kernels_t = details::FusedKernels<Ops...>;
+        
     public:
         
-        ManyOperations
-        (geo::PlaneID const& pid, RawDataDrawer* data_drawer = nullptr):
-        OperationBaseClass(pid, data_drawer)
-        {}
+        FusedOperations(Ops&... ops)
+        : OperationBaseClass(FirstPlaneID(ops...), FirstDrawerPtr(ops...))
+        , Kernels_t(ops...)
+        { CheckOperations(ops...); }
         
-        virtual bool Initialize() override
-        {
-            bool bAllOk = true;
-            for (std::unique_ptr<OperationBaseClass> const& op: operations)
-                if (!op->Initialize()) bAllOk = false;
-            return bAllOk;
-        }
+        using Kernels_t::Initialize;
+        using Kernels_t::ProcessWire;
+        using Kernels_t::ProcessTick;
+        using Kernels_t::Operate;
+        using Kernels_t::Finish;
         
-        virtual bool ProcessWire(geo::WireID const& wireID) override
+        std::string Name() const
         {
-            for (std::unique_ptr<OperationBaseClass> const& op: operations)
-                if (op->ProcessWire(wireID)) return true;
-            return false;
-        }
-        virtual bool ProcessTick(size_t tick) override
-        {
-            for (std::unique_ptr<OperationBaseClass> const& op: operations)
-                if (op->ProcessTick(tick)) return true;
-            return false;
-        }
-        
-        virtual bool Operate
-        (geo::WireID const& wireID, size_t tick, float adc) override
-        {
-            for (std::unique_ptr<OperationBaseClass> const& op: operations)
-                if (!op->Operate(wireID, tick, adc)) return false;
-            return true;
+            std::string msg = "RawDataDrawer::FusedOperations [running "
+            + std::to_string(sizeof...(Ops)) + " operations:";
+            ((msg += " " + cet::demangle_symbol(typeid(Ops).name())), ...);
+            return msg + " ]";
         }
         
-        virtual bool Finish() override
-        {
-            bool bAllOk = true;
-            for (std::unique_ptr<OperationBaseClass> const& op: operations)
-                if (!op->Finish()) bAllOk = false;
-            return bAllOk;
-        }
+    private:
         
-        virtual std::string Name() const override
-        {
-            std::string msg = cet::demangle_symbol(typeid(*this).name());
-            msg +=
-            (" [running " + std::to_string(operations.size()) + " operations:");
-            for (auto const& op: operations) {// it's unique_ptr<OperationBaseClass>
-                if (op) msg += " " + op->Name();
-                else msg += " <invalid>";
-            }
-            return msg + " ]";
-        }
+        template <typename First, typename... Others>
+        static geo::PlaneID const& FirstPlaneID(First const& op, Others const&...)
+        { return op.PlaneID(); }
         
-        OperationBaseClass* Operator(size_t iOp)
-        { return operations.at(iOp).get(); }
-        OperationBaseClass const* Operator(size_t iOp) const
-        { return operations.at(iOp).get(); }
+        template <typename First, typename... Others>
+        static RawDataDrawer* FirstDrawerPtr(First const& op, Others const&...)
+        { return op.RawDataDrawerPtr(); }
         
-        void AddOperation(std::unique_ptr<OperationBaseClass> new_op)
+        void CheckOperations(Ops const&... ops) const
         {
-            if (!new_op) return;
-            if (PlaneID() != new_op->PlaneID()) {
+            if (((PlaneID() != ops.PlaneID()) || ...)) {
                 throw art::Exception(art::errors::LogicError)
-                << "RawDataDrawer::ManyOperations(): trying to run operations on "
-                << std::string(PlaneID()) << " and "
-                << std::string(new_op->PlaneID()) << " at the same time";
+                << "RawDataDrawer::FusedOperations(): trying to run operations on "
+                "different planes at the same time (first on "
+                << std::string(PlaneID()) << ")";
             }
-            if (RawDataDrawerPtr()
-                && (RawDataDrawerPtr() != new_op->RawDataDrawerPtr())
-                )
-            {
+            if (((RawDataDrawerPtr() != ops.RawDataDrawerPtr()) || ...)) {
                 throw art::Exception(art::errors::LogicError)
-                << "RawDataDrawer::ManyOperations(): "
+                << "RawDataDrawer::FusedOperations(): "
                 "trying to run operations on different RawDataDrawer"
                 ; // possible, but very unlikely
             }
-            operations.emplace_back(std::move(new_op));
-        }
+        } // CheckOperations()
         
-    }; // class RawDataDrawer::ManyOperations
+    }; // class RawDataDrawer::FusedOperations<>
     
     //......................................................................
-    bool RawDataDrawer::RunOperation
-    (art::Event const& evt, OperationBaseClass* operation)
+    template <typename Op>
+    bool RawDataDrawer::RunOperation(
+                                     art::Event const& evt, Op& operation,
+                                     details::PlaneSettings_t const& settings
+                                     )
     {
-        geo::PlaneID const& pid = operation->PlaneID();
-        art::ServiceHandle<evd::RawDrawingOptions const> rawopt;
+        geo::PlaneID const& pid = operation.PlaneID();
         
         if(digit_cache->empty()) return true;
         
         MF_LOG_DEBUG("RawDataDrawer") << "RawDataDrawer::RunOperation() running "
-        << operation->Name();
+        << OperationName(operation);
         
         // if we have an initialization failure, return false immediately;
         // but it's way better if the failure throws an exception
-        if (!operation->Initialize()) return false;
+        if (!operation.Initialize()) return false;
         
-        lariov::ChannelStatusProvider const& channelStatus
-        = art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
+        ChannelConditionTable const& channelConditions
+        = digit_cache->ChannelConditions();
+        ChannelConditionTable::Selection_t const& channelSelection
+        = settings.channelSelection;
         
-        //get pedestal conditions
-        const lariov::DetPedestalProvider& pedestalRetrievalAlg = *(lar::providerFrom<lariov::DetPedestalService>());
-        
-        geo::GeometryCore const& geom = *(lar::providerFrom<geo::Geometry>());
-        
-        // loop over all the channels/raw digits
-        for (evd::details::RawDigitInfo_t const& digit_info: *digit_cache) {
-            raw::RawDigit const& hit = digit_info.Digit();
-            raw::ChannelID_t const channel = hit.Channel();
+        // loop over all the wires of this plane which have raw digits
+        for (details::WireDigitInfo_t const& wire_digit: digit_cache->PlaneDigits(pid)) {
+            evd::details::RawDigitInfo_t const& digit_info = wire_digit.DigitInfo();
+            raw::ChannelID_t const channel = digit_info.Channel();
+            geo::WireID const& wireID = wire_digit.wireID;
             
             // skip the bad channels
-            if (!channelStatus.IsPresent(channel)) continue;
-            // The following test is meant to be temporary until the "correct" solution is implemented
-            if (!ProcessChannelWithStatus(channelStatus.Status(channel))) continue;
-            
-            // we have a list of all channels, but we are drawing only on one plane;
-            // most of the channels will not contribute to this plane,
-            // and before we start querying databases, unpacking data etc.
-            // we want to know it's for something
-            
-            std::vector<geo::WireID> WireIDs = geom.ChannelToWire(channel);
-            
-            bool bDrawChannel = false;
-            for (geo::WireID const& wireID: WireIDs){
-                if (wireID.planeID() != pid) continue; // not us!
-                bDrawChannel = true;
-                break;
-            } // for wires
-            if (!bDrawChannel) continue;
-            
-            // collect bad channels
-            bool const bGood = rawopt->fSeeBadChannels || !channelStatus.IsBad(channel);
+            // The status test is meant to be temporary until the "correct" solution is implemented
+            if (!channelConditions.isSelected(channel, channelSelection)) continue;
             
             // nothing else to be done if the channel is not good:
             // cells are marked bad by default and if any good channel falls in any of
             // them, they become good
-            if (!bGood) continue;
+            if (channelConditions.isHiddenBad(channel, channelSelection)) continue;
             
-            // at this point we know we have to process this channel
-            raw::RawDigit::ADCvector_t const& uncompressed = digit_info.Data();
+            // do we have anything to do with this wire?
+            if (!operation.ProcessWire(wireID)) continue;
             
-            // recover the pedestal
-            float  pedestal = 0;
-            if (rawopt->fPedestalOption == 0)
-            {
-                pedestal = pedestalRetrievalAlg.PedMean(channel);
-            }
-            else if (rawopt->fPedestalOption == 1)
-            {
-                pedestal = hit.GetPedestal();
-            }
-            else if (rawopt->fPedestalOption == 2)
-            {
-                pedestal = 0;
-            }
-            else
-            {
-                mf::LogWarning  ("RawDataDrawer") << " PedestalOption is not understood: " << rawopt->fPedestalOption << ".  Pedestals not subtracted.";
-            }
+            // at this point we know we have to process this channel;
+            // the samples come with the pedestal already (mostly) subtracted
+            details::ADCspan_t const& uncompressed = digit_info.Data();
+            float const pedestal = digit_info.PedestalResidual();
+            
+            // get an iterator over the adc values
+            // accumulate all the data of this wire in our "cells"
+            size_t const max_tick = std::min({
+                uncompressed.size(),
+                size_t(fStartTick + fTicks)
+            });
             
-            // loop over all the wires that are covered by this channel;
-            // without knowing better, we have to draw into all of them
-            for (geo::WireID const& wireID: WireIDs){
-                // check that the plane and tpc are the correct ones to draw
-                if (wireID.planeID() != pid) continue; // not us!
+            for (size_t iTick = fStartTick; iTick < max_tick; ++iTick) {
                 
                 // do we have anything to do with this wire?
-                if (!operation->ProcessWire(wireID)) continue;
+                if (!operation.ProcessTick(iTick)) continue;
                 
-                // get an iterator over the adc values
-                // accumulate all the data of this wire in our "cells"
-                size_t const max_tick = std::min({
-                    uncompressed.size(),
-                    size_t(fStartTick + fTicks)
-                });
+                float const adc = uncompressed[iTick] - pedestal;
+                //std::cout << "adc, pedestal: " << adc << " " << pedestal << std::endl;
                 
-                for (size_t iTick = fStartTick; iTick < max_tick; ++iTick) {
-                    
-                    // do we have anything to do with this wire?
-                    if (!operation->ProcessTick(iTick)) continue;
-                    
-                    float const adc = uncompressed[iTick] - pedestal;
-                    //std::cout << "adc, pedestal: " << adc << " " << pedestal << std::endl;
-                    
-                    if (!operation->Operate(wireID, iTick, adc)) return false;
-                    
-                } // if good
-            } // for wires
-        } // for channels
+                if (!operation.Operate(wireID, iTick, adc)) return false;
+                
+            } // for ticks
+        } // for wires
         
-        return operation->Finish();
-    } // ChannelLooper()
+        return operation.Finish();
+    } // RawDataDrawer::RunOperation()
+    
+    
+    //......................................................................
+    template <typename Op>
+    std::string RawDataDrawer::OperationName(Op const&)
+    { return cet::demangle_symbol(typeid(Op).name()); }
+    
+    template <typename... Ops>
+    std::string RawDataDrawer::OperationName(FusedOperations<Ops...> const& op)
+    { return op.Name(); }
     
     
     //......................................................................
@@ -918,58 +1333,49 @@ namespace evd {
         BoxDrawer(
                   geo::PlaneID const& pid,
                   RawDataDrawer* dataDrawer,
-                  evdb::View2D* new_view
+                  evdb::View2D* new_view,
+                  details::PlaneSettings_t const& plane_settings
                   )
         : OperationBaseClass(pid, dataDrawer)
         , view(new_view)
+        , settings(plane_settings)
         , rawCharge(0.), convertedCharge(0.)
-        , drawingRange(*(dataDrawer->fDrawingRange))
-        , ADCCorrector(PlaneID())
         {}
         
-        virtual bool Initialize() override
+        bool Initialize()
         {
-            art::ServiceHandle<evd::RawDrawingOptions const> rawopt;
-            
             // set up the size of the grid to be visualized;
             // the information on the size has to be already there:
             // caller should have user ExtractRange(), or similar, first.
-            // set the minimum cell in ticks to at least match fTicksPerPoint
-            drawingRange.SetMinTDCCellSize((float) rawopt->fTicksPerPoint);
-            // also set the minimum wire cell size to 1,
-            // otherwise there will be cells represented by no wire.
-            drawingRange.SetMinWireCellSize(1.F);
-            boxInfo.clear();
-            boxInfo.resize(drawingRange.NCells());
+            cells.Initialize
+            (*(RawDataDrawerPtr()->fDrawingRange), settings.boxes.minTickCellSize);
             return true;
         }
         
-        virtual bool ProcessWire(geo::WireID const& wire) override
-        { return drawingRange.hasWire((int) wire.Wire); }
+        bool ProcessWire(geo::WireID const& wire)
+        {
+            // the wire cell is the same for all the samples of this wire;
+            // Operate() only needs to find the tick cell
+            return cells.ProcessWire(wire.Wire);
+        }
         
-        virtual bool ProcessTick(size_t tick) override
-        { return drawingRange.hasTick((float) tick); }
+        bool ProcessTick(size_t tick)
+        { return cells.ProcessTick(tick); }
         
-        virtual bool Operate
-        (geo::WireID const& wireID, size_t tick, float adc) override
+        bool Operate
+        (geo::WireID const& /* wireID */, size_t tick, float adc)
         {
-            geo::WireID::WireID_t const wire = wireID.Wire;
-            std::ptrdiff_t cell = drawingRange.GetCell(wire, tick);
-            if (cell < 0) return true;
-            
-            BoxInfo_t& info = boxInfo[cell];
-            info.good = true; // if in range, we mark this cell as good
+            // other operations running together with this one may have
+            // asked for wires and ticks out of the drawing range
+            if (!cells.Add(tick, adc)) return true;
             
             rawCharge += adc;
-            convertedCharge += ADCCorrector(adc);
-            
-            // draw maximum digit in the cell
-            if (std::abs(info.adc) <= std::abs(adc)) info.adc = adc;
+            convertedCharge += settings.ADCcorrector(adc);
             
             return true;
         }
         
-        virtual bool Finish() override
+        bool Finish()
         {
             // write the information back
             geo::PlaneID::PlaneID_t const plane = PlaneID().Plane;
@@ -978,108 +1384,220 @@ namespace evd {
             
             // the cell size might have changed because of minimum size settings
             // from configuration (see Initialize())
-            *(RawDataDrawerPtr()->fDrawingRange) = drawingRange;
+            *(RawDataDrawerPtr()->fDrawingRange) = cells.Grid();
             
             // complete the drawing
-            RawDataDrawerPtr()->QueueDrawingBoxes(view, PlaneID(), boxInfo);
+            RawDataDrawerPtr()->QueueDrawingBoxes(view, settings, cells);
             
             return true;
         }
         
+        /**
+         * @brief Fills and draws the boxes from the charge pyramid of the plane
+         * @param pyramid the complete charge pyramid of the plane
+         * @return whether the pyramid had a level fine enough for this drawing
+         *
+         * Each cell of the chosen pyramid level is assigned to the box
+         * including its center. The cost is proportional to the number of boxes
+         * rather than to the number of samples.
+         * The charge sums come from the blocks of the pyramid, so their borders
+         * in ticks are as coarse as those blocks.
+         */
+        bool DrawFromPyramid(details::PlanePyramidClass& pyramid)
+        {
+            using ADC_t = details::PlanePyramidClass::ADC_t;
+            
+            if (!Initialize()) return false;
+            
+            details::GridAxisClass const& wireAxis = cells.Grid().WireAxis();
+            details::GridAxisClass const& tdcAxis = cells.Grid().TDCAxis();
+            
+            details::PlanePyramidClass::Level_t const* level
+            = pyramid.FindLevel(wireAxis.CellSize(), tdcAxis.CellSize());
+            if (!level) return false;
+            
+            MF_LOG_DEBUG("RawDataDrawer") << "Drawing " << std::string(PlaneID())
+            << " from pyramid level with cells of " << (1U << level->WireShift())
+            << " wires x " << (1U << level->TickShift()) << " ticks (pyramid uses "
+            << (pyramid.MemoryUsage() >> 20) << " MiB)";
+            
+            float const wireSize = float(1U << level->WireShift());
+            float const tickSize = float(1U << level->TickShift());
+            float const startTick = float(pyramid.StartTick());
+            
+            // range of pyramid cells overlapping the drawing range
+            size_t const firstWire = LevelCell(wireAxis.Min(), 0.F, wireSize);
+            size_t const endWire = std::min
+            (level->NWireCells(), LevelCell(wireAxis.Max(), 0.F, wireSize) + 1);
+            size_t const firstTick = LevelCell(tdcAxis.Min(), startTick, tickSize);
+            size_t const endTick = std::min
+            (level->NTickCells(), LevelCell(tdcAxis.Max(), startTick, tickSize) + 1);
+            
+            for (size_t iWire = firstWire; iWire < endWire; ++iWire) {
+                std::ptrdiff_t const iWireCell
+                = wireAxis.GetCell((float(iWire) + 0.5F) * wireSize);
+                if (!wireAxis.hasCell(iWireCell)) continue;
+                
+                details::BoxInfo_t* wireBoxes = cells.WireCells(iWireCell);
+                for (size_t iTick = firstTick; iTick < endTick; ++iTick) {
+                    ADC_t const adc = (*level)(iWire, iTick);
+                    if (adc == details::PlanePyramidClass::NoGoodADC) continue;
+                    
+                    std::ptrdiff_t const iTDCCell = tdcAxis.GetCell
+                    (startTick + (float(iTick) + 0.5F) * tickSize);
+                    if (!tdcAxis.hasCell(iTDCCell)) continue;
+                    
+                    details::BoxCellsClass::Merge(wireBoxes[iTDCCell], adc);
+                } // for ticks
+            } // for wires
+            
+            pyramid.SumCharge(
+                              wireAxis.Min(), wireAxis.Max(), tdcAxis.Min(), tdcAxis.Max(),
+                              rawCharge, convertedCharge
+                              );
+            
+            return Finish();
+        } // DrawFromPyramid()
+        
     private:
         evdb::View2D* view;
+        details::PlaneSettings_t settings; ///< settings for the plane
         
         double rawCharge = 0., convertedCharge = 0.;
-        details::CellGridClass drawingRange;
-        std::vector<BoxInfo_t> boxInfo;
-        details::ADCCorrectorClass ADCCorrector;
+        details::BoxCellsClass cells; ///< the cells to be drawn
+        
+        /// Index of the pyramid cell of given size containing coord
+        static size_t LevelCell(float coord, float offset, float cellSize)
+        { return (coord <= offset)? 0: size_t((coord - offset) / cellSize); }
+        
     }; // class RawDataDrawer::BoxDrawer
     
     
+    //......................................................................
+    /// Fills the charge pyramid of the plane with the processed samples
+    class RawDataDrawer::PyramidBuilderClass:
+    public RawDataDrawer::OperationBaseClass
+    {
+    public:
+        
+        PyramidBuilderClass(
+                            geo::PlaneID const& pid,
+                            RawDataDrawer* data_drawer,
+                            details::PlanePyramidClass& target,
+                            details::PlaneSettings_t const& plane_settings
+                            )
+        : OperationBaseClass(pid, data_drawer)
+        , pyramid(target)
+        , settings(plane_settings.pyramid)
+        , nWires(plane_settings.nWires)
+        , ADCCorrector(plane_settings.ADCcorrector)
+        {}
+        
+        bool Initialize()
+        {
+            pyramid.Init(settings, nWires);
+            return true;
+        }
+        
+        bool Operate
+        (geo::WireID const& wireID, size_t tick, float adc)
+        {
+            pyramid.Add(wireID.Wire, tick, adc, ADCCorrector(adc));
+            return true;
+        }
+        
+        bool Finish()
+        {
+            pyramid.Complete();
+            return true;
+        }
+        
+    private:
+        details::PlanePyramidClass& pyramid;
+        details::PlanePyramidClass::Settings_t settings;
+        unsigned int nWires; ///< number of wires on the plane
+        details::ADCCorrectorClass ADCCorrector;
+    }; // class RawDataDrawer::PyramidBuilderClass
+    
+    
     void RawDataDrawer::QueueDrawingBoxes(
                                           evdb::View2D* view,
-                                          geo::PlaneID const& pid,
-                                          std::vector<BoxInfo_t> const& BoxInfo
+                                          details::PlaneSettings_t const& settings,
+                                          details::BoxCellsClass const& cells
                                           )
     {
         //
-        // All the information is now collected in BoxInfo.
+        // All the information is now collected in the cells.
         // Make boxes out of it.
         //
-        evd::RawDrawingOptions const& rawopt
-        = *art::ServiceHandle<evd::RawDrawingOptions const>();
+        std::vector<details::BoxInfo_t> const& BoxInfo = cells.Cells();
+        details::CellGridClass const& grid = cells.Grid();
+        details::BoxDrawingSettings_t const& boxopt = settings.boxes;
         
         MF_LOG_DEBUG("RawDataDrawer")
         << "Filling " << BoxInfo.size() << " boxes to be rendered";
         
-        // drawing options:
-        float const MinSignal = rawopt.fMinSignal;
-        bool const bScaleDigitsByCharge = rawopt.fScaleDigitsByCharge;
-        
-        art::ServiceHandle<evd::ColorDrawingOptions const> cst;
+        // box color, proportional to the ADC count
+        evdb::ColorScale const& ColorSet = *(settings.colors);
+        auto const color = [&ColorSet](int adc){ return ColorSet.GetColor(adc); };
         
-        geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
-        geo::SigType_t const sigType = geom.SignalType(pid);
-        evdb::ColorScale const& ColorSet = cst->RawQ(sigType);
-        size_t const nBoxes = BoxInfo.size();
         unsigned int nDrawnBoxes = 0;
-        for (size_t iBox = 0; iBox < nBoxes; ++iBox) {
-            BoxInfo_t const& info = BoxInfo[iBox];
-            
-            // too little signal, don't bother drawing
-            if(info.good && (std::abs(info.adc) < MinSignal)) continue;
-            
-            // skip the bad cells
-            if (!info.good) continue;
-            
-            // box color, proportional to the ADC count
-            int const color = ColorSet.GetColor(info.adc);
-            
-            // scale factor, proportional to ADC count (optional)
-            constexpr float q0 = 1000.;
-            float const sf = bScaleDigitsByCharge
-            ? std::min(std::sqrt((float) info.adc / q0), 1.0F)
-            : 1.;
-            
-            // coordinates of the cell box
-            float min_wire, max_wire, min_tick, max_tick;
-            std::tie(min_wire, min_tick, max_wire, max_tick)
-            = fDrawingRange->GetCellBox(iBox);
-            /*
-             MF_LOG_TRACE("RawDataDrawer")
-             << "Wires ( " << min_wire << " - " << max_wire << " ) ticks ("
-             << min_tick << " - " << max_tick << " ) for cell " << iBox;
-             */
-            if (sf != 1.) { // need to shrink the box
-                float const nsf = 1. - sf; // negation of scale factor
-                float const half_box_wires = (max_wire - min_wire) / 2.,
-                half_box_ticks = (max_tick - min_tick) / 2.;
-                
-                // shrink the box:
-                min_wire += nsf * half_box_wires;
-                max_wire -= nsf * half_box_wires;
-                min_tick += nsf * half_box_ticks;
-                max_tick -= nsf * half_box_ticks;
-            } // if scaling
-            
-            // allocate the box on the view;
-            // the order of the coordinates depends on the orientation
-            TBox* pBox;
-            if (rawopt.fAxisOrientation < 1)
-                pBox = &(view->AddBox(min_wire, min_tick, max_wire, max_tick));
-            else
-                pBox = &(view->AddBox(min_tick, min_wire, max_tick, max_wire));
-            
-            pBox->SetFillStyle(1001);
-            pBox->SetFillColor(color);
-            pBox->SetBit(kCannotPick);
+        if (boxopt.raster) {
+            // with the raster backend, the cells of the grid become the raster bins
+            ColorRaster& raster = Raster(settings.planeID.Plane);
+            raster.UsePalette(settings.colorsID);
+            details::GridAxisClass const& wireAxis = grid.WireAxis();
+            details::GridAxisClass const& tdcAxis = grid.TDCAxis();
+            size_t const nTDCCells = tdcAxis.NCells();
+            bool const bSwapAxes = boxopt.swapAxes;
+            if (bSwapAxes) {
+                raster.Reset(
+                  nTDCCells, tdcAxis.Min(), tdcAxis.Max(),
+                  wireAxis.NCells(), wireAxis.Min(), wireAxis.Max()
+                  );
+            }
+            else {
+                raster.Reset(
+                  wireAxis.NCells(), wireAxis.Min(), wireAxis.Max(),
+                  nTDCCells, tdcAxis.Min(), tdcAxis.Max()
+                  );
+            }
             
-            ++nDrawnBoxes;
-        } // for (iBox)
+            nDrawnBoxes = details::DrawCells(BoxInfo, boxopt.minSignal, color,
+              [&raster, nTDCCells, bSwapAxes](size_t iBox, int boxColor)
+              {
+                unsigned int const iWireCell = iBox / nTDCCells;
+                unsigned int const iTDCCell = iBox % nTDCCells;
+                if (bSwapAxes) raster.PaintCell(iTDCCell, iWireCell, boxColor);
+                else           raster.PaintCell(iWireCell, iTDCCell, boxColor);
+              });
+        }
+        else {
+            nDrawnBoxes = details::DrawCells(BoxInfo, boxopt.minSignal, color,
+              [view, &grid, &BoxInfo, &boxopt](size_t iBox, int boxColor)
+              {
+                // coordinates of the cell box (scaled with the charge if asked)
+                float min_wire, max_wire, min_tick, max_tick;
+                std::tie(min_wire, min_tick, max_wire, max_tick) = details::CellBox
+                  (grid, iBox, BoxInfo[iBox].adc, boxopt.scaleByCharge);
+                
+                // allocate the box on the view;
+                // the order of the coordinates depends on the orientation
+                TBox* pBox;
+                if (!boxopt.swapAxes)
+                    pBox = &(view->AddBox(min_wire, min_tick, max_wire, max_tick));
+                else
+                    pBox = &(view->AddBox(min_tick, min_wire, max_tick, max_wire));
+                
+                pBox->SetFillStyle(1001);
+                pBox->SetFillColor(boxColor);
+                pBox->SetBit(kCannotPick);
+              });
+        }
         
         MF_LOG_DEBUG("RawDataDrawer")
         << "Sent " << nDrawnBoxes << "/" << BoxInfo.size()
-        << " boxes to be rendered";
+        << (boxopt.raster? " raster cells": " boxes") << " to be rendered";
     } // RawDataDrawer::QueueDrawingBoxes()
     
     
@@ -1092,8 +1610,9 @@ namespace evd {
         if (rawopt->fDrawRawDataOrCalibWires == 1) return;
         
         geo::PlaneID const pid(rawopt->CurrentTPC(), plane);
-        BoxDrawer drawer(pid, this, view);
-        if (!RunOperation(evt, &drawer)) {
+        details::PlaneSettings_t const settings = MakePlaneSettings(pid);
+        BoxDrawer drawer(pid, this, view, settings);
+        if (!RunOperation(evt, drawer, settings)) {
             throw art::Exception(art::errors::Unknown)
             << "RawDataDrawer::RunDrawOperation(): "
             "somewhere something went somehow wrong";
@@ -1108,24 +1627,22 @@ namespace evd {
     {
     public:
         
-        float const RoIthreshold;
-        
-        RoIextractorClass(geo::PlaneID const& pid, RawDataDrawer* data_drawer)
+        RoIextractorClass(
+                          geo::PlaneID const& pid, RawDataDrawer* data_drawer,
+                          float threshold
+                          )
         : OperationBaseClass(pid, data_drawer)
-        , RoIthreshold
-        (art::ServiceHandle<evd::RawDrawingOptions const>()->RoIthreshold(PlaneID()))
+        , range(threshold)
         {}
         
-        virtual bool Operate
-        (geo::WireID const& wireID, size_t tick, float adc) override
+        bool Operate
+        (geo::WireID const& wireID, size_t tick, float adc)
         {
-            if (std::abs(adc) < RoIthreshold) return true;
-            WireRange.add(wireID.Wire);
-            TDCrange.add(tick);
+            range.Add(wireID.Wire, tick, adc);
             return true;
         } // Operate()
         
-        virtual bool Finish() override
+        bool Finish()
         {
             geo::PlaneID::PlaneID_t const plane = PlaneID().Plane;
             int& WireMin = pRawDataDrawer->fWireMin[plane];
@@ -1133,27 +1650,23 @@ namespace evd {
             int& TimeMin = pRawDataDrawer->fTimeMin[plane];
             int& TimeMax = pRawDataDrawer->fTimeMax[plane];
             
-            if ((WireMin == WireMax) && WireRange.has_data()) {
-                geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
-                mf::LogInfo("RawDataDrawer") << "Region of interest for "
-                << std::string(PlaneID()) << " detected to be within wires "
-                << WireRange.min() << " to " << WireRange.max()
-                << " (plane has " << geom.Nwires(PlaneID()) << " wires)";
-                WireMax = WireRange.max() + 1;
-                WireMin = WireRange.min();
+            // this may run on a worker thread: the news are reported later,
+            // by ReportRegionOfInterest()
+            if ((WireMin == WireMax) && range.hasData()) {
+                WireMax = range.WireMax() + 1;
+                WireMin = range.WireMin();
+                pRawDataDrawer->fNewRoI[plane] = true;
             }
-            if ((TimeMin == TimeMax) && TDCrange.has_data()) {
-                mf::LogInfo("RawDataDrawer") << "Region of interest for "
-                << std::string(PlaneID()) << " detected to be within ticks "
-                << TDCrange.min() << " to " << TDCrange.max();
-                TimeMax = TDCrange.max() + 1;
-                TimeMin = TDCrange.min();
+            if ((TimeMin == TimeMax) && range.hasData()) {
+                TimeMax = range.TickMax() + 1;
+                TimeMin = range.TickMin();
+                pRawDataDrawer->fNewRoI[plane] = true;
             }
             return true;
         } // Finish()
         
     private:
-        lar::util::MinMaxCollector<float> WireRange, TDCrange;
+        details::RoIRangeClass range; ///< range of the samples above threshold
     }; // class RawDataDrawer::RoIextractorClass
     
     
@@ -1170,11 +1683,13 @@ namespace evd {
         
         if (!bExtractRoI) return;
         
-        RoIextractorClass Extractor(pid, this);
-        if (!RunOperation(evt, &Extractor)) {
+        details::PlaneSettings_t const settings = MakePlaneSettings(pid);
+        RoIextractorClass Extractor(pid, this, settings.RoIthreshold);
+        if (!RunOperation(evt, Extractor, settings)) {
             throw std::runtime_error
             ("RawDataDrawer::RunRoIextractor(): somewhere something went somehow wrong");
         }
+        ReportRegionOfInterest(pid);
         
     } // RawDataDrawer::RunRoIextractor()
     
@@ -1187,7 +1702,9 @@ namespace evd {
     {
         
         art::ServiceHandle<evd::RawDrawingOptions const> rawopt;
-        geo::PlaneID const pid(rawopt->CurrentTPC(), plane);
+        
+        // forget the previous raster, whether we are going to draw or not
+        ClearRaster(plane);
         
         bool const bDraw = (rawopt->fDrawRawDataOrCalibWires != 1);
         // if we don't need to draw, don't bother doing anything;
@@ -1195,73 +1712,85 @@ namespace evd {
         // (ok, now it's private, but it could be exposed)
         if (!bDraw) return;
         
-        art::ServiceHandle<geo::Geometry const> geom;
-
-        // Need to loop over the labels, but we don't want to zap existing cached RawDigits that are valid
-        // So... do the painful search to make sure the RawDigits we recover at those we are searching for.
-        bool theDroidIAmLookingFor = false;
+        if (!LoadRawDigits(evt, plane)) return;
         
-        // Loop over labels
-        for(const auto& rawDataLabel : rawopt->fRawDataLabels)
-        {
-            // make sure we reset what needs to be reset
-            // before the operations are initialized;
-            // we call for reading raw digits; they will be cached, so it's not a waste
-            details::CacheID_t NewCacheID(evt, rawDataLabel, pid);
-            GetRawDigits(evt, NewCacheID);
+        DrawRawDigit2D(evt, view, *fPlaneSettings, bZoomToRoI);
         
-            // Painful check to see if these RawDigits contain the droids we are looking for
-            for(const auto& rawDigit : digit_cache->Digits())
-            {
-                std::vector<geo::WireID> WireIDs = geom->ChannelToWire(rawDigit.Channel());
-                
-                for (geo::WireID const& wireID: WireIDs)
-                {
-                    if (wireID.planeID() != pid) continue; // not us!
-                    theDroidIAmLookingFor = true;
-                    break;
-                } // for wires
-                
-                if (theDroidIAmLookingFor) break;
-            }
+        // the region of interest may have been found while drawing,
+        // or before by PrepareRawDigit2D()
+        ReportRegionOfInterest(fPlaneSettings->planeID);
         
-            if (theDroidIAmLookingFor) break;
-        }
+    } // RawDataDrawer::RawDigit2D()
+    
+    
+    //......................................................................
+    void RawDataDrawer::DrawRawDigit2D(
+                                       art::Event const& evt, evdb::View2D* view,
+                                       details::PlaneSettings_t const& settings,
+                                       bool bZoomToRoI
+                                       )
+    {
+        geo::PlaneID const& pid = settings.planeID;
+        geo::PlaneID::PlaneID_t const plane = pid.Plane;
         
-        if (!theDroidIAmLookingFor) return;
-
         bool const hasRoI = hasRegionOfInterest(plane);
         
+        // the charge pyramid of the plane is filled by the first complete pass
+        // on the samples, and it is then used to draw all the following times
+        details::PlanePyramidClass& pyramid = digit_cache->Pyramid(pid);
+        details::PlanePyramidClass::Settings_t const& pyramidSettings
+        = settings.pyramid;
+        bool const hasPyramid = pyramid.isValid(pyramidSettings);
+        
         // - if we don't have a RoI yet, we want to get it while we draw
         //   * if we are zooming into it now, we have to extract it first, then draw
         //   * if we are not zooming, we can do both at the same time
         // - if we have a RoI, we don't want to extract it again
+        // - if we don't have a pyramid yet, we build it in the first pass
+        // - if we have a pyramid, we draw from it (when its resolution is enough)
         if (!bZoomToRoI) { // we are not required to zoom to the RoI
             
-            std::unique_ptr<OperationBaseClass> operation;
+            if (hasRoI && hasPyramid) {
+                MF_LOG_DEBUG("RawDataDrawer")
+                << __func__ << "() trying to draw from the charge pyramid";
+                BoxDrawer drawer(pid, this, view, settings);
+                if (drawer.DrawFromPyramid(pyramid)) return;
+            }
             
-            // we will do the drawing in one pass
+            // we will do the drawing in one pass;
+            // since it's cheap, we also get RoI and pyramid now if we need them
             MF_LOG_DEBUG("RawDataDrawer")
-            << __func__ << "() setting up one-pass drawing";
-            operation.reset(new BoxDrawer(pid, this, view));
-            
-            if (!hasRoI) { // we don't have any RoI; since it's cheap, let's get it
-                MF_LOG_DEBUG("RawDataDrawer") << __func__ << "() adding RoI extraction";
-                
-                // swap cards: operation becomes a multiple operation:
-                // - prepare the two operations (one is there already, somehow)
-                std::unique_ptr<OperationBaseClass> drawer(std::move(operation));
-                std::unique_ptr<OperationBaseClass> extractor
-                (new RoIextractorClass(pid, this));
-                // - create a new composite operation and give it the sub-ops
-                operation.reset(new ManyOperations(pid, this));
-                ManyOperations* pManyOps
-                = static_cast<ManyOperations*>(operation.get());
-                pManyOps->AddOperation(std::move(drawer));
-                pManyOps->AddOperation(std::move(extractor));
+            << __func__ << "() setting up one-pass drawing"
+            << (hasRoI? "": " with RoI extraction")
+            << (hasPyramid? "": " with pyramid filling");
+            BoxDrawer drawer(pid, this, view, settings);
+            bool bSuccess = false;
+            if (hasRoI) {
+                if (hasPyramid) bSuccess = RunOperation(evt, drawer, settings);
+                else {
+                    PyramidBuilderClass builder(pid, this, pyramid, settings);
+                    FusedOperations<BoxDrawer, PyramidBuilderClass> operation
+                    (drawer, builder);
+                    bSuccess = RunOperation(evt, operation, settings);
+                }
+            }
+            else {
+                RoIextractorClass extractor(pid, this, settings.RoIthreshold);
+                if (hasPyramid) {
+                    FusedOperations<BoxDrawer, RoIextractorClass> operation
+                    (drawer, extractor);
+                    bSuccess = RunOperation(evt, operation, settings);
+                }
+                else {
+                    PyramidBuilderClass builder(pid, this, pyramid, settings);
+                    FusedOperations
+                    <BoxDrawer, RoIextractorClass, PyramidBuilderClass> operation
+                    (drawer, extractor, builder);
+                    bSuccess = RunOperation(evt, operation, settings);
+                }
             }
             
-            if (!RunOperation(evt, operation.get())) {
+            if (!bSuccess) {
                 throw art::Exception(art::errors::Unknown)
                 << "RawDataDrawer::RunDrawOperation(): "
                 "somewhere something went somehow wrong";
@@ -1272,8 +1801,16 @@ namespace evd {
             if (!hasRoI) {
                 MF_LOG_DEBUG("RawDataDrawer") << __func__
                 << "() setting up RoI extraction for " << pid;
-                RoIextractorClass extractor(pid, this);
-                if (!RunOperation(evt, &extractor)) {
+                RoIextractorClass extractor(pid, this, settings.RoIthreshold);
+                bool bSuccess = false;
+                if (hasPyramid) bSuccess = RunOperation(evt, extractor, settings);
+                else {
+                    PyramidBuilderClass builder(pid, this, pyramid, settings);
+                    FusedOperations<RoIextractorClass, PyramidBuilderClass> operation
+                    (extractor, builder);
+                    bSuccess = RunOperation(evt, operation, settings);
+                }
+                if (!bSuccess) {
                     throw art::Exception(art::errors::Unknown)
                     << "RawDataDrawer::RunDrawOperation():"
                     " something went somehow wrong while extracting RoI";
@@ -1292,14 +1829,112 @@ namespace evd {
             
             // then we draw
             MF_LOG_DEBUG("RawDataDrawer") << __func__ << "() setting up drawing";
-            BoxDrawer drawer(pid, this, view);
-            if (!RunOperation(evt, &drawer)) {
+            if (pyramid.isValid(pyramidSettings)) {
+                BoxDrawer drawer(pid, this, view, settings);
+                if (drawer.DrawFromPyramid(pyramid)) return;
+            }
+            BoxDrawer drawer(pid, this, view, settings);
+            bool bSuccess = false;
+            if (pyramid.isValid(pyramidSettings)) bSuccess = RunOperation(evt, drawer, settings);
+            else {
+                PyramidBuilderClass builder(pid, this, pyramid, settings);
+                FusedOperations<BoxDrawer, PyramidBuilderClass> operation
+                (drawer, builder);
+                bSuccess = RunOperation(evt, operation, settings);
+            }
+            if (!bSuccess) {
                 throw art::Exception(art::errors::Unknown)
                 << "RawDataDrawer::RunDrawOperation():"
                 " something went somehow wrong while drawing";
             }
         }
-    } // RawDataDrawer::RawDigit2D()
+    } // RawDataDrawer::DrawRawDigit2D()
+    
+    
+    //......................................................................
+    bool RawDataDrawer::LoadRawDigits(art::Event const& evt, unsigned int plane)
+    {
+        art::ServiceHandle<evd::RawDrawingOptions const> rawopt;
+        geo::PlaneID const pid(rawopt->CurrentTPC(), plane);
+        
+        // Need to loop over the labels, but we don't want to zap existing cached RawDigits that are valid
+        // So... check that the RawDigits we recover are the ones we are searching for.
+        bool theDroidIAmLookingFor = false;
+        
+        // Loop over labels
+        for(const auto& rawDataLabel : rawopt->fRawDataLabels)
+        {
+            // make sure we reset what needs to be reset
+            // before the operations are initialized;
+            // we call for reading raw digits; they will be cached, so it's not a waste
+            details::CacheID_t NewCacheID(evt, rawDataLabel, pid);
+            GetRawDigits(evt, NewCacheID);
+        
+            // check whether these RawDigits contain the droids we are looking for
+            theDroidIAmLookingFor = digit_cache->hasPlane(pid);
+        
+            if (theDroidIAmLookingFor) break;
+        }
+        
+        if (!theDroidIAmLookingFor) return false;
+        
+        // the pyramid is created here, since PrepareRawDigit2D() may run
+        // concurrently for other planes, which share the same cache
+        digit_cache->Pyramid(pid);
+        
+        // PrepareRawDigit2D() may run on a worker thread, where services are off
+        // limits: what it needs from them is read now
+        fPlaneSettings
+        = std::make_unique<details::PlaneSettings_t>(MakePlaneSettings(pid));
+        
+        // this plane is ready; the others are prepared while the user looks at it
+        if (rawopt->fPrefetchTPCs) digit_cache->PrefetchPlanes();
+        
+        return true;
+    } // RawDataDrawer::LoadRawDigits()
+    
+    
+    //......................................................................
+    void RawDataDrawer::PrepareRawDigit2D(art::Event const& evt, unsigned int plane)
+    {
+        // LoadRawDigits() should have been called already for this plane
+        if (!fPlaneSettings || (fPlaneSettings->planeID.Plane != plane)) return;
+        details::PlaneSettings_t const& settings = *fPlaneSettings;
+        geo::PlaneID const& pid = settings.planeID;
+        
+        if (!digit_cache->hasPlane(pid)) return;
+        
+        bool const hasRoI = hasRegionOfInterest(plane);
+        details::PlanePyramidClass* pPyramid = digit_cache->FindPyramid(pid);
+        if (!pPyramid) return; // LoadRawDigits() creates it
+        details::PlanePyramidClass& pyramid = *pPyramid;
+        bool const hasPyramid = pyramid.isValid(settings.pyramid);
+        
+        MF_LOG_DEBUG("RawDataDrawer") << __func__ << "() on " << pid
+        << (hasRoI? "": " with RoI extraction")
+        << (hasPyramid? "": " with pyramid filling");
+        
+        bool bSuccess = true;
+        if (!hasRoI) {
+            RoIextractorClass extractor(pid, this, settings.RoIthreshold);
+            if (hasPyramid) bSuccess = RunOperation(evt, extractor, settings);
+            else {
+                PyramidBuilderClass builder(pid, this, pyramid, settings);
+                FusedOperations<RoIextractorClass, PyramidBuilderClass> operation
+                (extractor, builder);
+                bSuccess = RunOperation(evt, operation, settings);
+            }
+        }
+        else if (!hasPyramid) {
+            PyramidBuilderClass builder(pid, this, pyramid, settings);
+            bSuccess = RunOperation(evt, builder, settings);
+        }
+        if (!bSuccess) {
+            throw art::Exception(art::errors::Unknown)
+            << "RawDataDrawer::PrepareRawDigit2D():"
+            " something went somehow wrong while preparing " << std::string(pid);
+        }
+    } // RawDataDrawer::PrepareRawDigit2D()
     
     
     //........................................................................
@@ -1337,6 +1972,12 @@ namespace evd {
         
     }
     
+    //......................................................................
+    void RawDataDrawer::CancelBackgroundWork()
+    {
+        details::RawDigitCacheDataClass::CancelAllPrefetches();
+    } // RawDataDrawer::CancelBackgroundWork()
+    
     //......................................................................
     void RawDataDrawer::FillQHisto(const art::Event& evt,
                                    unsigned int      plane,
@@ -1347,8 +1988,6 @@ namespace evd {
         art::ServiceHandle<evd::RawDrawingOptions const> rawopt;
         if (rawopt->fDrawRawDataOrCalibWires==1) return;
         
-        art::ServiceHandle<geo::Geometry const> geo;
-        
         geo::PlaneID const pid(rawopt->CurrentTPC(), plane);
         
         for(const auto& rawDataLabel : rawopt->fRawDataLabels)
@@ -1356,58 +1995,35 @@ namespace evd {
             details::CacheID_t NewCacheID(evt, rawDataLabel, pid);
             GetRawDigits(evt, NewCacheID);
             
-            lariov::ChannelStatusProvider const& channelStatus
-            = art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
-            
-            //get pedestal conditions
-            const lariov::DetPedestalProvider& pedestalRetrievalAlg = art::ServiceHandle<lariov::DetPedestalService const>()->GetPedestalProvider();
+            ChannelConditionTable const& channelConditions
+            = digit_cache->ChannelConditions();
+            ChannelConditionTable::Selection_t const channelSelection(*rawopt);
             
-            for (evd::details::RawDigitInfo_t const& digit_info: *digit_cache) {
-                raw::RawDigit const& hit = digit_info.Digit();
-                raw::ChannelID_t const channel = hit.Channel();
+            evd::details::RawDigitInfo_t const* pLastDigit = nullptr;
+            for (details::WireDigitInfo_t const& wire_digit: digit_cache->PlaneDigits(pid)) {
+                evd::details::RawDigitInfo_t const& digit_info = wire_digit.DigitInfo();
                 
-                if (!channelStatus.IsPresent(channel)) continue;
+                // this channel was already on this plane; don't double count
+                // the raw signal if there are more than one wids for the channel
+                if (&digit_info == pLastDigit) continue;
+                pLastDigit = &digit_info;
                 
-                // The following test is meant to be temporary until the "correct" solution is implemented
-                if (!ProcessChannelWithStatus(channelStatus.Status(channel))) continue;
+                raw::ChannelID_t const channel = digit_info.Channel();
+                
+                // The status test is meant to be temporary until the "correct" solution is implemented
+                if (!channelConditions.isSelected(channel, channelSelection)) continue;
                 
                 // to be explicit: we don't cound bad channels in
-                if (!rawopt->fSeeBadChannels && channelStatus.IsBad(channel)) continue;
+                if (channelConditions.isHiddenBad(channel, channelSelection)) continue;
+                
+                details::ADCspan_t const& uncompressed = digit_info.Data();
+                
+                // the pedestal is mostly subtracted already
+                float const pedestal = digit_info.PedestalResidual();
+                
+                for(short d: uncompressed)
+                    histo->Fill(float(d) - pedestal); //pedestals[plane]); //hit.GetPedestal());
                 
-                std::vector<geo::WireID> wireids = geo->ChannelToWire(channel);
-                for(auto const& wid : wireids){
-                    // check that the plane and tpc are the correct ones to draw
-                    if (wid.planeID() != pid) continue;
-                    
-                    raw::RawDigit::ADCvector_t const& uncompressed = digit_info.Data();
-                    
-                    //float const pedestal = pedestalRetrievalAlg.PedMean(channel);
-                    // recover the pedestal
-                    float  pedestal = 0;
-                    if (rawopt->fPedestalOption == 0)
-                    {
-                        pedestal = pedestalRetrievalAlg.PedMean(channel);
-                    }
-                    else if (rawopt->fPedestalOption == 1)
-                    {
-                        pedestal = hit.GetPedestal();
-                    }
-                    else if (rawopt->fPedestalOption == 2)
-                    {
-                        pedestal = 0;
-                    }
-                    else
-                    {
-                        mf::LogWarning  ("RawDataDrawer") << " PedestalOption is not understood: " << rawopt->fPedestalOption << ".  Pedestals not subtracted.";
-                    }
-                    
-                    for(short d: uncompressed)
-                        histo->Fill(float(d) - pedestal); //pedestals[plane]); //hit.GetPedestal());
-                    
-                    // this channel is on the correct plane, don't double count the raw signal
-                    // if there are more than one wids for the channel
-                    break;
-                }// end loop over wids
             }//end loop over raw hits
         } //end loop over labels
         
@@ -1447,20 +2063,16 @@ namespace evd {
             } // if no channel
             
             // check the channel status; bad channels are still ok.
-            lariov::ChannelStatusProvider const& channelStatus
-            = art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
+            ChannelConditionTable const& channelConditions
+            = digit_cache->ChannelConditions();
+            ChannelConditionTable::Selection_t const channelSelection(*rawopt);
             
-            if (!channelStatus.IsPresent(channel)) return;
-            
-            // The following test is meant to be temporary until the "correct" solution is implemented
-            if (!ProcessChannelWithStatus(channelStatus.Status(channel))) return;
+            // The status test is meant to be temporary until the "correct" solution is implemented
+            if (!channelConditions.isSelected(channel, channelSelection)) return;
             
             
             // we accept to see the content of a bad channel, so this is commented out:
-            if (!rawopt->fSeeBadChannels && channelStatus.IsBad(channel)) return;
-            
-            //get pedestal conditions
-            const lariov::DetPedestalProvider& pedestalRetrievalAlg = art::ServiceHandle<lariov::DetPedestalService const>()->GetPedestalProvider();
+            if (channelConditions.isHiddenBad(channel, channelSelection)) return;
             
             // find the raw digit
             // (iDigit is an iterator to a evd::details::RawDigitInfo_t)
@@ -1473,27 +2085,10 @@ namespace evd {
                 continue;
             }
             
-            raw::RawDigit::ADCvector_t const& uncompressed = pDigit->Data();
+            details::ADCspan_t const& uncompressed = pDigit->Data();
             
-            
-            // recover the pedestal
-            float  pedestal = 0;
-            if (rawopt->fPedestalOption == 0)
-            {
-                pedestal = pedestalRetrievalAlg.PedMean(channel);
-            }
-            else if (rawopt->fPedestalOption == 1)
-            {
-                pedestal = pDigit->DigitPtr()->GetPedestal();
-            }
-            else if (rawopt->fPedestalOption == 2)
-            {
-                pedestal = 0;
-            }
-            else
-            {
-                mf::LogWarning  ("RawDataDrawer") << " PedestalOption is not understood: " << rawopt->fPedestalOption << ".  Pedestals not subtracted.";
-            }
+            // the pedestal is mostly subtracted already
+            float const pedestal = pDigit->PedestalResidual();
             
             for(size_t j = 0; j < uncompressed.size(); ++j)
                 histo->Fill(float(j), float(uncompressed[j]) - pedestal); //pedestals[plane]); //hit.GetPedestal());
@@ -1609,10 +2204,57 @@ namespace evd {
         std::fill(fWireMax.begin(), fWireMax.end(), -1);
         std::fill(fTimeMin.begin(), fTimeMin.end(), -1);
         std::fill(fTimeMax.begin(), fTimeMax.end(), -1);
+        std::fill(fNewRoI.begin(), fNewRoI.end(), false);
         
     } // RawDataDrawer::ResetRegionOfInterest()
     
     
+    //......................................................................
+    details::PlaneSettings_t RawDataDrawer::MakePlaneSettings
+    (geo::PlaneID const& pid) const
+    {
+        evd::RawDrawingOptions const& rawopt
+        = *art::ServiceHandle<evd::RawDrawingOptions const>();
+        geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
+        
+        details::PlaneSettings_t settings;
+        settings.planeID = pid;
+        settings.channelSelection = ChannelConditionTable::Selection_t(rawopt);
+        settings.pyramid = details::MakePyramidSettings
+        (rawopt, fStartTick, fTicks, digit_cache->MaxSamples());
+        settings.RoIthreshold = rawopt.RoIthreshold(pid);
+        settings.nWires = geom.Nwires(pid);
+        settings.ADCcorrector.update(pid);
+        
+        settings.boxes.minTickCellSize = (float) rawopt.fTicksPerPoint;
+        settings.boxes.minSignal = rawopt.fMinSignal;
+        settings.boxes.scaleByCharge = rawopt.fScaleDigitsByCharge;
+        settings.boxes.swapAxes = (rawopt.fAxisOrientation >= 1);
+        settings.boxes.raster = (rawopt.fDrawingBackend == 1);
+        art::ServiceHandle<evd::ColorDrawingOptions const> cst;
+        settings.colors = &(cst->RawQ(geom.SignalType(pid)));
+        settings.colorsID = cst->fConfigurationID.to_string();
+        return settings;
+    } // RawDataDrawer::MakePlaneSettings()
+    
+    
+    //......................................................................
+    void RawDataDrawer::ReportRegionOfInterest(geo::PlaneID const& pid)
+    {
+        geo::PlaneID::PlaneID_t const plane = pid.Plane;
+        if ((plane >= fNewRoI.size()) || !fNewRoI[plane]) return;
+        fNewRoI[plane] = false;
+        
+        geo::GeometryCore const& geom = *art::ServiceHandle<geo::Geometry const>();
+        mf::LogInfo("RawDataDrawer") << "Region of interest for "
+        << std::string(pid) << " detected to be within wires "
+        << fWireMin[plane] << " to " << (fWireMax[plane] - 1)
+        << " (plane has " << geom.Nwires(pid) << " wires) and ticks "
+        << fTimeMin[plane] << " to " << (fTimeMax[plane] - 1);
+        
+    } // RawDataDrawer::ReportRegionOfInterest()
+    
+    
     //......................................................................
     
     void RawDataDrawer::GetRawDigits(art::Event const& evt, details::CacheID_t const& new_timestamp)
@@ -1620,7 +2262,9 @@ namespace evd {
         MF_LOG_DEBUG("RawDataDrawer") << "GetRawDigits() for " << new_timestamp
         << " (last for: " << *fCacheID << ")";
         
-        // update cache
+        // update the cache of this input, shared with the other drawers
+        digit_cache
+        = &details::RawDigitCacheDataClass::Shared(new_timestamp.inputLabel());
         digit_cache->Update(evt, new_timestamp);
         
         // if time stamp is changing, we want to reconsider which region is
@@ -1634,22 +2278,6 @@ namespace evd {
     } // RawDataDrawer::GetRawDigits()
     
     
-    //......................................................................
-    bool RawDataDrawer::ProcessChannelWithStatus
-    (lariov::ChannelStatusProvider::Status_t channel_status) const
-    {
-        // if we don't have a valid status, we can't reject the channel
-        if (!lariov::ChannelStatusProvider::IsValidStatus(channel_status))
-            return true;
-        
-        // is the status "too bad"?
-        art::ServiceHandle<evd::RawDrawingOptions const> drawopt;
-        if (channel_status > drawopt->fMaxChannelStatus) return false;
-        if (channel_status < drawopt->fMinChannelStatus) return false;
-        
-        // no reason to reject it...
-        return true;
-    } // RawDataDrawer::ProcessChannel()
     
     //----------------------------------------------------------------------------
     namespace details {
@@ -1657,74 +2285,93 @@ namespace evd {
         //--------------------------------------------------------------------------
         //--- RawDigitInfo_t
         //---
-        raw::RawDigit::ADCvector_t const& RawDigitInfo_t::Data() const {
-            if (!data.hasData()) UncompressData();
-            return *data;
+        ADCspan_t const& RawDigitInfo_t::Data() const {
+            if (!bHasData) UncompressData();
+            return samples;
         } // RawDigitInfo_t::Data()
         
         
-        void RawDigitInfo_t::Fill(art::Ptr<raw::RawDigit> const& src) {
+        void RawDigitInfo_t::SetData(
+                                     ADCspan_t new_samples, float residual,
+                                     short min_charge, short max_charge
+                                     )
+        {
             data.Clear();
+            samples = new_samples;
+            pedestal_residual = residual;
+            bHasData = true;
+            sample_info.min_charge = min_charge;
+            sample_info.max_charge = max_charge;
+            bHasSampleInfo = true;
+        } // RawDigitInfo_t::SetData()
+        
+        
+        void RawDigitInfo_t::Fill(art::Ptr<raw::RawDigit> const& src) {
+            Clear();
             digit = src;
         } // RawDigitInfo_t::Fill()
         
         
         void RawDigitInfo_t::Clear() {
             data.Clear();
-            sample_info.reset();
+            samples = ADCspan_t();
+            pedestal_residual = 0.F;
+            bHasData = false;
+            bHasSampleInfo = false;
         }
         
         
         void RawDigitInfo_t::UncompressData() const {
+            // this is the fallback for a digit not uncompressed by the cache
             data.Clear();
+            samples = ADCspan_t();
+            pedestal_residual = 0.F;
+            bHasData = true;
             
             if (!digit) return; // no original data, can't do anything
             
             art::ServiceHandle<evd::RawDrawingOptions const> drawopt;
             
-            if (digit->Compression() == kNone) {
-                // no compression, we can refer to the original data directly
-                data.PointToData(digit->ADCs());
-            }
-            else {
-                // data is compressed, need to do the real work
-                if (drawopt->fUncompressWithPed){//Use pedestal in uncompression
-                    int pedestal = (int)digit->GetPedestal();
-                    raw::RawDigit::ADCvector_t samples;
-                    samples.resize(digit->Samples());
-                    Uncompress(digit->ADCs(), samples, pedestal, digit->Compression());
-                    data.StealData(std::move(samples));
-                }
-                else{
-                    raw::RawDigit::ADCvector_t samples;
-                    samples.resize(digit->Samples());
-                    Uncompress(digit->ADCs(), samples, digit->Compression());
-                    data.StealData(std::move(samples));
-                }
-            }
+            raw::RawDigit::ADCvector_t uncompressed;
+            if (digit->Compression() == kNone) uncompressed = digit->ADCs();
+            else UncompressDigit(*digit, drawopt->fUncompressWithPed, uncompressed);
+            
+            lariov::DetPedestalProvider const& pedestalRetrievalAlg
+            = *(lar::providerFrom<lariov::DetPedestalService>());
+            float const pedestal = DigitPedestal(
+                                                 *digit, drawopt->fPedestalOption,
+                                                 [&pedestalRetrievalAlg](raw::ChannelID_t channel)
+                                                 { return pedestalRetrievalAlg.PedMean(channel); }
+                                                 );
+            short const intPedestal = (short) std::lround(pedestal);
+            for (short& adc: uncompressed) adc -= intPedestal;
+            pedestal_residual = pedestal - intPedestal;
+            
+            data.StealData(std::move(uncompressed));
+            samples = ADCspan_t(*data);
         } // RawDigitInfo_t::UncompressData()
         
         
         void RawDigitInfo_t::CollectSampleInfo() const {
-            raw::RawDigit::ADCvector_t const& samples = Data();
+            ADCspan_t const& uncompressed = Data();
             
             //  lar::util::StatCollector<double> stat;
-            //  stat.add(samples.begin(), samples.end());
+            //  stat.add(uncompressed.begin(), uncompressed.end());
             
-            lar::util::MinMaxCollector<raw::RawDigit::ADCvector_t::value_type> stat
-            (samples.begin(), samples.end());
+            lar::util::MinMaxCollector<ADCspan_t::value_type> stat
+            (uncompressed.begin(), uncompressed.end());
             
-            sample_info.reset(new SampleInfo_t);
-            sample_info->min_charge = stat.min();
-            sample_info->max_charge = stat.max();
-            //  sample_info->average_charge = stat.Average();
+            sample_info.min_charge = stat.min();
+            sample_info.max_charge = stat.max();
+            //  sample_info.average_charge = stat.Average();
+            bHasSampleInfo = true;
             
         } // RawDigitInfo_t::CollectSampleInfo()
         
         
         RawDigitInfo_t::SampleInfo_t const& RawDigitInfo_t::SampleInfo() const {
-            if (!sample_info) CollectSampleInfo();
-            return *sample_info;
+            if (!bHasSampleInfo) CollectSampleInfo();
+            return sample_info;
         } // SampleInfo()
         
         template <typename Stream>
@@ -1733,8 +2380,8 @@ namespace evd {
             << " with " << digit->NADC();
             if (digit->Compression() == kNone) out << " uncompressed data";
             else out << " data items compressed with <" << digit->Compression() << ">";
-            if (data.hasData())
-                out << " with data (" << data->size() << " samples)";
+            if (bHasData)
+                out << " with data (" << samples.size() << " samples)";
             else out << " without data";
         } // RawDigitInfo_t::Dump()
         
@@ -1743,16 +2390,336 @@ namespace evd {
         //---
         
         RawDigitInfo_t const* RawDigitCacheDataClass::FindChannel
-        (raw::ChannelID_t channel) const
+        (raw::ChannelID_t channel)
         {
-            auto iDigit = std::find_if(
-                                       digits.cbegin(), digits.cend(),
-                                       [channel](evd::details::RawDigitInfo_t const& digit)
-                                       { return digit.Channel() == channel; }
-                                       );
-            return (iDigit == digits.cend())? nullptr: &*iDigit;
+            RawDigitInfo_t const* pDigit = LocateChannel(channel);
+            // the worker might be writing the data of this digit right now
+            if (pDigit && prefetch.valid()
+                && prefetched_digits[pDigit - digits.data()])
+            {
+                WaitForPrefetch();
+            }
+            return pDigit;
         } // RawDigitCacheDataClass::FindChannel()
         
+        
+        RawDigitInfo_t const* RawDigitCacheDataClass::LocateChannel
+        (raw::ChannelID_t channel) const
+        {
+            if (!raw::isValidChannelID(channel)) return nullptr;
+            if ((size_t) channel >= channel_index.size()) return nullptr;
+            size_t const iDigit = channel_index[channel];
+            return (iDigit == NoDigit)? nullptr: &(digits[iDigit]);
+        } // RawDigitCacheDataClass::LocateChannel()
+        
+        
+        RawDigitCacheDataClass::PlaneDigits_t const&
+        RawDigitCacheDataClass::PlaneDigits(geo::PlaneID const& pid) const
+        {
+            static PlaneDigits_t const NoDigits;
+            auto const iPlane = plane_digits.find(pid);
+            return (iPlane == plane_digits.end())? NoDigits: iPlane->second;
+        } // RawDigitCacheDataClass::PlaneDigits()
+        
+        
+        void RawDigitCacheDataClass::BuildIndices() {
+            
+            ChannelWireMap const& channelWires = ChannelWireMap::Instance();
+            
+            channel_index.clear();
+            plane_digits.clear();
+            
+            for (size_t iDigit = 0; iDigit < digits.size(); ++iDigit) {
+                RawDigitInfo_t const& digit_info = digits[iDigit];
+                raw::ChannelID_t const channel = digit_info.Channel();
+                if (!raw::isValidChannelID(channel)) continue;
+                
+                if ((size_t) channel >= channel_index.size())
+                    channel_index.resize(channel + 1, NoDigit);
+                // if more digits share a channel, FindChannel() returns the first
+                // one (as it used to with the linear search)
+                if (channel_index[channel] == NoDigit)
+                    channel_index[channel] = iDigit;
+                
+                // this is the only place where we ask about the wires
+                for (geo::WireID const& wireID: channelWires.Wires(channel))
+                    plane_digits[wireID.planeID()].push_back({ wireID, &digit_info });
+                
+            } // for digits
+            
+            MF_LOG_DEBUG("RawDataDrawer") << "Raw digit cache indexed "
+            << digits.size() << " digits on " << plane_digits.size() << " planes";
+            
+        } // RawDigitCacheDataClass::BuildIndices()
+        
+        
+        RawDigitCacheDataClass::~RawDigitCacheDataClass() {
+            // the worker writes into our digits; errors don't matter any more
+            if (!prefetch.valid()) return;
+            cancel_prefetch = true;
+            prefetch.wait();
+        } // RawDigitCacheDataClass::~RawDigitCacheDataClass()
+        
+        
+        std::map<std::string, std::unique_ptr<RawDigitCacheDataClass>>&
+        RawDigitCacheDataClass::SharedCaches()
+        {
+            static std::map<std::string, std::unique_ptr<RawDigitCacheDataClass>>
+            caches;
+            return caches;
+        } // RawDigitCacheDataClass::SharedCaches()
+        
+        
+        RawDigitCacheDataClass& RawDigitCacheDataClass::Shared
+        (art::InputTag const& label)
+        {
+            std::unique_ptr<RawDigitCacheDataClass>& cache
+            = SharedCaches()[label.encode()];
+            if (!cache) cache = std::make_unique<RawDigitCacheDataClass>();
+            return *cache;
+        } // RawDigitCacheDataClass::Shared()
+        
+        
+        void RawDigitCacheDataClass::CancelAllPrefetches() {
+            for (auto& cache: SharedCaches()) cache.second->CancelPrefetch();
+        } // RawDigitCacheDataClass::CancelAllPrefetches()
+        
+        
+        void RawDigitCacheDataClass::UncompressPlane(geo::PlaneID const& pid) {
+            
+            UpdateUncompressSettings();
+            
+            if (!uncompressed_planes.insert(pid).second) {
+                // done already, or being done in the background
+                if (prefetched_planes.count(pid) > 0) WaitForPrefetch();
+                return;
+            }
+            
+            UncompressJob_t const job = PrepareUncompression({ pid });
+            if (job.empty()) return;
+            
+            MF_LOG_DEBUG("RawDataDrawer") << "Uncompressing " << job.digits.size()
+            << " digits on " << std::string(pid) << " into rows of "
+            << job.stride << " samples";
+            
+            Uncompress(job);
+            
+        } // RawDigitCacheDataClass::UncompressPlane()
+        
+        
+        void RawDigitCacheDataClass::PrefetchPlanes() {
+            
+            if (prefetch.valid()) return; // one at a time
+            
+            UpdateUncompressSettings();
+            
+            std::set<geo::PlaneID> pids;
+            for (auto const& planeInfo: plane_digits) {
+                geo::PlaneID const& pid = planeInfo.first;
+                if (uncompressed_planes.insert(pid).second) pids.insert(pid);
+            } // for
+            if (pids.empty()) return;
+            
+            UncompressJob_t job = PrepareUncompression(pids);
+            if (job.empty()) return;
+            
+            // the worker must not read the event, which may be gone before the
+            // worker is done: it gets a copy of the (compressed) digits
+            job.digitCopies.reserve(job.digits.size());
+            for (RawDigitInfo_t const* digit_info: job.digits)
+                job.digitCopies.push_back(digit_info->Digit());
+            cancel_prefetch = false;
+            job.cancel = &cancel_prefetch;
+            
+            MF_LOG_DEBUG("RawDataDrawer") << "Uncompressing in the background "
+            << job.digits.size() << " digits on " << pids.size() << " planes";
+            
+            prefetched_planes = std::move(pids);
+            prefetched_digits.assign(digits.size(), false);
+            for (RawDigitInfo_t const* digit_info: job.digits)
+                prefetched_digits[digit_info - digits.data()] = true;
+            prefetch = std::async(std::launch::async,
+                                  [job=std::move(job)](){ Uncompress(job); });
+            
+        } // RawDigitCacheDataClass::PrefetchPlanes()
+        
+        
+        void RawDigitCacheDataClass::WaitForPrefetch() {
+            if (!prefetch.valid()) return;
+            prefetched_planes.clear();
+            prefetched_digits.clear();
+            try {
+                prefetch.get();
+            }
+            catch (...) {
+                // some digits may be left half done: start over
+                ReleaseUncompressedData();
+                throw;
+            }
+        } // RawDigitCacheDataClass::WaitForPrefetch()
+        
+        
+        void RawDigitCacheDataClass::CancelPrefetch() {
+            if (!prefetch.valid()) return;
+            cancel_prefetch = true;
+            try {
+                prefetch.get();
+            }
+            catch (...) {
+                // the digits left out are uncompressed again when asked for
+            }
+            cancel_prefetch = false;
+            
+            // digits with data are skipped when uncompressing these planes again
+            for (geo::PlaneID const& pid: prefetched_planes)
+                uncompressed_planes.erase(pid);
+            prefetched_planes.clear();
+            prefetched_digits.clear();
+        } // RawDigitCacheDataClass::CancelPrefetch()
+        
+        
+        void RawDigitCacheDataClass::UpdateUncompressSettings() {
+            evd::RawDrawingOptions const& rawopt
+            = *art::ServiceHandle<evd::RawDrawingOptions const>();
+            UncompressSettings_t settings;
+            settings.pedestalOption = rawopt.fPedestalOption;
+            settings.uncompressWithPed = rawopt.fUncompressWithPed;
+            if (settings != uncompress_settings) {
+                ReleaseUncompressedData();
+                uncompress_settings = settings;
+            }
+        } // RawDigitCacheDataClass::UpdateUncompressSettings()
+        
+        
+        RawDigitCacheDataClass::UncompressJob_t
+        RawDigitCacheDataClass::PrepareUncompression
+        (std::set<geo::PlaneID> const& pids)
+        {
+            UncompressJob_t job;
+            job.uncompressWithPed = uncompress_settings.uncompressWithPed;
+            
+            // collect the digits which still need data, each one only once
+            std::vector<bool> selected(digits.size(), false);
+            for (auto const& planeInfo: plane_digits) {
+                if (pids.count(planeInfo.first) == 0) continue;
+                for (WireDigitInfo_t const& wire_digit: planeInfo.second) {
+                    size_t const iDigit = wire_digit.digitInfo - digits.data();
+                    if (selected[iDigit] || digits[iDigit].hasData()) continue;
+                    selected[iDigit] = true;
+                    job.digits.push_back(&(digits[iDigit]));
+                } // for wires
+            } // for planes
+            if (job.empty()) return job;
+            
+            // the pedestal providers are not required to be thread-safe,
+            // so we ask them all the pedestals in advance
+            auto const servicePedestal = [this](raw::ChannelID_t channel)
+            { return ChannelConditionTable::Instance().Pedestal(channel); };
+            job.pedestals.resize(job.digits.size());
+            size_t maxDigitSamples = 0;
+            for (size_t i = 0; i < job.digits.size(); ++i) {
+                raw::RawDigit const& digit = job.digits[i]->Digit();
+                job.pedestals[i] = DigitPedestal
+                (digit, uncompress_settings.pedestalOption, servicePedestal);
+                maxDigitSamples = std::max(maxDigitSamples, digit.Samples());
+            } // for
+            
+            // each digit has a row in the block, all rows with the same length
+            // and padded so that each one starts aligned
+            constexpr size_t RowPadding
+            = ADCarena_t::allocator_type::alignment / sizeof(ADCarena_t::value_type);
+            job.stride
+            = (maxDigitSamples + RowPadding - 1) / RowPadding * RowPadding;
+            job.arena = AcquireSlab(job.stride * job.digits.size()).data();
+            
+            return job;
+        } // RawDigitCacheDataClass::PrepareUncompression()
+        
+        
+        void RawDigitCacheDataClass::Uncompress(UncompressJob_t const& job) {
+            
+            // each task works on its own digits and on its own rows of memory
+            tbb::parallel_for(
+                              tbb::blocked_range<size_t>(0, job.digits.size()),
+                              [&job](tbb::blocked_range<size_t> const& range)
+                              {
+                                  raw::RawDigit::ADCvector_t buffer;
+                                  for (size_t i = range.begin(); i != range.end(); ++i) {
+                                      if (job.cancel && *(job.cancel)) return;
+                                      
+                                      RawDigitInfo_t& digit_info = *(job.digits[i]);
+                                      raw::RawDigit const& digit = job.digitCopies.empty()
+                                      ? digit_info.Digit(): job.digitCopies[i];
+                                      
+                                      ADCspan_t source;
+                                      if (digit.Compression() == kNone)
+                                          source = ADCspan_t(digit.ADCs());
+                                      else {
+                                          UncompressDigit(digit, job.uncompressWithPed, buffer);
+                                          source = ADCspan_t(buffer);
+                                      }
+                                      
+                                      float const pedestal = job.pedestals[i];
+                                      short const intPedestal = (short) std::lround(pedestal);
+                                      ADCspan_t::value_type* row = job.arena + i * job.stride;
+                                      std::pair<short, short> const chargeRange
+                                      = CopyWithPedestal(source, row, intPedestal);
+                                      
+                                      digit_info.SetData(
+                                                         ADCspan_t(row, source.size()),
+                                                         pedestal - intPedestal,
+                                                         chargeRange.first, chargeRange.second
+                                                         );
+                                  } // for digits
+                              } // lambda
+                              );
+            
+        } // RawDigitCacheDataClass::Uncompress()
+        
+        
+        RawDigitCacheDataClass::ADCarena_t& RawDigitCacheDataClass::AcquireSlab
+        (size_t size)
+        {
+            // prefer a free block which is large enough already
+            ADCslab_t* pSlab = nullptr;
+            for (ADCslab_t& slab: slabs) {
+                if (slab.inUse) continue;
+                if (!pSlab || (slab.samples.capacity() >= size)) pSlab = &slab;
+                if (pSlab->samples.capacity() >= size) break;
+            } // for
+            if (!pSlab) {
+                slabs.emplace_back();
+                pSlab = &(slabs.back());
+            }
+            
+            pSlab->inUse = true;
+            pSlab->samples.resize(size);
+            return pSlab->samples;
+        } // RawDigitCacheDataClass::AcquireSlab()
+        
+        
+        void RawDigitCacheDataClass::ReleaseUncompressedData() {
+            CancelPrefetch();
+            for (RawDigitInfo_t& digit: digits) digit.Clear();
+            for (ADCslab_t& slab: slabs) slab.inUse = false;
+            uncompressed_planes.clear();
+        } // RawDigitCacheDataClass::ReleaseUncompressedData()
+        
+        
+        PlanePyramidClass const* RawDigitCacheDataClass::FindPyramid
+        (geo::PlaneID const& pid) const
+        {
+            auto const iPyramid = pyramids.find(pid);
+            return (iPyramid == pyramids.end())? nullptr: &(iPyramid->second);
+        } // RawDigitCacheDataClass::FindPyramid() const
+        
+        PlanePyramidClass* RawDigitCacheDataClass::FindPyramid
+        (geo::PlaneID const& pid)
+        {
+            auto const iPyramid = pyramids.find(pid);
+            return (iPyramid == pyramids.end())? nullptr: &(iPyramid->second);
+        } // RawDigitCacheDataClass::FindPyramid()
+        
         std::vector<raw::RawDigit> const* RawDigitCacheDataClass::ReadProduct
         (art::Event const& evt, art::InputTag label)
         {
@@ -1772,6 +2739,8 @@ namespace evd {
                 size_t samples = pDigit->Samples();
                 if (samples > max_samples) max_samples = samples;
             } // for
+            
+            BuildIndices();
         } // RawDigitCacheDataClass::Refill()
         
         
@@ -1781,8 +2750,13 @@ namespace evd {
         
         
         void RawDigitCacheDataClass::Clear() {
+            CancelPrefetch();
             Invalidate();
             digits.clear();
+            channel_index.clear();
+            plane_digits.clear();
+            pyramids.clear();
+            ReleaseUncompressedData();
             max_samples = 0;
         } // RawDigitCacheDataClass::Clear()
         
@@ -1821,7 +2795,7 @@ namespace evd {
             
             // use the first digit as test
             raw::ChannelID_t channel = res.digits->front().Channel();
-            RawDigitInfo_t const* pInfo = FindChannel(channel);
+            RawDigitInfo_t const* pInfo = LocateChannel(channel);
             if (!pInfo)
                 return res; // outdated: we don't even have this channel in cache!
 
@@ -1835,9 +2809,15 @@ namespace evd {
         
         bool RawDigitCacheDataClass::Update(art::Event const& evt, CacheID_t const& new_timestamp)
         {
+            // the channel conditions follow the event, whatever the digits are
+            ChannelConditionTable::Instance().Update(evt);
+            
             BoolWithUpToDateMetadata update_info = CheckUpToDate(new_timestamp, &evt);
             
-            if (update_info) return false; // already up to date: move on!
+            if (update_info) { // already up to date: move on!
+                UncompressPlane(new_timestamp.planeID());
+                return false;
+            }
             
             MF_LOG_DEBUG("RawDataDrawer")
             << "Refilling raw digit cache RawDigitCacheDataClass["
@@ -1855,6 +2835,9 @@ namespace evd {
             Refill(rdcol);
             
             timestamp = new_timestamp;
+            
+            // we don't wait for the drawing to ask for the data one digit at a time
+            UncompressPlane(new_timestamp.planeID());
             return true;
         } // RawDigitCacheDataClass::Update()
         
@@ -1875,124 +2858,184 @@ namespace evd {
         
         
         //--------------------------------------------------------------------------
-        //--- GridAxisClass
+        //--- PlanePyramidClass
         //---
-        std::ptrdiff_t GridAxisClass::GetCell(float coord) const {
-            return std::ptrdiff_t((coord - min) / cell_size); // truncate
-        } // GridAxisClass::GetCell()
-        
-        
-        //--------------------------------------------------------------------------
-        bool GridAxisClass::Init(size_t nDiv, float new_min, float new_max) {
-            
-            n_cells = std::max(nDiv, size_t(1));
-            return SetLimits(new_min, new_max);
-            
-        } // GridAxisClass::Init()
-        
-        
-        //--------------------------------------------------------------------------
-        bool GridAxisClass::SetLimits(float new_min, float new_max) {
-            min = new_min;
-            max = new_max;
-            cell_size = Length() / float(n_cells);
+        void PlanePyramidClass::Init(Settings_t const& new_settings, size_t nWires)
+        {
+            Clear();
+            settings = new_settings;
             
-            return std::isnormal(cell_size);
-        } // GridAxisClass::SetLimits()
-        
-        
-        //--------------------------------------------------------------------------
-        bool GridAxisClass::SetMinCellSize(float min_size) {
-            if (cell_size >= min_size) return false;
+            size_t const nTicks = (settings.endTick > settings.startTick)
+            ? (settings.endTick - settings.startTick): 0;
+            size_t const nTickCells
+            = (nTicks + (size_t(1) << MinTickShift) - 1) >> MinTickShift;
             
-            // n_cells gets truncated
-            n_cells = (size_t) std::max(std::floor(Length() / min_size), 1.0F);
+            levels.emplace_back(0U, MinTickShift, nWires, nTickCells);
             
-            // reevaluate cell size, that might be different than min_size
-            // because of n_cells truncation or minimum value
-            cell_size = Length() / float(n_cells);
-            return true;
-        } // GridAxisClass::SetMinCellSize()
+            nChargeBlocks
+            = (nTicks + (size_t(1) << ChargeTickShift) - 1) >> ChargeTickShift;
+            chargeSums.assign(nWires * nChargeBlocks, ChargeSum_t{});
+        } // PlanePyramidClass::Init()
         
         
-        //--------------------------------------------------------------------------
-        bool GridAxisClass::SetMaxCellSize(float max_size) {
-            if (cell_size <= max_size) return false;
+        void PlanePyramidClass::Complete() {
+            if (levels.empty() || bComplete) return;
             
-            // n_cells gets rounded up
-            n_cells = (size_t) std::max(std::ceil(Length() / max_size), 1.0F);
+            // count the levels, down to a single cell in each direction;
+            // they are derived only when needed
+            size_t const nBaseWires = levels.front().NWireCells();
+            size_t const nBaseTicks = levels.front().NTickCells();
+            nWireLevels = 1;
+            while ((nBaseWires >> nWireLevels) > 0) ++nWireLevels;
+            nTickLevels = 1;
+            while ((nBaseTicks >> nTickLevels) > 0) ++nTickLevels;
             
-            // reevaluate cell size, that might be different than max_size
-            // because of n_cells rounding or minimum value
-            cell_size = Length() / float(n_cells);
-            return true;
-        } // GridAxisClass::SetMaxCellSize()
+            bComplete = true;
+        } // PlanePyramidClass::Complete()
         
         
-        //--------------------------------------------------------------------------
-        template <typename Stream>
-        void GridAxisClass::Dump(Stream&& out) const {
-            out << NCells() << " cells from " << Min() << " to " << Max()
-            << " (length: " << Length() << ")";
-        } // GridAxisClass::Dump()
+        void PlanePyramidClass::Clear() {
+            levels.clear();
+            chargeSums.clear();
+            nChargeBlocks = 0;
+            nWireLevels = 0;
+            nTickLevels = 0;
+            bComplete = false;
+        } // PlanePyramidClass::Clear()
         
         
-        //--------------------------------------------------------------------------
-        //--- CellGridClass
-        //---
-        CellGridClass::CellGridClass(unsigned int nWires, unsigned int nTDC)
-        : wire_axis((size_t) nWires, 0., float(nWires))
-        , tdc_axis((size_t) nTDC, 0., float(nTDC))
+        PlanePyramidClass::Level_t const* PlanePyramidClass::FindLevel
+        (float wire_cell_size, float tick_cell_size)
         {
-        } // CellGridClass::CellGridClass(int, int)
-        
-        
-        //--------------------------------------------------------------------------
-        CellGridClass::CellGridClass(
-                                     float min_wire, float max_wire, unsigned int nWires,
-                                     float min_tdc, float max_tdc, unsigned int nTDC
-                                     )
-        : wire_axis((size_t) nWires, min_wire, max_wire)
-        , tdc_axis((size_t) nTDC, min_tdc, max_tdc)
+            if (!bComplete) return nullptr;
+            
+            // largest k with 2^k <= tick_cell_size
+            if (tick_cell_size < float(1U << MinTickShift)) return nullptr;
+            size_t iTickLevel = 0;
+            while ((iTickLevel + 1 < nTickLevels)
+                   && (float(1U << (MinTickShift + iTickLevel + 1)) <= tick_cell_size))
+                ++iTickLevel;
+            
+            // largest m with 2^m <= wire_cell_size
+            if (wire_cell_size < 1.F) return nullptr;
+            size_t iWireLevel = 0;
+            while ((iWireLevel + 1 < nWireLevels)
+                   && (float(1U << (iWireLevel + 1)) <= wire_cell_size))
+                ++iWireLevel;
+            
+            return &GetLevel(iTickLevel, iWireLevel);
+        } // PlanePyramidClass::FindLevel()
+        
+        
+        void PlanePyramidClass::SumCharge(
+                                          float minWire, float maxWire, float minTick, float maxTick,
+                                          double& raw, double& converted
+                                          ) const
         {
-        } // CellGridClass::CellGridClass({ float, float, int } x 2)
+            raw = 0.;
+            converted = 0.;
+            if (!bComplete) return;
+            
+            // first index whose coordinate (with offset) is not below coord
+            auto const firstIndex = [](float coord, float offset, size_t n)
+            {
+                return (coord <= offset)
+                ? size_t(0): std::min(n, size_t(std::ceil(coord - offset)));
+            };
+            
+            size_t const nWires = levels.front().NWireCells();
+            size_t const firstWire = firstIndex(minWire, 0.F, nWires);
+            size_t const endWire = firstIndex(maxWire, 0.F, nWires);
+            
+            // blocks are included when their center is in the range
+            float const blockSize = float(size_t(1) << ChargeTickShift);
+            float const offset = float(settings.startTick) + 0.5F * blockSize;
+            size_t const firstBlock
+            = firstIndex(minTick / blockSize, offset / blockSize, nChargeBlocks);
+            size_t const endBlock
+            = firstIndex(maxTick / blockSize, offset / blockSize, nChargeBlocks);
+            
+            for (size_t iWire = firstWire; iWire < endWire; ++iWire) {
+                ChargeSum_t const* wireSums = chargeSums.data() + iWire * nChargeBlocks;
+                for (size_t iBlock = firstBlock; iBlock < endBlock; ++iBlock) {
+                    raw += wireSums[iBlock].raw;
+                    converted += wireSums[iBlock].converted;
+                } // for blocks
+            } // for wires
+        } // PlanePyramidClass::SumCharge()
         
         
-        //--------------------------------------------------------------------------
-        std::ptrdiff_t CellGridClass::GetCell(float wire, float tick) const {
-            std::ptrdiff_t iWireCell = wire_axis.GetCell(wire);
-            if (!wire_axis.hasCell(iWireCell)) return std::ptrdiff_t(-1);
-            std::ptrdiff_t iTDCCell = tdc_axis.GetCell(tick);
-            if (!tdc_axis.hasCell(iTDCCell)) return std::ptrdiff_t(-1);
-            return iWireCell * TDCAxis().NCells() + iTDCCell;
-        } // CellGridClass::GetCell()
+        size_t PlanePyramidClass::MemoryUsage() const {
+            size_t nCells = 0;
+            for (Level_t const& level: levels) nCells += level.NCells();
+            return nCells * sizeof(ADC_t) + chargeSums.size() * sizeof(ChargeSum_t);
+        } // PlanePyramidClass::MemoryUsage()
         
         
-        //--------------------------------------------------------------------------
-        std::tuple<float, float, float, float> CellGridClass::GetCellBox
-        (std::ptrdiff_t iCell) const
+        PlanePyramidClass::Level_t const& PlanePyramidClass::GetLevel
+        (size_t iTickLevel, size_t iWireLevel)
         {
-            // { w1, t1, w2, t2 }
-            size_t const nTDCCells = TDCAxis().NCells();
-            std::ptrdiff_t iWireCell = (std::ptrdiff_t) (iCell / nTDCCells),
-            iTDCCell = (std::ptrdiff_t) (iCell % nTDCCells);
+            unsigned int const wireShift = iWireLevel;
+            unsigned int const tickShift = MinTickShift + iTickLevel;
+            
+            if ((wireShift == 0) && (tickShift == MinTickShift)) return levels.front();
             
+            // a derived level just used is moved to the end of the list
+            for (auto iLevel = levels.begin() + 1; iLevel != levels.end(); ++iLevel) {
+                if ((iLevel->WireShift() != wireShift)
+                    || (iLevel->TickShift() != tickShift)) continue;
+                std::rotate(iLevel, iLevel + 1, levels.end());
+                return levels.back();
+            } // for
             
-            return std::tuple<float, float, float, float>(
-                                                          WireAxis().LowerEdge(iWireCell), TDCAxis().LowerEdge(iTDCCell),
-                                                          WireAxis().UpperEdge(iWireCell), TDCAxis().UpperEdge(iTDCCell)
-                                                          );
-        } // CellGridClass::GetCellBox()
+            return DeriveLevel(wireShift, tickShift);
+        } // PlanePyramidClass::GetLevel()
         
         
-        //--------------------------------------------------------------------------
-        template <typename Stream>
-        void CellGridClass::Dump(Stream&& out) const {
-            out << "Wire axis: ";
-            WireAxis().Dump(out);
-            out << "; time axis: ";
-            TDCAxis().Dump(out);
-        } // CellGridClass::Dump()
+        PlanePyramidClass::Level_t const& PlanePyramidClass::DeriveLevel
+        (unsigned int wireShift, unsigned int tickShift)
+        {
+            // the source is the smallest level the new one can be merged from
+            size_t iSrc = 0;
+            for (size_t iLevel = 1; iLevel < levels.size(); ++iLevel) {
+                Level_t const& level = levels[iLevel];
+                if ((level.WireShift() > wireShift) || (level.TickShift() > tickShift))
+                    continue;
+                if (level.NCells() < levels[iSrc].NCells()) iSrc = iLevel;
+            } // for
+            
+            Level_t const& base = levels.front();
+            unsigned int const baseTickShift = tickShift - MinTickShift;
+            Level_t level(
+                          wireShift, tickShift,
+                          (base.NWireCells() + (size_t(1) << wireShift) - 1) >> wireShift,
+                          (base.NTickCells() + (size_t(1) << baseTickShift) - 1) >> baseTickShift
+                          );
+            
+            Level_t const& src = levels[iSrc];
+            unsigned int const dWire = wireShift - src.WireShift();
+            unsigned int const dTick = tickShift - src.TickShift();
+            for (size_t iSrcWire = 0; iSrcWire < src.NWireCells(); ++iSrcWire) {
+                size_t const iWire = iSrcWire >> dWire;
+                for (size_t iSrcTick = 0; iSrcTick < src.NTickCells(); ++iSrcTick) {
+                    ADC_t& cell = level(iWire, iSrcTick >> dTick);
+                    cell = Merge(cell, src(iSrcWire, iSrcTick));
+                } // for ticks
+            } // for wires
+            
+            // drop the levels used least recently, until the derived ones
+            // together are not larger than the base
+            size_t nDerivedCells = level.NCells();
+            for (size_t iLevel = 1; iLevel < levels.size(); ++iLevel)
+                nDerivedCells += levels[iLevel].NCells();
+            auto iKept = levels.begin() + 1;
+            while ((nDerivedCells > base.NCells()) && (iKept != levels.end()))
+                nDerivedCells -= (iKept++)->NCells();
+            levels.erase(levels.begin() + 1, iKept);
+            
+            levels.push_back(std::move(level));
+            return levels.back();
+        } // PlanePyramidClass::DeriveLevel()
         
         
         //--------------------------------------------------------------------------
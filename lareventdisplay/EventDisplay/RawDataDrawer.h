@@ -6,12 +6,9 @@
 
 #include "larcoreobj/SimpleTypesAndConstants/geo_types.h" // geo::PlaneID
 
+#include <memory>
+#include <string>
 #include <vector>
-#ifndef __CINT__
-
-#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h" // lariov::ChannelStatusProvider::Status_t
-
-#endif
 
 class TH1F;
 class TVirtualPad;
@@ -24,9 +21,13 @@ namespace util {
 
 namespace evd {
 
+  class ColorRaster;
+
   namespace details {
     class RawDigitCacheDataClass;
     class CellGridClass;
+    class BoxCellsClass;
+    struct PlaneSettings_t;
     typedef ::util::PlaneDataChangeTracker_t CacheID_t;
   } // namespace details
 
@@ -57,12 +58,47 @@ namespace evd {
      * If the zoom is required instead, rendering is performed in two steps;
      * in the first, run only of no region of interest is known yet, the region
      * is extracted. In the second, that information is used for rendering.
+     *
+     * The first pass on the samples of a plane also fills a multi-resolution
+     * summary of its charge (a "pyramid" of the largest ADC counts in cells of
+     * 2^k ticks by 2^m wires). Following renderings of that plane read the
+     * pyramid level matching the pad resolution instead of all the samples,
+     * unless the zoom is so deep that no level is fine enough.
      */
     void RawDigit2D(
       art::Event const& evt, evdb::View2D* view, unsigned int plane,
       bool bZoomToRoI = false
       );
 
+    /**
+     * @brief Reads the raw digits and channel conditions needed for a plane
+     * @param evt the event to read the digits from
+     * @param plane number of the plane in the current TPC
+     * @return whether there are digits for the plane
+     *
+     * This is the part of the preparation of RawDigit2D() which uses
+     * services that are not required to be thread-safe, and must be called
+     * from the main thread. It also collects from the services the settings
+     * PrepareRawDigit2D() needs for this plane.
+     */
+    bool LoadRawDigits(art::Event const& evt, unsigned int plane);
+
+    /**
+     * @brief Extracts region of interest and charge pyramid of a plane
+     * @param evt the event the digits were loaded from
+     * @param plane number of the plane in the current TPC
+     * @see LoadRawDigits()
+     *
+     * This is the data preparation part of RawDigit2D() that does not touch
+     * any ROOT object: it fills whatever is missing of the region of interest
+     * and of the charge pyramid of the plane, from the digits already loaded
+     * by LoadRawDigits(). It does not use any service, but only the settings
+     * read by LoadRawDigits() for the same plane, and different drawers can
+     * run it concurrently. The region of interest found here is reported by
+     * the next RawDigit2D() of the plane.
+     */
+    void PrepareRawDigit2D(art::Event const& evt, unsigned int plane);
+
 /*     void RawDigit3D(const art::Event& evt, */
 /* 		    evdb::View3D*     view); */
 
@@ -78,9 +114,12 @@ namespace evd {
     double StartTick()       const { return fStartTick; }
     double TotalClockTicks() const { return fTicks; }
 
-    /// Fills the viewport information from the specified pad
-    void ExtractRange
-      (TVirtualPad* pPad, std::vector<double> const* zoom = nullptr);
+    /// Fills the viewport information from the specified pad; with
+    /// `coarseness` larger than 1, cells are that many pixels wide and tall
+    void ExtractRange(
+      TVirtualPad* pPad, std::vector<double> const* zoom = nullptr,
+      unsigned int coarseness = 1
+      );
 
     /// Fills the viewport borders from the specified extremes
     void SetDrawingLimits
@@ -99,16 +138,34 @@ namespace evd {
     /// for the specified plane
     bool hasRegionOfInterest(geo::PlaneID::PlaneID_t plane) const;
 
+    /**
+     * @brief Draws the raster of the plane into the current pad
+     * @param plane number of the plane to be drawn
+     *
+     * When the raster drawing backend is selected (see `RawDrawingOptions`),
+     * RawDigit2D() paints into a raster instead of adding boxes to the view;
+     * this method draws that raster, and does nothing otherwise.
+     */
+    void DrawRaster(unsigned int plane) const;
+
+    /// Forgets the raster of the plane, which will not be drawn any more
+    void ClearRaster(unsigned int plane);
+
+    /// Returns the charge in the area of the last drawing of the plane
     void GetChargeSum(int plane,
 		      double& charge,
 		      double& convcharge);
 
-  private:
-    typedef struct {
-      int    adc   = 0;  ///< total ADC count in this box
-      bool   good  = false; ///< whether the channel is not bad
-    } BoxInfo_t;
+    /**
+     * @brief Stops the uncompression of raw digits running in the background
+     *
+     * With the `PrefetchTPCs` option, the digits of the planes not shown yet
+     * are uncompressed in the background. This work is about the current
+     * event, and it should be stopped when the event is released.
+     */
+    static void CancelBackgroundWork();
 
+  private:
     typedef struct {
       unsigned int width = 0; // width of pad in pixels
       unsigned int height = 0; // heigt of pad in pixels
@@ -123,9 +180,10 @@ namespace evd {
 
     /// Helper class to be used with ChannelLooper()
     class OperationBaseClass;
-    class ManyOperations;
+    template <typename... Ops> class FusedOperations;
     class BoxDrawer;
     class RoIextractorClass;
+    class PyramidBuilderClass;
 
     // Since this is a private facility, we indulge in non-recommended practises
     // like friendship; these classes have the ability to write their findings
@@ -137,8 +195,8 @@ namespace evd {
     friend class BoxDrawer;
     friend class RoIextractorClass;
 
-    /// Cache of raw digits
-    // Never use raw pointers. Unless you are dealing with CINT, that is.
+    /// Cache of raw digits of the current input, shared with the other drawers
+    /// (not owned)
     evd::details::RawDigitCacheDataClass* digit_cache;
 
 #ifndef __CINT__
@@ -147,10 +205,6 @@ namespace evd {
 
     /// Reads raw::RawDigits; also triggers Reset()
     void GetRawDigits(art::Event const& evt);
-
-    /// Returns whether a channel with the specified status should be processed
-    bool ProcessChannelWithStatus
-      (lariov::ChannelStatusProvider::Status_t channel_status) const;
 #endif // __CINT__
 
     double fStartTick;                       ///< low tick
@@ -171,9 +225,29 @@ namespace evd {
     // TODO with ROOT 6, turn this into a std::unique_ptr()
     details::CellGridClass* fDrawingRange; ///< information about the viewport
 
-    /// Performs the 2D wire plane drawing
-    void DrawRawDigit2D
-      (art::Event const& evt, evdb::View2D* view, unsigned int plane);
+    /// Rasters for the raster drawing backend, one per plane (created on demand)
+    std::vector<std::unique_ptr<ColorRaster>> fRasters;
+
+    /// Returns the raster for the specified plane, creating it if needed
+    ColorRaster& Raster(geo::PlaneID::PlaneID_t plane);
+
+    /// Settings of the plane last loaded by LoadRawDigits()
+    std::unique_ptr<details::PlaneSettings_t> fPlaneSettings;
+
+    /// Whether a region of interest of each plane is yet to be reported
+    std::vector<bool> fNewRoI;
+
+    /// Performs the 2D wire plane drawing of digits already loaded
+    void DrawRawDigit2D(
+      art::Event const& evt, evdb::View2D* view,
+      details::PlaneSettings_t const& settings, bool bZoomToRoI
+      );
+
+    /// Reads from the services the settings of the operations on a plane
+    details::PlaneSettings_t MakePlaneSettings(geo::PlaneID const& pid) const;
+
+    /// Prints the region of interest of the plane, if newly found
+    void ReportRegionOfInterest(geo::PlaneID const& pid);
 
     /**
      * @brief Makes sure raw::RawDigit's are available for the current settings
@@ -192,11 +266,19 @@ namespace evd {
       (art::Event const& evt, details::CacheID_t const& new_timestamp);
 
     // Helper functions for drawing
-    bool RunOperation(art::Event const& evt, OperationBaseClass* operation);
+    template <typename Op>
+    bool RunOperation(
+      art::Event const& evt, Op& operation,
+      details::PlaneSettings_t const& settings
+      );
+    template <typename Op>
+    static std::string OperationName(Op const&);
+    template <typename... Ops>
+    static std::string OperationName(FusedOperations<Ops...> const& op);
     void QueueDrawingBoxes(
       evdb::View2D* view,
-      geo::PlaneID const& pid,
-      std::vector<BoxInfo_t> const& BoxInfo
+      details::PlaneSettings_t const& settings,
+      details::BoxCellsClass const& cells
       );
     void RunDrawOperation
       (art::Event const& evt, evdb::View2D* view, unsigned int plane);
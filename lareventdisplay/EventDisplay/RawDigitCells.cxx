@@ -0,0 +1,62 @@
+/// \file    RawDigitCells.cxx
+/// \brief   Collection of the raw digit samples of a plane into drawing cells
+
+#include "lareventdisplay/EventDisplay/RawDigitCells.h"
+
+#include <cmath> // std::sqrt()
+
+namespace evd {
+    namespace details {
+
+        //--------------------------------------------------------------------------
+        //--- BoxCellsClass
+        //---
+        void BoxCellsClass::Initialize
+        (CellGridClass const& new_grid, float minTickSize)
+        {
+            grid = new_grid;
+
+            // set the minimum cell in ticks (e.g. to match fTicksPerPoint);
+            // also set the minimum wire cell size to 1,
+            // otherwise there will be cells represented by no wire.
+            grid.SetMinTDCCellSize(minTickSize);
+            grid.SetMinWireCellSize(1.F);
+
+            cells.assign(grid.NCells(), BoxInfo_t{});
+            wireCells = nullptr;
+        } // BoxCellsClass::Initialize()
+
+
+        //--------------------------------------------------------------------------
+        std::tuple<float, float, float, float> CellBox(
+                                                       CellGridClass const& grid, std::size_t iBox,
+                                                       int adc, bool scaleByCharge
+                                                       )
+        {
+            // scale factor, proportional to ADC count (optional)
+            constexpr float q0 = 1000.;
+            float const sf = scaleByCharge
+            ? std::min(std::sqrt((float) adc / q0), 1.0F)
+            : 1.;
+
+            // coordinates of the cell box
+            float min_wire, max_wire, min_tick, max_tick;
+            std::tie(min_wire, min_tick, max_wire, max_tick) = grid.GetCellBox(iBox);
+
+            if (sf != 1.) { // need to shrink the box
+                float const nsf = 1. - sf; // negation of scale factor
+                float const half_box_wires = (max_wire - min_wire) / 2.,
+                half_box_ticks = (max_tick - min_tick) / 2.;
+
+                // shrink the box:
+                min_wire += nsf * half_box_wires;
+                max_wire -= nsf * half_box_wires;
+                min_tick += nsf * half_box_ticks;
+                max_tick -= nsf * half_box_ticks;
+            } // if scaling
+
+            return { min_wire, min_tick, max_wire, max_tick };
+        } // CellBox()
+
+    } // namespace details
+} // namespace evd
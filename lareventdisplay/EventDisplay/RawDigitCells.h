@@ -0,0 +1,215 @@
+/// \file    RawDigitCells.h
+/// \brief   Collection of the raw digit samples of a plane into drawing cells
+///
+/// These classes do not depend on the framework nor on the detector
+/// services: the drawers read all the settings in advance, and the same
+/// code can be driven by a benchmark on synthetic planes.
+#ifndef EVD_RAWDIGITCELLS_H
+#define EVD_RAWDIGITCELLS_H
+
+#include "lareventdisplay/EventDisplay/CellGrid.h"
+
+#include <algorithm> // std::min(), std::max()
+#include <cmath> // std::abs()
+#include <cstddef> // std::size_t, std::ptrdiff_t
+#include <limits>
+#include <tuple> // std::apply()
+#include <vector>
+
+namespace evd {
+    namespace details {
+
+        /// Content of a drawing cell
+        struct BoxInfo_t {
+            int    adc   = 0;  ///< ADC count with largest magnitude in this box
+            bool   good  = false; ///< whether the channel is not bad
+        }; // struct BoxInfo_t
+
+
+        /// Settings for turning the cells into boxes on the view
+        struct BoxDrawingSettings_t {
+            float minTickCellSize = 1.F; ///< smallest cell size in ticks
+            float minSignal = 0.F; ///< cells with lower ADC count are not drawn
+            bool scaleByCharge = false; ///< whether box size follows the charge
+            bool swapAxes = false; ///< whether ticks are on the horizontal axis
+            bool raster = false; ///< whether cells are painted on a raster
+        }; // struct BoxDrawingSettings_t
+
+
+        /**
+         * @brief Cells of a drawing grid, filled with the samples in them
+         *
+         * Each cell keeps the ADC count with the largest magnitude among the
+         * samples in it. The samples of a wire are added after the wire has
+         * been selected with ProcessWire().
+         */
+        class BoxCellsClass {
+        public:
+            /// Sets the grid, with cells at least one wire and minTickSize wide
+            void Initialize(CellGridClass const& grid, float minTickSize);
+
+            /// Selects the wire of the next samples; returns if it has cells
+            bool ProcessWire(unsigned int wire)
+            {
+                GridAxisClass const& wireAxis = grid.WireAxis();
+                std::ptrdiff_t const iWireCell = wireAxis.GetCell((float) wire);
+                wireCells = wireAxis.hasCell(iWireCell)? WireCells(iWireCell): nullptr;
+                return wireCells != nullptr;
+            } // ProcessWire()
+
+            /// Returns whether the tick is in the grid
+            bool ProcessTick(std::size_t tick) const
+            { return grid.hasTick((float) tick); }
+
+            /// Adds a sample of the selected wire; returns if it's in a cell
+            bool Add(std::size_t tick, float adc)
+            {
+                if (!wireCells) return false;
+                GridAxisClass const& tdcAxis = grid.TDCAxis();
+                std::ptrdiff_t const iTDCCell = tdcAxis.GetCell((float) tick);
+                if (!tdcAxis.hasCell(iTDCCell)) return false;
+                Merge(wireCells[iTDCCell], adc);
+                return true;
+            } // Add()
+
+            /// Returns the cells of the specified wire cell
+            BoxInfo_t* WireCells(std::ptrdiff_t iWireCell)
+            { return cells.data() + iWireCell * grid.TDCAxis().NCells(); }
+
+            /// Marks the cell as good, and keeps the larger ADC count
+            static void Merge(BoxInfo_t& info, float adc)
+            {
+                info.good = true;
+                if (std::abs(info.adc) <= std::abs(adc)) info.adc = adc;
+            } // Merge()
+
+            /// Returns the grid, with the cell sizes fixed by Initialize()
+            CellGridClass const& Grid() const { return grid; }
+
+            /// Returns all the cells, wire-major
+            std::vector<BoxInfo_t> const& Cells() const { return cells; }
+
+        private:
+            CellGridClass grid; ///< the grid of the cells
+            std::vector<BoxInfo_t> cells; ///< content of the cells
+            BoxInfo_t* wireCells = nullptr; ///< cells of the selected wire
+        }; // class BoxCellsClass
+
+
+        /// Range of wires and ticks with samples above a threshold
+        class RoIRangeClass {
+        public:
+            /// Constructor: samples below threshold (in magnitude) are ignored
+            explicit RoIRangeClass(float threshold): fThreshold(threshold) {}
+
+            /// Extends the range to include the sample, if above threshold
+            void Add(unsigned int wire, std::size_t tick, float adc)
+            {
+                if (std::abs(adc) < fThreshold) return;
+                fWireMin = std::min(fWireMin, (float) wire);
+                fWireMax = std::max(fWireMax, (float) wire);
+                fTickMin = std::min(fTickMin, (float) tick);
+                fTickMax = std::max(fTickMax, (float) tick);
+            } // Add()
+
+            /// Returns whether any sample was above threshold
+            bool hasData() const { return fWireMin <= fWireMax; }
+
+            float WireMin() const { return fWireMin; } ///< lowest wire
+            float WireMax() const { return fWireMax; } ///< highest wire
+            float TickMin() const { return fTickMin; } ///< lowest tick
+            float TickMax() const { return fTickMax; } ///< highest tick
+
+        private:
+            float fThreshold; ///< smallest signal included
+            float fWireMin = std::numeric_limits<float>::max();
+            float fWireMax = std::numeric_limits<float>::lowest();
+            float fTickMin = std::numeric_limits<float>::max();
+            float fTickMax = std::numeric_limits<float>::lowest();
+        }; // class RoIRangeClass
+
+
+        /**
+         * @brief Runs many operations on the samples in the same pass
+         * @tparam Ops types of the operations
+         *
+         * The operations are not owned by this object, and the calls to them
+         * are resolved at compile time.
+         * A wire or tick is processed if any of the operations requires it;
+         * each operation must then cope with samples it did not ask for.
+         */
+        template <typename... Ops>
+        class FusedKernels {
+        public:
+            FusedKernels(Ops&... ops): operations(ops...) {}
+
+            bool Initialize()
+            { return std::apply([](auto&... op){ return (op.Initialize() & ...); }, operations); }
+
+            template <typename Wire>
+            bool ProcessWire(Wire const& wire)
+            {
+                return std::apply
+                ([&wire](auto&... op){ return (op.ProcessWire(wire) | ...); }, operations);
+            }
+            bool ProcessTick(std::size_t tick)
+            {
+                return std::apply
+                ([tick](auto&... op){ return (op.ProcessTick(tick) | ...); }, operations);
+            }
+
+            template <typename Wire>
+            bool Operate(Wire const& wire, std::size_t tick, float adc)
+            {
+                return std::apply([&](auto&... op)
+                    { return (op.Operate(wire, tick, adc) & ...); }, operations);
+            }
+
+            bool Finish()
+            { return std::apply([](auto&... op){ return (op.Finish() & ...); }, operations); }
+
+        protected:
+            std::tuple<Ops&...> operations; ///< the fused operations
+        }; // class FusedKernels<>
+
+
+        /**
+         * @brief Calls `draw(iBox, color)` for each cell to be drawn
+         * @param cells the cells
+         * @param minSignal cells with smaller ADC count are not drawn
+         * @param color returns the color for an ADC count
+         * @param draw called for the cells to be drawn
+         * @return the number of drawn cells
+         */
+        template <typename ColorFn, typename DrawFn>
+        unsigned int DrawCells(
+                               std::vector<BoxInfo_t> const& cells, float minSignal,
+                               ColorFn&& color, DrawFn&& draw
+                               )
+        {
+            unsigned int nDrawnBoxes = 0;
+            std::size_t const nBoxes = cells.size();
+            for (std::size_t iBox = 0; iBox < nBoxes; ++iBox) {
+                BoxInfo_t const& info = cells[iBox];
+
+                // skip the bad cells, and don't bother with too little signal
+                if (!info.good || (std::abs(info.adc) < minSignal)) continue;
+
+                draw(iBox, color(info.adc));
+                ++nDrawnBoxes;
+            } // for
+            return nDrawnBoxes;
+        } // DrawCells()
+
+
+        /// Returns the { w1, t1, w2, t2 } box of the cell, shrunk by charge
+        /// if `scaleByCharge` is set
+        std::tuple<float, float, float, float> CellBox(
+                                                       CellGridClass const& grid, std::size_t iBox,
+                                                       int adc, bool scaleByCharge
+                                                       );
+
+    } // namespace details
+} // namespace evd
+
+#endif // EVD_RAWDIGITCELLS_H
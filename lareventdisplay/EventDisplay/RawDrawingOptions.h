@@ -35,6 +35,16 @@ namespace evd {
    *   apply the same threshold to all planes). If no threshold is specified
    *   at all, the value of 'MinSignal' parameter is used as threshold for all
    *   planes
+   * - *DrawingBackend* (integer, default: 0): how the TDC vs. wire views
+   *   render raw digits and calibrated wires: `0` adds one box per cell to the
+   *   view, `1` paints all the cells of a plane into a single histogram sized
+   *   to the pad resolution, which is much faster to draw on large pads; in
+   *   the latter mode, *ScaleDigitsByCharge* is ignored
+   * - *PrefetchTPCs* (boolean, default: false): after the raw digits of the
+   *   displayed plane are uncompressed, uncompress the ones of all the other
+   *   planes, of all the TPCs, in the background, so that switching TPC is
+   *   fast; this needs memory for the uncompressed waveforms of the whole
+   *   detector
    *
    */
   class RawDrawingOptions : public evdb::Reconfigurable
@@ -51,6 +61,8 @@ namespace evd {
       double                     fStartTick;                               ///< Starting tick for the display
       double 	                 fTicks;                                   ///< number of TDC ticks to display, ie # fTicks past fStartTick
       int    	                 fAxisOrientation;                         ///< 0 = TDC values on y-axis, wire number on x-axis, 1 = swapped
+      int                        fDrawingBackend;                          ///< 0 = one box per cell, 1 = one raster histogram per plane
+      bool                       fPrefetchTPCs;                            ///< uncompress the digits of all TPCs in the background
       unsigned int               fTPC;                                     ///< TPC number to draw, typically set by TWQProjectionView
       unsigned int               fCryostat;                                ///< Cryostat number to draw, typically set by TWQProjectionView
       unsigned int               fMinChannelStatus;                        ///< Display channels with this status and above
@@ -66,6 +78,8 @@ namespace evd {
       
       fhicl::ParameterSet        fRawDigitDrawerParams;                    ///< FHICL parameters for the RawDigit waveform display
 
+      fhicl::ParameterSetID      fConfigurationID;                         ///< ID of the configuration last applied by reconfigure()
+
       /// Returns the current TPC as a TPCID
       geo::TPCID   CurrentTPC() const { return geo::TPCID(fCryostat, fTPC); }
 
@@ -28,6 +28,8 @@ namespace evd {
       fStartTick                  = pset.get< double                     >("StartTick",            0    );
       fTicks                      = pset.get< double                     >("TotalTicks",           2048 );
       fAxisOrientation         	  = pset.get< int                        >("AxisOrientation",      0    );
+      fDrawingBackend             = pset.get< int                        >("DrawingBackend",       0    );
+      fPrefetchTPCs               = pset.get< bool                       >("PrefetchTPCs",         false);
       fRawDataLabels              = pset.get< std::vector<art::InputTag> >("RawDataLabels",        std::vector<art::InputTag>() = {"daq"} );
       fTPC                        = pset.get< unsigned int               >("TPC",                  0    );
       fCryostat                   = pset.get< unsigned int               >("Cryostat",             0    );
@@ -41,6 +43,8 @@ namespace evd {
       if (fRoIthresholds.empty()) fRoIthresholds.push_back((float) fMinSignal);
 
       fRawDigitDrawerParams       = pset.get< fhicl::ParameterSet >("RawDigitDrawer"             );
+
+      fConfigurationID            = pset.id();
   }
 }
 
@@ -44,13 +44,16 @@
 #include "lardataobj/RecoBase/Vertex.h"
 #include "lardataobj/RecoBase/Wire.h"
 #include "lareventdisplay/EventDisplay/3DDrawers/ISpacePoints3D.h"
+#include "lareventdisplay/EventDisplay/AssociationCache.h"
+#include "lareventdisplay/EventDisplay/ChannelConditions.h"
+#include "lareventdisplay/EventDisplay/ChannelWireMap.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/HitIndex.h"
+#include "lareventdisplay/EventDisplay/RawDigitCells.h"
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RecoBaseDrawer.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/eventdisplay.h"
-#include "larevt/CalibrationDBI/Interface/ChannelStatusProvider.h"
-#include "larevt/CalibrationDBI/Interface/ChannelStatusService.h"
 #include "nuevdb/EventDisplayBase/EventHolder.h"
 #include "nuevdb/EventDisplayBase/View2D.h"
 #include "nuevdb/EventDisplayBase/View3D.h"
@@ -74,6 +77,13 @@ namespace {
 				     << " failed with message:\n"
 				     << e;
   }
+
+  /// Hit index shared by the drawers of all the views
+  evd::HitIndex& EventHitIndex()
+  {
+    static evd::HitIndex index;
+    return index;
+  }
 }
 
 namespace evd{
@@ -130,10 +140,15 @@ void RecoBaseDrawer::Wire2D(const art::Event& evt,
     art::ServiceHandle<geo::Geometry const>            geo;
     art::ServiceHandle<evd::ColorDrawingOptions const> cst;
 
+    // a raster left over from a previous drawing would be drawn again
+    ClearWireRaster(plane);
+
     if(rawOpt->fDrawRawDataOrCalibWires < 1)    return;
 
-    lariov::ChannelStatusProvider const& channelStatus
-      = art::ServiceHandle<lariov::ChannelStatusService const>()->GetProvider();
+    // channel status is asked once per event, not once per wire and redraw
+    ChannelConditionTable& channelConditions = ChannelConditionTable::Instance();
+    channelConditions.Update(evt);
+    ChannelConditionTable::Selection_t const channelSelection(*rawOpt);
 
     int ticksPerPoint = rawOpt->fTicksPerPoint;
 
@@ -144,6 +159,52 @@ void RecoBaseDrawer::Wire2D(const art::Event& evt,
     double maxw = 0;
 
     geo::PlaneID pid(rawOpt->fCryostat, rawOpt->fTPC, plane);
+    ChannelWireMap const& channelWires = ChannelWireMap::Instance();
+
+    // the points are collected in a grid of cells at the resolution of the pad
+    // (no smaller than a wire and than a point), with the same cells
+    // RawDataDrawer uses for the digits: each cell keeps the largest signal of
+    // its points, and it is drawn as a single box (or raster cell with the
+    // raster backend); without pad information, the grid covers the whole
+    // plane coarsely
+    bool const swapAxes = (rawOpt->fAxisOrientation >= 1);
+    constexpr unsigned int maxCells = 2048;
+    details::CellGridClass grid;
+    if (fRasterFrame.isValid()) {
+      grid.SetWireRange(
+        swapAxes? fRasterFrame.yMin: fRasterFrame.xMin,
+        swapAxes? fRasterFrame.yMax: fRasterFrame.xMax,
+        swapAxes? fRasterFrame.height: fRasterFrame.width,
+        1.F
+        );
+      grid.SetTDCRange(
+        swapAxes? fRasterFrame.xMin: fRasterFrame.yMin,
+        swapAxes? fRasterFrame.xMax: fRasterFrame.yMax,
+        swapAxes? fRasterFrame.width: fRasterFrame.height,
+        1.F
+        );
+    }
+    else {
+      unsigned int const nWires = geo->Nwires(pid);
+      grid.SetWireRange(-0.5, nWires - 0.5, std::min(nWires, maxCells), 1.F);
+      grid.SetTDCRange(0., rawOpt->fTicks, maxCells, 1.F);
+    }
+    details::BoxCellsClass cells;
+    cells.Initialize(grid, (float) ticksPerPoint);
+
+    // adds a point (the average of ticksPerPoint ticks) to its cell
+    auto const addPoint = [&](double wire, double tdc, double adc)
+      {
+        if(TMath::Abs(adc) < rawOpt->fMinSignal) return;
+        if(tdc > rawOpt->fTicks) return;
+
+        if(wire < minw) minw = wire;
+        if(wire > maxw) maxw = wire;
+        if(tdc  < mint) mint = tdc;
+        if(tdc  > maxt) maxt = tdc;
+
+        cells.Add((std::size_t) tdc, adc);
+      };
 
     for(size_t imod = 0; imod < recoOpt->fWireLabels.size(); ++imod) {
         art::InputTag const which = recoOpt->fWireLabels[imod];
@@ -157,77 +218,115 @@ void RecoBaseDrawer::Wire2D(const art::Event& evt,
 
         uint32_t channel = wires[i]->Channel();
 
-	    if (!rawOpt->fSeeBadChannels && channelStatus.IsBad(channel)) continue;
+	    if (channelConditions.isHiddenBad(channel, channelSelection)) continue;
 
-        std::vector<geo::WireID> wireids = geo->ChannelToWire(channel);
+        if (!channelWires.isOnPlane(channel, pid)) continue;
 
-        geo::SigType_t sigType = geo->SignalType(channel);
+        // the regions of interest are read in place, without expanding the
+        // waveform; points with no region of interest have no signal and are
+        // not drawn
+        recob::Wire::RegionsOfInterest_t const& signalROI = wires[i]->SignalROI();
+        if (signalROI.get_ranges().empty()) continue;
+        std::size_t const nTicks = signalROI.size();
 
-        for (auto const& wid : wireids){
+        for (auto const& wid : channelWires.Wires(channel)){
           if (wid.planeID() != pid) continue;
 
           double wire = 1.*wid.Wire;
-          double tick = 0;
-          // get the unpacked ROIs
-          std::vector<float> wirSig = wires[i]->Signal();
-          if(wirSig.size() == 0) continue;
-          // get an iterator over the adc values
-          std::vector<float>::const_iterator itr = wirSig.begin();
-          while( itr != wirSig.end() ){
-            int ticksUsed = 0;
-            double tdcsum = 0.;
-            double adcsum = 0.;
-            while(ticksUsed < ticksPerPoint && itr != wirSig.end()){
-              tdcsum  += tick;
-              adcsum  += (1.*(*itr));
-              ++ticksUsed;
-              tick += 1.;
-              itr++; // this advance of the iterator is sufficient for the external loop too
-            }
-            double adc = adcsum/ticksPerPoint;
-            double tdc = tdcsum/ticksPerPoint;
-
-            if(TMath::Abs(adc) < rawOpt->fMinSignal) continue;
-            if(tdc > rawOpt->fTicks) continue;
-
-            int    co = 0;
-            double sf = 1.;
-            double q0 = 1000.0;
-
-            co = cst->CalQ(sigType).GetColor(adc);
-            if (rawOpt->fScaleDigitsByCharge) {
-              sf = sqrt(adc/q0);
-              if (sf>1.0) sf = 1.0;
-            }
-
-            if(wire < minw) minw = wire;
-            if(wire > maxw) maxw = wire;
-            if(tdc  < mint) mint = tdc;
-            if(tdc  > maxt) maxt = tdc;
-
-            if(rawOpt->fAxisOrientation < 1){
-              TBox& b1 = view->AddBox(wire-sf*0.5,
-                                      tdc-sf*0.5*ticksPerPoint,
-                                      wire+sf*0.5,
-                                      tdc+sf*0.5*ticksPerPoint);
-              b1.SetFillStyle(1001);
-              b1.SetFillColor(co);
-              b1.SetBit(kCannotPick);
-            }
-            else{
-              TBox& b1 = view->AddBox(tdc-sf*0.5*ticksPerPoint,
-                                      wire-sf*0.5,
-                                      tdc+sf*0.5*ticksPerPoint,
-                                      wire+sf*0.5);
-              b1.SetFillStyle(1001);
-              b1.SetFillColor(co);
-              b1.SetBit(kCannotPick);
-            }
-          }// end loop over samples
+          cells.ProcessWire(wid.Wire); // points out of the grid are not added
+
+          // samples are summed into points of ticksPerPoint ticks, starting
+          // from tick 0; the last point of the waveform may be shorter
+          std::size_t point = 0;
+          double adcsum = 0.;
+          bool hasPoint = false;
+          auto const flushPoint = [&]()
+            {
+              if (!hasPoint) return;
+              std::size_t const firstTick = point * ticksPerPoint;
+              std::size_t const nPointTicks
+                = std::min<std::size_t>(ticksPerPoint, nTicks - firstTick);
+              double const tdcsum = nPointTicks * firstTick
+                + nPointTicks * (nPointTicks - 1) / 2.;
+              addPoint(wire, tdcsum/ticksPerPoint, adcsum/ticksPerPoint);
+              adcsum = 0.;
+              hasPoint = false;
+            };
+
+          for (auto const& range: signalROI.get_ranges()) {
+            std::size_t tick = range.begin_index();
+            for (float const sample: range.data()) {
+              std::size_t const samplePoint = tick++ / ticksPerPoint;
+              if (samplePoint != point) {
+                flushPoint();
+                point = samplePoint;
+              }
+              adcsum += sample;
+              hasPoint = true;
+            } // for samples
+          } // for regions of interest
+          flushPoint();
         }//end loop over wire segments
       }//end loop over wires
     }// end loop over wire module labels
 
+    evdb::ColorScale const& colorScale = cst->CalQ(geo->SignalType(pid));
+    auto const color = [&colorScale](int adc){ return colorScale.GetColor(adc); };
+    std::vector<details::BoxInfo_t> const& cellInfo = cells.Cells();
+    details::CellGridClass const& cellGrid = cells.Grid();
+    details::GridAxisClass const& wireAxis = cellGrid.WireAxis();
+    details::GridAxisClass const& tickAxis = cellGrid.TDCAxis();
+    std::size_t const nTickCells = tickAxis.NCells();
+
+    if (rawOpt->fDrawingBackend == 1) {
+      if (plane >= fWireRasters.size()) fWireRasters.resize(plane + 1);
+      if (!fWireRasters[plane]) {
+        fWireRasters[plane] = std::make_unique<ColorRaster>
+          ("RecoBaseDrawerWireRaster" + std::to_string(plane));
+      }
+      ColorRaster& raster = *(fWireRasters[plane]);
+      raster.UsePalette(cst->fConfigurationID.to_string());
+      if (swapAxes) {
+        raster.Reset(
+          nTickCells, tickAxis.Min(), tickAxis.Max(),
+          wireAxis.NCells(), wireAxis.Min(), wireAxis.Max()
+          );
+      }
+      else {
+        raster.Reset(
+          wireAxis.NCells(), wireAxis.Min(), wireAxis.Max(),
+          nTickCells, tickAxis.Min(), tickAxis.Max()
+          );
+      }
+
+      details::DrawCells(cellInfo, rawOpt->fMinSignal, color,
+        [&raster, nTickCells, swapAxes](std::size_t iCell, int co)
+        {
+          unsigned int const iWireCell = iCell / nTickCells;
+          unsigned int const iTickCell = iCell % nTickCells;
+          if (swapAxes) raster.PaintCell(iTickCell, iWireCell, co);
+          else          raster.PaintCell(iWireCell, iTickCell, co);
+        });
+    }
+    else {
+      bool const scaleByCharge = rawOpt->fScaleDigitsByCharge;
+      details::DrawCells(cellInfo, rawOpt->fMinSignal, color,
+        [view, &cellGrid, &cellInfo, scaleByCharge, swapAxes]
+        (std::size_t iCell, int co)
+        {
+          float wire1, tick1, wire2, tick2;
+          std::tie(wire1, tick1, wire2, tick2) = details::CellBox
+            (cellGrid, iCell, cellInfo[iCell].adc, scaleByCharge);
+
+          TBox& b1 = swapAxes
+            ? view->AddBox(tick1, wire1, tick2, wire2)
+            : view->AddBox(wire1, tick1, wire2, tick2);
+          b1.SetFillStyle(1001);
+          b1.SetFillColor(co);
+          b1.SetBit(kCannotPick);
+        });
+    }
+
     fWireMin[plane] = minw;
     fWireMax[plane] = maxw;
     fTimeMin[plane] = mint;
@@ -237,11 +336,10 @@ void RecoBaseDrawer::Wire2D(const art::Event& evt,
     double startTick(50.);
     double endTick((rawOpt->fTicks - 50.) * ticksPerPoint);
 
-    for(size_t wireNo = 0; wireNo < geo->Nwires(pid); wireNo++)
+    // the bad wires of the plane are found once per event
+    if (!channelSelection.seeBadChannels)
     {
-        raw::ChannelID_t channel = geo->PlaneWireToChannel(geo::WireID(rawOpt->fCryostat, rawOpt->fTPC, plane, wireNo));
-
-        if (!rawOpt->fSeeBadChannels && channelStatus.IsBad(channel))
+        for(geo::WireID::WireID_t const wireNo: channelConditions.BadWires(pid))
         {
             double wire = 1.*wireNo;
             TLine&   line = view->AddLine(wire, startTick, wire, endTick);
@@ -255,6 +353,26 @@ void RecoBaseDrawer::Wire2D(const art::Event& evt,
     return;
 }
 
+//......................................................................
+void RecoBaseDrawer::ExtractRange(TVirtualPad* pPad, std::vector<double> const* zoom)
+{
+    fRasterFrame = ColorRaster::ExtractFrame(pPad, zoom);
+}
+
+//......................................................................
+void RecoBaseDrawer::DrawWireRaster(unsigned int plane) const
+{
+    if (plane >= fWireRasters.size() || !fWireRasters[plane]) return;
+    fWireRasters[plane]->Draw();
+}
+
+//......................................................................
+void RecoBaseDrawer::ClearWireRaster(unsigned int plane)
+{
+    if (plane < fWireRasters.size() && fWireRasters[plane])
+      fWireRasters[plane]->Clear();
+}
+
 //......................................................................
 ///
 /// Render Hit objects on a 2D viewing canvas
@@ -324,7 +442,6 @@ int RecoBaseDrawer::Hit2D(std::vector<const recob::Hit*> hits,
 {
     art::ServiceHandle<evd::RawDrawingOptions const>   rawOpt;
     art::ServiceHandle<evd::RecoDrawingOptions const>  recoOpt;
-    art::ServiceHandle<geo::Geometry const>            geo;
 
     unsigned int w  = 0;
     unsigned int wold = 0;
@@ -335,15 +452,21 @@ int RecoBaseDrawer::Hit2D(std::vector<const recob::Hit*> hits,
 
     int nHitsDrawn(0);
 
+    ChannelWireMap const& channelWires = ChannelWireMap::Instance();
+    std::vector<geo::WireID> wireIDs;
+
     for(const auto& hit : hits)
     {
         // Note that the WireID in the hit object is useless for those detectors where a channel can correspond to
         // more than one plane/wire. So our plan is to recover the list of wire IDs from the channel number and
         // loop over those (if there are any)
         // However, we need to preserve the option for drawing hits only associated to the wireID it contains
-        std::vector<geo::WireID> wireIDs;
+        wireIDs.clear();
 
-        if (allWireIDs) wireIDs = geo->ChannelToWire(hit->Channel());
+        if (allWireIDs) {
+            auto const channelWireIDs = channelWires.Wires(hit->Channel());
+            wireIDs.assign(channelWireIDs.begin(), channelWireIDs.end());
+        }
         else            wireIDs.push_back(hit->WireID());
 
         // Loop to find match
@@ -764,7 +887,7 @@ void RecoBaseDrawer::Seed2D(const art::Event& evt,
       art::PtrVector<recob::Slice> slices;
       this->GetSlices(evt, which, slices);
       if(slices.size() < 1) continue;
-      art::FindMany<recob::Hit> fmh(slices, evt, which);
+      auto const& fmh = AssociationCache::Instance().FindMany<recob::Hit>(evt, which, slices, which);
       for(size_t isl = 0; isl < slices.size(); ++isl) {
         int slcID(std::abs(slices[isl]->ID()));
         int color(evd::kColor[slcID%evd::kNCOLS]);
@@ -867,7 +990,7 @@ void RecoBaseDrawer::Cluster2D(const art::Event& evt,
         if (spacePointVec.size() > 0)
         {
             // Add the relations to recover associations cluster hits
-            art::FindManyP<recob::Hit> spHitAssnVec(spacePointVec, evt, which);
+            auto const& spHitAssnVec = AssociationCache::Instance().FindManyP<recob::Hit>(evt, which, spacePointVec, which);
 
             if (spHitAssnVec.isValid())
             {
@@ -897,8 +1020,8 @@ void RecoBaseDrawer::Cluster2D(const art::Event& evt,
         }
 
         // Ok, now proceed with our normal processing of hits on clusters
-        art::FindMany<recob::Hit> fmh(clust, evt, which);
-        art::FindManyP<recob::PFParticle> fmc(clust, evt, which);
+        auto const& fmh = AssociationCache::Instance().FindMany<recob::Hit>(evt, which, clust, which);
+        auto const& fmc = AssociationCache::Instance().FindManyP<recob::PFParticle>(evt, which, clust, which);
 
         for (size_t ic = 0; ic < clust.size(); ++ic)
         {
@@ -1421,10 +1544,10 @@ void RecoBaseDrawer::Prong2D(const art::Event& evt,
 
             if(track.vals().size() < 1) continue;
 
-            art::FindMany<recob::Hit> fmh(track, evt, which);
+            auto const& fmh = AssociationCache::Instance().FindMany<recob::Hit>(evt, which, track, which);
 
             art::InputTag const whichTag( recoOpt->fCosmicTagLabels.size() > imod ? recoOpt->fCosmicTagLabels[imod] : "");
-            art::FindManyP<anab::CosmicTag> cosmicTrackTags( track, evt, whichTag );
+            auto const& cosmicTrackTags = AssociationCache::Instance().FindManyP<anab::CosmicTag>(evt, which, track, whichTag);
 
 	    auto tracksProxy = proxy::getCollection<proxy::Tracks>(evt, which);
 
@@ -1521,7 +1644,7 @@ void RecoBaseDrawer::Prong2D(const art::Event& evt,
             this->GetShowers(evt, which, shower);
             if(shower.vals().size() < 1) continue;
 
-            art::FindMany<recob::Hit>     fmh(shower, evt, which);
+            auto const& fmh = AssociationCache::Instance().FindMany<recob::Hit>(evt, which, shower, which);
 
             // loop over the prongs and get the clusters and hits associated with
             // them.  only keep those that are in this view
@@ -1641,9 +1764,9 @@ void RecoBaseDrawer::DrawTrackVertexAssns2D(const art::Event& evt,
         if (vertexTrackAssnsHandle->size() < 1) continue;
 
         // Get the rest of the associations in the standard way
-        art::FindMany<recob::Hit> fmh(trackCol, evt, which);
+        auto const& fmh = AssociationCache::Instance().FindMany<recob::Hit>(evt, which, trackCol, which);
 
-        art::FindManyP<anab::CosmicTag> cosmicTrackTags( trackCol, evt, recoOpt->fTrkVtxCosmicLabels[imod] );
+        auto const& cosmicTrackTags = AssociationCache::Instance().FindManyP<anab::CosmicTag>(evt, which, trackCol, recoOpt->fTrkVtxCosmicLabels[imod]);
 
 	auto tracksProxy = proxy::getCollection<proxy::Tracks>(evt, which);
 
@@ -1836,7 +1959,7 @@ void RecoBaseDrawer::Event2D(const art::Event& evt,
 
             if(event.size() < 1) continue;
 
-            art::FindMany<recob::Hit> fmh(event, evt, which);
+            auto const& fmh = AssociationCache::Instance().FindMany<recob::Hit>(evt, which, event, which);
 
             for(size_t e = 0; e < event.size(); ++e){
                 std::vector<const recob::Hit*> hits;
@@ -2041,27 +2164,28 @@ void RecoBaseDrawer::PFParticle3D(const art::Event& evt,
         if (spacePointVec.empty()) continue;
 
         // Add the relations to recover associations cluster hits
-        art::FindManyP<recob::SpacePoint> edgeSpacePointAssnsVec(edgeVec, evt, assns);
-        art::FindManyP<recob::SpacePoint> spacePointAssnVec(pfParticleVec, evt, assns);
-        art::FindManyP<recob::Hit>        spHitAssnVec(spacePointVec, evt, assns);
-        art::FindManyP<recob::Edge>       edgeAssnsVec(pfParticleVec, evt, assns);
+        AssociationCache& assnCache = AssociationCache::Instance();
+        auto const& edgeSpacePointAssnsVec = assnCache.FindManyP<recob::SpacePoint>(evt, assns, edgeVec, assns);
+        auto const& spacePointAssnVec = assnCache.FindManyP<recob::SpacePoint>(evt, which, pfParticleVec, assns);
+        auto const& spHitAssnVec = assnCache.FindManyP<recob::Hit>(evt, assns, spacePointVec, assns);
+        auto const& edgeAssnsVec = assnCache.FindManyP<recob::Edge>(evt, which, pfParticleVec, assns);
 
         // If no valid space point associations then nothing to do
         if (!spacePointAssnVec.isValid()) continue;
 
         // Need the PCA info as well
-        art::FindMany<recob::PCAxis> pcAxisAssnVec(pfParticleVec, evt, which);
+        auto const& pcAxisAssnVec = assnCache.FindMany<recob::PCAxis>(evt, which, pfParticleVec, which);
 
         // Want CR tagging info
         // Note the cosmic tags come from a different producer - we assume that the producers are
         // matched in the fcl label vectors!
         art::InputTag cosmicTagLabel = imod < recoOpt->fCosmicTagLabels.size() ? recoOpt->fCosmicTagLabels[imod] : "";
-        art::FindMany<anab::CosmicTag> pfCosmicAssns(pfParticleVec, evt, cosmicTagLabel);
+        auto const& pfCosmicAssns = assnCache.FindMany<anab::CosmicTag>(evt, which, pfParticleVec, cosmicTagLabel);
 
         // We also want to drive display of tracks but have the same issue with production... so follow the
         // same prescription.
         art::InputTag trackTagLabel = imod < recoOpt->fTrackLabels.size() ? recoOpt->fTrackLabels[imod] : "";
-        art::FindMany<recob::Track> pfTrackAssns(pfParticleVec, evt, trackTagLabel);
+        auto const& pfTrackAssns = assnCache.FindMany<recob::Track>(evt, which, pfParticleVec, trackTagLabel);
 
         // Commence looping over possible clusters
         for(size_t idx = 0; idx < pfParticleVec.size(); idx++)
@@ -2555,7 +2679,7 @@ void RecoBaseDrawer::Prong3D(const art::Event& evt,
             trackView.fill(trackVec);
 
             art::InputTag const cosmicTagLabel(recoOpt->fCosmicTagLabels.size() > imod ? recoOpt->fCosmicTagLabels[imod] : "");
-            art::FindMany<anab::CosmicTag> cosmicTagAssnVec(trackVec, evt, cosmicTagLabel);
+            auto const& cosmicTagAssnVec = AssociationCache::Instance().FindMany<anab::CosmicTag>(evt, which, trackVec, cosmicTagLabel);
 
             for(const auto& track : trackVec)
             {
@@ -2635,7 +2759,7 @@ void RecoBaseDrawer::DrawTrack3D(const recob::Track& track,
 	        if(handle.isValid())
             {
 	            const std::string& which = handle.provenance()->moduleLabel();
-	            art::FindManyP<recob::SpacePoint> fmsp(handle, *evt, which);
+	            auto const& fmsp = AssociationCache::Instance().FindManyP<recob::SpacePoint>(*evt, handle.provenance()->inputTag(), handle, which);
 
                 if (fmsp.isValid() && fmsp.size() > 0)
                 {
@@ -2750,7 +2874,7 @@ void RecoBaseDrawer::DrawShower3D(const recob::Shower& shower,
       if(handle.isValid()) {
 
         const std::string& which = handle.provenance()->moduleLabel();
-        art::FindManyP<recob::SpacePoint> fmsp(handle, *evt, which);
+        auto const& fmsp = AssociationCache::Instance().FindManyP<recob::SpacePoint>(*evt, handle.provenance()->inputTag(), handle, which);
 
         int n = handle->size();
         for(int i=0; i<n; ++i) {
@@ -2849,8 +2973,8 @@ void RecoBaseDrawer::Vertex3D(const art::Event& evt,
 	art::PtrVector<recob::Vertex> vertex;
 	this->GetVertices(evt, which, vertex);
 
-	art::FindManyP<recob::Track>  fmt(vertex, evt, which);
-	art::FindManyP<recob::Shower> fms(vertex, evt, which);
+	auto const& fmt = AssociationCache::Instance().FindManyP<recob::Track>(evt, which, vertex, which);
+	auto const& fms = AssociationCache::Instance().FindManyP<recob::Shower>(evt, which, vertex, which);
 
 	for(size_t v = 0; v < vertex.size(); ++v){
 
@@ -2902,8 +3026,8 @@ void RecoBaseDrawer::Event3D(const art::Event& evt,
 
 	if(event.size() < 1) continue;
 
-	art::FindManyP<recob::Vertex> fmvp(event, evt, which);
-	art::FindMany<recob::Vertex>  fmv(event, evt, which);
+	auto const& fmvp = AssociationCache::Instance().FindManyP<recob::Vertex>(evt, which, event, which);
+	auto const& fmv = AssociationCache::Instance().FindMany<recob::Vertex>(evt, which, event, which);
 
 	for(size_t e = 0; e < event.size(); ++e){
 
@@ -2959,7 +3083,7 @@ void RecoBaseDrawer::Slice3D(const art::Event& evt,
     art::PtrVector<recob::Slice> slices;
     this->GetSlices(evt, which, slices);
     if(slices.size() < 1) continue;
-    art::FindManyP<recob::SpacePoint> fmsp(slices, evt, which);
+    auto const& fmsp = AssociationCache::Instance().FindManyP<recob::SpacePoint>(evt, which, slices, which);
     for(size_t isl = 0; isl < slices.size(); ++isl) {
       int slcID = std::abs(slices[isl]->ID());
       int color = evd::kColor[slcID%evd::kNCOLS];
@@ -3154,13 +3278,13 @@ void RecoBaseDrawer::PFParticleOrtho(const art::Event& evt,
         if (pfParticleVec.size() < 1) continue;
 
         // Add the relations to recover associations cluster hits
-        art::FindMany<recob::SpacePoint> spacePointAssnVec(pfParticleVec, evt, which);
+        auto const& spacePointAssnVec = AssociationCache::Instance().FindMany<recob::SpacePoint>(evt, which, pfParticleVec, which);
 
         // If no valid space point associations then nothing to do
         if (!spacePointAssnVec.isValid()) continue;
 
         // Need the PCA info as well
-        art::FindMany<recob::PCAxis> pcAxisAssnVec(pfParticleVec, evt, which);
+        auto const& pcAxisAssnVec = AssociationCache::Instance().FindMany<recob::PCAxis>(evt, which, pfParticleVec, which);
 
         if (!pcAxisAssnVec.isValid()) continue;
 
@@ -3586,7 +3710,7 @@ void RecoBaseDrawer::DrawTrackOrtho(const recob::Track& track,
 	const art::Handle<std::vector<recob::Track> > handle = ih;
 	if(handle.isValid()) {
 	  const std::string& which = handle.provenance()->moduleLabel();
-	  art::FindManyP<recob::SpacePoint> fmsp(handle, *evt, which);
+	  auto const& fmsp = AssociationCache::Instance().FindManyP<recob::SpacePoint>(*evt, handle.provenance()->inputTag(), handle, which);
 
 	  int n = handle->size();
 	  for(int i=0; i<n; ++i) {
@@ -3677,7 +3801,7 @@ void RecoBaseDrawer::DrawShowerOrtho(const recob::Shower& shower,
         const art::Handle<std::vector<recob::Shower> > handle = ih;
         if(handle.isValid()) {
             const std::string& which = handle.provenance()->moduleLabel();
-            art::FindManyP<recob::SpacePoint> fmsp(handle, *evt, which);
+            auto const& fmsp = AssociationCache::Instance().FindManyP<recob::SpacePoint>(*evt, handle.provenance()->inputTag(), handle, which);
             if (!fmsp.isValid()) continue;
             int n = handle->size();
             for(int i=0; i<n; ++i) {
@@ -3743,29 +3867,15 @@ int RecoBaseDrawer::GetHits(const art::Event&               evt,
                             unsigned int                    plane)
 {
     art::ServiceHandle<evd::RawDrawingOptions const> rawOpt;
-    art::ServiceHandle<geo::Geometry const>          geo;
 
     hits.clear();
 
-    std::vector<const recob::Hit*> temp;
-
     try{
-        evt.getView(which, temp);
-        for(const auto& hit : temp)
-        {
-            // Note that the WireID in the hit object is useless for those detectors where a channel can correspond to
-            // more than one plane/wire. So our plan is to recover the list of wire IDs from the channel number and
-            // loop over those (if there are any)
-            const std::vector<geo::WireID>& wireIDs = geo->ChannelToWire(hit->Channel());
-
-            // Loop to find match
-            for(const auto& wireID : wireIDs)
-            {
-                if( wireID.Plane    == plane        &&
-                    wireID.TPC      == rawOpt->fTPC &&
-                    wireID.Cryostat == rawOpt->fCryostat) hits.push_back(hit);
-            }
-        }
+        // Note that the WireID in the hit object is useless for those detectors where a channel can correspond to
+        // more than one plane/wire. So the index lists each hit on all the wire IDs from its channel number
+        // (it is built once per event, and the hits come sorted by wire and time)
+        geo::PlaneID const pid(rawOpt->fCryostat, rawOpt->fTPC, plane);
+        hits = EventHitIndex().PlaneHits(evt, which, pid);
     }
     catch(cet::exception& e){
         writeErrMsg("GetHits", e);
@@ -4046,11 +4156,11 @@ int RecoBaseDrawer::CountHits(const art::Event&    evt,
                               unsigned int         tpc,
                               unsigned int         plane)
 {
-    std::vector<const recob::Hit*> temp;
     int NumberOfHitsBeforeThisPlane=0;
-      evt.getView(which, temp);   //temp.size() = total number of hits for this event (number of all hits in all Cryostats, TPC's, planes and wires)
+      // total number of hits for this event (number of all hits in all Cryostats, TPC's, planes and wires)
+      std::vector<recob::Hit> const& temp = EventHitIndex().Hits(evt, which);
       for(size_t t = 0; t < temp.size(); ++t){
-	if( temp[t]->WireID().Cryostat == cryostat&& temp[t]->WireID().TPC == tpc && temp[t]->WireID().Plane == plane ) break;
+	if( temp[t].WireID().Cryostat == cryostat&& temp[t].WireID().TPC == tpc && temp[t].WireID().Plane == plane ) break;
 	NumberOfHitsBeforeThisPlane++;
       }
     return NumberOfHitsBeforeThisPlane;
@@ -4073,6 +4183,11 @@ void RecoBaseDrawer::FillTQHisto(const art::Event& evt,
     // Check if we're supposed to draw raw hits at all
     if(rawOpt->fDrawRawDataOrCalibWires==0) return;
 
+    // the channel of the wire is the only one to look for
+    geo::WireID const wireID(rawOpt->fCryostat, rawOpt->fTPC, plane, wire);
+    if(!geo->HasWire(wireID)) return;
+    raw::ChannelID_t const channel = geo->PlaneWireToChannel(wireID);
+
     for (size_t imod = 0; imod < recoOpt->fWireLabels.size(); ++imod)
     {
         art::InputTag const which = recoOpt->fWireLabels[imod];
@@ -4082,19 +4197,8 @@ void RecoBaseDrawer::FillTQHisto(const art::Event& evt,
 
         for (size_t i = 0; i < wires.size(); ++i)
         {
-
-            std::vector<geo::WireID> wireids = geo->ChannelToWire(wires[i]->Channel());
-
-            bool goodWID = false;
-            for( auto const& wid : wireids )
-            {
-                // check for correct plane, wire and tpc
-                if(wid.Plane    == plane        &&
-                   wid.Wire     == wire         &&
-                   wid.TPC      == rawOpt->fTPC &&
-                   wid.Cryostat == rawOpt->fCryostat) goodWID = true;
-            }
-            if(!goodWID) continue;
+            // check for correct plane, wire and tpc
+            if(wires[i]->Channel() != channel) continue;
 
             std::vector<float> wirSig = wires[i]->Signal();
             for(unsigned int ii = 0; ii < wirSig.size(); ++ii)
@@ -4125,11 +4229,13 @@ void RecoBaseDrawer::FillQHisto(const art::Event& evt,
 {
     art::ServiceHandle<evd::RawDrawingOptions const>   rawOpt;
     art::ServiceHandle<evd::RecoDrawingOptions const>  recoOpt;
-    art::ServiceHandle<geo::Geometry const>            geo;
 
     // Check if we're supposed to draw raw hits at all
     if(rawOpt->fDrawRawDataOrCalibWires==0) return;
 
+    geo::PlaneID const pid(rawOpt->fCryostat, rawOpt->fTPC, plane);
+    ChannelWireMap const& channelWires = ChannelWireMap::Instance();
+
     for (size_t imod = 0; imod < recoOpt->fWireLabels.size(); ++imod) {
         art::InputTag const which = recoOpt->fWireLabels[imod];
 
@@ -4138,16 +4244,8 @@ void RecoBaseDrawer::FillQHisto(const art::Event& evt,
 
         for (unsigned int i=0; i<wires.size(); ++i) {
 
-            std::vector<geo::WireID> wireids = geo->ChannelToWire(wires[i]->Channel());
-
-            bool goodWID = false;
-            for( auto const& wid : wireids ){
-                // check for correct plane, wire and tpc
-                if(wid.Plane    == plane        &&
-                   wid.TPC      == rawOpt->fTPC &&
-                   wid.Cryostat == rawOpt->fCryostat) goodWID = true;
-            }
-            if(!goodWID) continue;
+            // check for correct plane, wire and tpc
+            if(!channelWires.isOnPlane(wires[i]->Channel(), pid)) continue;
             std::vector<float> wirSig = wires[i]->Signal();
             for(unsigned int ii = 0; ii < wirSig.size(); ++ii)
                 histo->Fill(wirSig[ii]);
@@ -4183,6 +4281,11 @@ void RecoBaseDrawer::FillTQHistoDP(const art::Event&    evt,
     // Check if we're supposed to draw raw hits at all
     if(rawOpt->fDrawRawDataOrCalibWires==0) return;
 
+    // the channel of the wire is the only one to look for
+    geo::WireID const wireID(rawOpt->fCryostat, rawOpt->fTPC, plane, wire);
+    raw::ChannelID_t const channel = geo->HasWire(wireID)
+      ? geo->PlaneWireToChannel(wireID): raw::InvalidChannelID;
+
     for (size_t imod = 0; imod < recoOpt->fWireLabels.size(); ++imod) {
         art::InputTag const which = recoOpt->fWireLabels[imod];
 
@@ -4191,17 +4294,7 @@ void RecoBaseDrawer::FillTQHistoDP(const art::Event&    evt,
 
         for (size_t i = 0; i < wires.size(); ++i) {
 
-            std::vector<geo::WireID> wireids = geo->ChannelToWire(wires[i]->Channel());
-
-            bool goodWID = false;
-            for( auto const& wid : wireids ){
-                if(wid.Plane    == plane        &&
-                   wid.Wire     == wire         &&
-                   wid.TPC      == rawOpt->fTPC &&
-                   wid.Cryostat == rawOpt->fCryostat) goodWID = true;
-            }
-
-            if(!goodWID) continue;
+            if(wires[i]->Channel() != channel) continue;
 
             std::vector<float> wirSig = wires[i]->Signal();
             for(unsigned int ii = 0; ii < wirSig.size(); ++ii)
@@ -4220,16 +4313,16 @@ void RecoBaseDrawer::FillTQHistoDP(const art::Event&    evt,
         auto hitResults = anab::FVectorReader<recob::Hit, 4>::create(evt, "dprawhit");
         const auto & fitParams = hitResults->vectors();
 
-        int FitParamsOffset = CountHits(evt, which, rawOpt->fCryostat, rawOpt->fTPC, plane);
-
         for (size_t i = 0; i < hits.size(); ++i){
             // check for correct wire. Plane, cryostat and tpc were checked in GetHits
             if(hits[i]->WireID().Wire != wire) continue;
 
-            hpeaktimes.push_back(fitParams[FitParamsOffset+i][0]);
-            htau1.push_back(fitParams[FitParamsOffset+i][1]);
-            htau2.push_back(fitParams[FitParamsOffset+i][2]);
-            hitamplitudes.push_back(fitParams[FitParamsOffset+i][3]);
+            // fit parameters follow the order of the hit collection
+            size_t const iFit = EventHitIndex().HitPosition(evt, which, *hits[i]);
+            hpeaktimes.push_back(fitParams[iFit][0]);
+            htau1.push_back(fitParams[iFit][1]);
+            htau2.push_back(fitParams[iFit][2]);
+            hitamplitudes.push_back(fitParams[iFit][3]);
             hstartT.push_back(hits[i]->StartTick());
             hendT.push_back(hits[i]->EndTick());
             hNMultiHit.push_back(hits[i]->Multiplicity());
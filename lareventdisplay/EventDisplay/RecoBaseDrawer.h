@@ -13,12 +13,14 @@
 #include "canvas/Persistency/Common/FindMany.h"
 #include "canvas/Persistency/Common/FindManyP.h"
 
+#include "lareventdisplay/EventDisplay/ColorRaster.h"
 #include "lareventdisplay/EventDisplay/OrthoProj.h"
 #include "lardataobj/RecoBase/SpacePoint.h"
 #include "lardataobj/RecoBase/Slice.h"
 
 class TVector3;
 class TH1F;
+class TVirtualPad;
 namespace evdb {
     class View2D;
     class View3D;
@@ -63,6 +65,12 @@ public:
     void Wire2D(const art::Event& evt,
                 evdb::View2D*     view,
 		        unsigned int      plane);
+    /// Takes the extent of the raster of Wire2D() from the specified pad
+    void ExtractRange(TVirtualPad* pPad, std::vector<double> const* zoom = nullptr);
+    /// Draws the raster filled by Wire2D() (if any) into the current pad
+    void DrawWireRaster(unsigned int plane) const;
+    /// Forgets the raster filled by Wire2D(), which will not be drawn any more
+    void ClearWireRaster(unsigned int plane);
     int  Hit2D(const art::Event& evt,
 	           evdb::View2D*     view,
 	           unsigned int      plane);
@@ -349,6 +357,9 @@ public:
     std::vector<double>       fRawCharge;       ///< Sum of Raw Charge
     std::vector<double>       fConvertedCharge; ///< Sum of Charge Converted using Birks' formula
 
+    ColorRaster::Frame_t      fRasterFrame;     ///< extent of the pad for the raster backend
+    std::vector<std::unique_ptr<ColorRaster>> fWireRasters; ///< rasters of calibrated wires, per plane
+
   };
 }
 
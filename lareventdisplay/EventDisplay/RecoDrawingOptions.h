@@ -54,6 +54,7 @@ public:
     bool fDrawTrackVertexAssns;
     bool fDraw3DSpacePoints;
     bool fDraw3DSpacePointHeatMap;
+    unsigned int fSpacePoint3DBudget;                       ///< most space points drawn at full resolution in 3D (0: all)
     bool fDraw3DEdges;
     bool fDraw3DPCAAxes;
     bool fDrawAllWireIDs;
@@ -98,6 +99,8 @@ public:
     fhicl::ParameterSet        fAllSpacePointDrawerParams;  ///< FHICL parameters for SpacePoint drawing
     
     fhicl::ParameterSet        f3DDrawerParams;             ///< FHICL paramegers for the 3D drawers
+
+    fhicl::ParameterSetID      fConfigurationID;            ///< ID of the configuration last applied by reconfigure()
   };
 }//namespace
 #endif // __CINT__
@@ -48,6 +48,7 @@ void RecoDrawingOptions::reconfigure(fhicl::ParameterSet const& pset)
     fDrawTrackVertexAssns      = pset.get< bool                       >("DrawTrackVertexAssns"     );
     fDraw3DSpacePoints         = pset.get< bool                       >("Draw3DSpacePoints"        );
     fDraw3DSpacePointHeatMap   = pset.get< bool                       >("Draw3DSpacePointHeatMap"  );
+    fSpacePoint3DBudget        = pset.get< unsigned int               >("SpacePoint3DBudget",     0);
     fDraw3DEdges               = pset.get< bool                       >("Draw3DEdges"              );
     fDraw3DPCAAxes             = pset.get< bool                       >("Draw3DPCAAxes"            );
     fDrawAllWireIDs            = pset.get< bool                       >("DrawAllWireIDs"           );
@@ -90,6 +91,8 @@ void RecoDrawingOptions::reconfigure(fhicl::ParameterSet const& pset)
     fAllSpacePointDrawerParams = pset.get< fhicl::ParameterSet        >("AllSpacePointDrawer"      );
     
     f3DDrawerParams            = pset.get< fhicl::ParameterSet        >("Reco3DDrawers"            );
+
+    fConfigurationID           = pset.id();
   }
 
   DEFINE_ART_SERVICE(RecoDrawingOptions)
@@ -14,9 +14,7 @@
 
 #include "nusimdata/SimulationBase/MCTruth.h"
 #include "nusimdata/SimulationBase/MCParticle.h"
-#include "larsim/Simulation/LArVoxelData.h"
-#include "larsim/Simulation/LArVoxelList.h"
-#include "larsim/Simulation/SimListUtils.h"
+#include "lareventdisplay/EventDisplay/MCVoxelIndex.h"
 #include "lareventdisplay/EventDisplay/Style.h"
 
 #include "larcore/Geometry/Geometry.h"
@@ -87,21 +85,13 @@ void DrawLArVoxel3D::Draw(const art::Event& evt, evdb::View3D* view) const
     int neutrinoColor(38);
 
     // Use the LArVoxelList to get the true energy deposition locations as opposed to using MCTrajectories
-    const sim::LArVoxelList voxels = sim::SimListUtils::GetLArVoxelList(evt,drawOpt->fSimChannelLabel.encode());
-
-    mf::LogDebug("SimulationDrawer") << "Starting loop over " << mcParticleHandle->size() << " McParticles, voxel list size is " << voxels.size() << std::endl;
-
     // Using the voxel information can be slow (see previous implementation of this code).
     // In order to speed things up we have modified the strategy:
-    // 1) Make one pass through the list of voxels
-    // 2) For each voxel, keep track of the MCParticle contributing energy to it and it's position
-    //    which is done by keeping a map between the MCParticle and a vector of positions
-    // 3) Then loop through the map to draw the particle trajectories.
-    // One caveat is the need for MCParticles... and the voxels contain the track ids. So we'll need one
-    // more loop to make a map of track id's and MCParticles.
-
-    // First up is to build the map between track id's and associated MCParticles so we can recover when looping over voxels
-    std::map<int, const simb::MCParticle*> trackToMcParticleMap;
+    // 1) The energy deposits of the voxels are assigned to the MCParticles by track id, in one (parallel)
+    //    pass through the list of voxels, and kept grouped by MCParticle (see evd::MCVoxelIndex)
+    // 2) This is done once per event: redrawing, or changing the drawing options, reuses them
+    // 3) Then loop through the MCParticles to draw the particle trajectories.
+    mf::LogDebug("SimulationDrawer") << "Starting loop over " << mcParticleHandle->size() << " McParticles" << std::endl;
 
     // Should we display the trajectories too?
     double minPartEnergy(0.01);
@@ -110,8 +100,6 @@ void DrawLArVoxel3D::Draw(const art::Event& evt, evdb::View3D* view) const
     {
         art::Ptr<simb::MCParticle> mcParticle(mcParticleHandle,p);
 
-        trackToMcParticleMap[mcParticle->TrackId()] = mcParticle.get();
-
         // Quick loop through to draw trajectories...
         if (drawOpt->fShowMCTruthTrajectories)
         {
@@ -207,43 +195,22 @@ void DrawLArVoxel3D::Draw(const art::Event& evt, evdb::View3D* view) const
         }
     }
 
-    // Now we set up and build the map between MCParticles and a vector of positions obtained from the voxels
-    std::map<const simb::MCParticle*, std::vector<std::vector<double> > > partToPosMap;
+    // Now recover the positions of the voxels each MCParticle deposited energy in
+    std::vector<const simb::MCParticle*> particles;
+    particles.reserve(mcParticleHandle->size());
+    for(const simb::MCParticle& mcParticle : *mcParticleHandle) particles.push_back(&mcParticle);
 
-    sim::LArVoxelList::const_iterator vxitr;
-    for(vxitr = voxels.begin(); vxitr != voxels.end(); vxitr++)
-    {
-        const sim::LArVoxelData &vxd = (*vxitr).second;
-
-        for(size_t partIdx = 0; partIdx < vxd.NumberParticles(); partIdx++)
-        {
-            if(vxd.Energy(partIdx) > drawOpt->fMinEnergyDeposition)
-            {
-                int trackId = vxd.TrackID(partIdx);
+    const evd::MCVoxelIndex::Deposits_t& deposits = evd::MCVoxelIndex::Instance().Deposits(evt, drawOpt->fSimChannelLabel.encode(), drawOpt->fG4ModuleLabel.encode(), particles);
 
-                // It can be in some instances that mcPart here could be zero.
-                const simb::MCParticle* mcPart = trackToMcParticleMap[trackId];
-
-                partToPosMap[mcPart].push_back(std::vector<double>(3));
-
-                partToPosMap[mcPart].back()[0] = vxd.VoxelID().X();
-                partToPosMap[mcPart].back()[1] = vxd.VoxelID().Y();
-                partToPosMap[mcPart].back()[2] = vxd.VoxelID().Z();
-            }
-        } // end if this track id is in the current voxel
-    }// end loop over voxels
-
-    // Finally ready for the main event! Simply loop through the map between MCParticle and positions to
+    // Finally ready for the main event! Simply loop through the MCParticles and their positions to
     // draw the trajectories
-    std::map<const simb::MCParticle*, std::vector<std::vector<double> > >::iterator partToPosMapItr;
-
-    for(partToPosMapItr = partToPosMap.begin(); partToPosMapItr != partToPosMap.end(); partToPosMapItr++)
+    for(size_t partIdx = 0; partIdx < deposits.NParticles(); partIdx++)
     {
         // Recover the McParticle, we'll need to access several data members so may as well dereference it
-        const simb::MCParticle* mcPart = partToPosMapItr->first;
+        const simb::MCParticle* mcPart = deposits.particles[partIdx];
 
         // Apparently, it can happen that we get a null pointer here or maybe no points to plot
-        if (!mcPart || partToPosMapItr->second.empty()) continue;
+        if (!mcPart || deposits.Begin(partIdx) == deposits.End(partIdx)) continue;
 
         // The following is meant to get the correct offset for drawing the particle trajectory
         // In particular, the cosmic rays will not be correctly placed without this
@@ -266,13 +233,15 @@ void DrawLArVoxel3D::Draw(const art::Event& evt, evdb::View3D* view) const
             markerSize = 1;
         }
 
-        std::unique_ptr<double[]> hitPositions(new double[3*partToPosMapItr->second.size()]);
+        std::unique_ptr<double[]> hitPositions(new double[3*(deposits.End(partIdx) - deposits.Begin(partIdx))]);
         int                       hitCount(0);
 
         // Now loop over points and add to trajectory
-        for(size_t posIdx = 0; posIdx < partToPosMapItr->second.size(); posIdx++)
+        for(size_t posIdx = deposits.Begin(partIdx); posIdx < deposits.End(partIdx); posIdx++)
         {
-            const std::vector<double>& posVec = partToPosMapItr->second[posIdx];
+            if (deposits.energy[posIdx] <= drawOpt->fMinEnergyDeposition) continue;
+
+            const double posVec[3] = {deposits.x[posIdx], deposits.y[posIdx], deposits.z[posIdx]};
 
             // Check xOffset state and set if necessary
             geo::Point_t hitLocation(posVec[0],posVec[1],posVec[2]);
@@ -303,6 +272,9 @@ void DrawLArVoxel3D::Draw(const art::Event& evt, evdb::View3D* view) const
             }
         }
 
+        // All the deposits might be below threshold
+        if (hitCount == 0) continue;
+
         TPolyMarker3D& pm = view->AddPolyMarker3D(1, colorIdx, markerIdx, markerSize);
         pm.SetPolyMarker(hitCount, hitPositions.get(), markerIdx);
     }
@@ -21,15 +21,13 @@
 #include "lardata/DetectorInfoServices/DetectorClocksService.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lardataalg/DetectorInfo/DetectorProperties.h"
+#include "lareventdisplay/EventDisplay/MCVoxelIndex.h"
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/SimulationDrawer.h"
 #include "lareventdisplay/EventDisplay/SimulationDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/Style.h"
 #include "larevt/SpaceChargeServices/SpaceChargeService.h"
 #include "larsim/MCCheater/ParticleInventoryService.h"
-#include "larsim/Simulation/LArVoxelData.h"
-#include "larsim/Simulation/LArVoxelList.h"
-#include "larsim/Simulation/SimListUtils.h"
 #include "nusimdata/SimulationBase/MCParticle.h"
 #include "nusimdata/SimulationBase/MCTruth.h"
 #include "nuevdb/EventDisplayBase/View2D.h"
@@ -374,29 +372,19 @@ void SimulationDrawer::MCTruth3D(const art::Event& evt,
     int neutrinoColor(38);
 
     // Use the LArVoxelList to get the true energy deposition locations as opposed to using MCTrajectories
-    const sim::LArVoxelList voxels = sim::SimListUtils::GetLArVoxelList(evt,drawopt->fG4ModuleLabel.label());
-
-    mf::LogDebug("SimulationDrawer") << "Starting loop over " << plist.size() << " McParticles, voxel list size is " << voxels.size() << std::endl;
-
     // Using the voxel information can be slow (see previous implementation of this code).
     // In order to speed things up we have modified the strategy:
-    // 1) Make one pass through the list of voxels
-    // 2) For each voxel, keep track of the MCParticle contributing energy to it and it's position
-    //    which is done by keeping a map between the MCParticle and a vector of positions
-    // 3) Then loop through the map to draw the particle trajectories.
-    // One caveat is the need for MCParticles... and the voxels contain the track ids. So we'll need one
-    // more loop to make a map of track id's and MCParticles.
-
-    // First up is to build the map between track id's and associated MCParticles so we can recover when looping over voxels
-    std::map<int, const simb::MCParticle*> trackToMcParticleMap;
+    // 1) The energy deposits of the voxels are assigned to the MCParticles by track id, in one (parallel)
+    //    pass through the list of voxels, and kept grouped by MCParticle (see evd::MCVoxelIndex)
+    // 2) This is done once per event: redrawing, or changing the drawing options, reuses them
+    // 3) Then loop through the MCParticles to draw the particle trajectories.
+    mf::LogDebug("SimulationDrawer") << "Starting loop over " << plist.size() << " McParticles" << std::endl;
 
     // Should we display the trajectories too?
     double minPartEnergy(0.01);
 
     for(size_t p = 0; p < plist.size(); ++p)
     {
-        trackToMcParticleMap[plist[p]->TrackId()] = plist[p];
-
         // Quick loop through to draw trajectories...
         if (drawopt->fShowMCTruthTrajectories)
         {
@@ -493,43 +481,18 @@ void SimulationDrawer::MCTruth3D(const art::Event& evt,
         }
     }
 
-    // Now we set up and build the map between MCParticles and a vector of positions obtained from the voxels
-    std::map<const simb::MCParticle*, std::vector<std::vector<double> > > partToPosMap;
-
-    sim::LArVoxelList::const_iterator vxitr;
-    for(vxitr = voxels.begin(); vxitr != voxels.end(); vxitr++)
-    {
-        const sim::LArVoxelData &vxd = (*vxitr).second;
-
-        for(size_t partIdx = 0; partIdx < vxd.NumberParticles(); partIdx++)
-        {
-            if(vxd.Energy(partIdx) > drawopt->fMinEnergyDeposition)
-            {
-                int trackId = vxd.TrackID(partIdx);
-
-                // It can be in some instances that mcPart here could be zero.
-                const simb::MCParticle* mcPart = trackToMcParticleMap[trackId];
-
-                partToPosMap[mcPart].push_back(std::vector<double>(3));
-
-                partToPosMap[mcPart].back()[0] = vxd.VoxelID().X();
-                partToPosMap[mcPart].back()[1] = vxd.VoxelID().Y();
-                partToPosMap[mcPart].back()[2] = vxd.VoxelID().Z();
-            }
-        } // end if this track id is in the current voxel
-    }// end loop over voxels
+    // Now recover the positions of the voxels each MCParticle deposited energy in
+    const evd::MCVoxelIndex::Deposits_t& deposits = evd::MCVoxelIndex::Instance().Deposits(evt, drawopt->fG4ModuleLabel.label(), drawopt->fG4ModuleLabel.encode(), plist);
 
-    // Finally ready for the main event! Simply loop through the map between MCParticle and positions to
+    // Finally ready for the main event! Simply loop through the MCParticles and their positions to
     // draw the trajectories
-    std::map<const simb::MCParticle*, std::vector<std::vector<double> > >::iterator partToPosMapItr;
-
-    for(partToPosMapItr = partToPosMap.begin(); partToPosMapItr != partToPosMap.end(); partToPosMapItr++)
+    for(size_t partIdx = 0; partIdx < deposits.NParticles(); partIdx++)
     {
         // Recover the McParticle, we'll need to access several data members so may as well dereference it
-        const simb::MCParticle* mcPart = partToPosMapItr->first;
+        const simb::MCParticle* mcPart = deposits.particles[partIdx];
 
         // Apparently, it can happen that we get a null pointer here or maybe no points to plot
-        if (!mcPart || partToPosMapItr->second.empty()) continue;
+        if (!mcPart || deposits.Begin(partIdx) == deposits.End(partIdx)) continue;
 
         // The following is meant to get the correct offset for drawing the particle trajectory
         // In particular, the cosmic rays will not be correctly placed without this
@@ -552,13 +515,15 @@ void SimulationDrawer::MCTruth3D(const art::Event& evt,
             markerSize = 1;
         }
 
-        std::unique_ptr<double[]> hitPositions(new double[3*partToPosMapItr->second.size()]);
+        std::unique_ptr<double[]> hitPositions(new double[3*(deposits.End(partIdx) - deposits.Begin(partIdx))]);
         int                       hitCount(0);
 
         // Now loop over points and add to trajectory
-        for(size_t posIdx = 0; posIdx < partToPosMapItr->second.size(); posIdx++)
+        for(size_t posIdx = deposits.Begin(partIdx); posIdx < deposits.End(partIdx); posIdx++)
         {
-            const std::vector<double>& posVec = partToPosMapItr->second[posIdx];
+            if (deposits.energy[posIdx] <= drawopt->fMinEnergyDeposition) continue;
+
+            const double posVec[3] = {deposits.x[posIdx], deposits.y[posIdx], deposits.z[posIdx]};
 
             // Check xOffset state and set if necessary
             geo::Point_t hitLocation(posVec[0],posVec[1],posVec[2]);
@@ -589,6 +554,9 @@ void SimulationDrawer::MCTruth3D(const art::Event& evt,
             }
         }
 
+        // All the deposits might be below threshold
+        if (hitCount == 0) continue;
+
         TPolyMarker3D& pm = view->AddPolyMarker3D(1, colorIdx, markerIdx, markerSize);
         pm.SetPolyMarker(hitCount, hitPositions.get(), markerIdx);
     }
@@ -674,21 +642,13 @@ void SimulationDrawer::MCTruthOrtho(const art::Event& evt,
 //    double zMaximum(geom->DetLength());
 
     // Use the LArVoxelList to get the true energy deposition locations as opposed to using MCTrajectories
-    const sim::LArVoxelList voxels = sim::SimListUtils::GetLArVoxelList(evt,drawopt->fG4ModuleLabel.label());
-
-    mf::LogDebug("SimulationDrawer") << "Starting loop over " << plist.size() << " McParticles, voxel list size is " << voxels.size() << std::endl;
-
     // Using the voxel information can be slow (see previous implementation of this code).
     // In order to speed things up we have modified the strategy:
-    // 1) Make one pass through the list of voxels
-    // 2) For each voxel, keep track of the MCParticle contributing energy to it and it's position
-    //    which is done by keeping a map between the MCParticle and a vector of positions
-    // 3) Then loop through the map to draw the particle trajectories.
-    // One caveat is the need for MCParticles... and the voxels contain the track ids. So we'll need one
-    // more loop to make a map of track id's and MCParticles.
-
-    // First up is to build the map between track id's and associated MCParticles so we can recover when looping over voxels
-    std::map<int, const simb::MCParticle*> trackToMcParticleMap;
+    // 1) The energy deposits of the voxels are assigned to the MCParticles by track id, in one (parallel)
+    //    pass through the list of voxels, and kept grouped by MCParticle (see evd::MCVoxelIndex)
+    // 2) This is done once per event: redrawing, or changing the drawing options, reuses them
+    // 3) Then loop through the MCParticles to draw the particle trajectories.
+    mf::LogDebug("SimulationDrawer") << "Starting loop over " << plist.size() << " McParticles" << std::endl;
 
     // Should we display the trajectories too?
     bool   displayMcTrajectories(true);
@@ -700,8 +660,6 @@ void SimulationDrawer::MCTruthOrtho(const art::Event& evt,
     double vtx[3] = {0.0, 0.0, 0.0};
     for(size_t p = 0; p < plist.size(); ++p)
     {
-        trackToMcParticleMap[plist[p]->TrackId()] = plist[p];
-
         // Quick loop through to drawn trajectories...
         if (displayMcTrajectories)
         {
@@ -811,54 +769,31 @@ void SimulationDrawer::MCTruthOrtho(const art::Event& evt,
         }
     }
 
-    // Now we set up and build the map between MCParticles and a vector of positions obtained from the voxels
-    std::map<const simb::MCParticle*, std::vector<std::vector<double> > > partToPosMap;
-
-    sim::LArVoxelList::const_iterator vxitr;
-    for(vxitr = voxels.begin(); vxitr != voxels.end(); vxitr++)
-    {
-        const sim::LArVoxelData &vxd = (*vxitr).second;
-
-        for(size_t partIdx = 0; partIdx < vxd.NumberParticles(); partIdx++)
-        {
-            if(vxd.Energy(partIdx) > drawopt->fMinEnergyDeposition)
-            {
-                int trackId = vxd.TrackID(partIdx);
-
-                // It can be in some instances that mcPart here could be zero.
-                const simb::MCParticle* mcPart = trackToMcParticleMap[trackId];
-
-                partToPosMap[mcPart].push_back(std::vector<double>(3));
-
-                partToPosMap[mcPart].back()[0] = vxd.VoxelID().X();
-                partToPosMap[mcPart].back()[1] = vxd.VoxelID().Y();
-                partToPosMap[mcPart].back()[2] = vxd.VoxelID().Z();
-            }
-        } // end if this track id is in the current voxel
-    }// end loop over voxels
+    // Now recover the positions of the voxels each MCParticle deposited energy in
+    const evd::MCVoxelIndex::Deposits_t& deposits = evd::MCVoxelIndex::Instance().Deposits(evt, drawopt->fG4ModuleLabel.label(), drawopt->fG4ModuleLabel.encode(), plist);
 
-    // Finally ready for the main event! Simply loop through the map between MCParticle and positions to
+    // Finally ready for the main event! Simply loop through the MCParticles and their positions to
     // draw the trajectories
-    std::map<const simb::MCParticle*, std::vector<std::vector<double> > >::iterator partToPosMapItr;
-
-    for(partToPosMapItr = partToPosMap.begin(); partToPosMapItr != partToPosMap.end(); partToPosMapItr++)
+    for(size_t partIdx = 0; partIdx < deposits.NParticles(); partIdx++)
     {
         // Recover the McParticle, we'll need to access several data members so may as well dereference it
-        const simb::MCParticle* mcPart = partToPosMapItr->first;
+        const simb::MCParticle* mcPart = deposits.particles[partIdx];
 
         // Apparently, it can happen that we get a null pointer here or maybe no points to plot
-        if (!mcPart || partToPosMapItr->second.empty()) continue;
+        if (!mcPart || deposits.Begin(partIdx) == deposits.End(partIdx)) continue;
 
         tpcminx = 1.0; tpcmaxx = -1.0;
     	xOffset = 0.0; g4Ticks = 0.0;
     	std::vector< std::array<double, 3> > posVecCorr;
-    	posVecCorr.reserve(partToPosMapItr->second.size());
+    	posVecCorr.reserve(deposits.End(partIdx) - deposits.Begin(partIdx));
     	coeff = 0.0; readoutwindowsize = 0.0;
 
         // Now loop over points and add to trajectory
-        for(size_t posIdx = 0; posIdx < partToPosMapItr->second.size(); posIdx++)
+        for(size_t posIdx = deposits.Begin(partIdx); posIdx < deposits.End(partIdx); posIdx++)
         {
-        	const std::vector<double>& posVec = partToPosMapItr->second[posIdx];
+        	if (deposits.energy[posIdx] <= drawopt->fMinEnergyDeposition) continue;
+
+        	const double posVec[3] = {deposits.x[posIdx], deposits.y[posIdx], deposits.z[posIdx]};
 
                 if ((posVec[0] < tpcminx) || (posVec[0] > tpcmaxx))
 		{
@@ -904,6 +839,9 @@ void SimulationDrawer::MCTruthOrtho(const art::Event& evt,
             	}
         }
 
+        // All the deposits might be below threshold
+        if (posVecCorr.empty()) continue;
+
         TPolyMarker& pm = view->AddPolyMarker(posVecCorr.size(), evd::Style::ColorFromPDG(mcPart->PdgCode()), kFullDotMedium, 2); //kFullCircle, msize);
 
         for (size_t p = 0; p < posVecCorr.size(); ++p)
@@ -42,6 +42,8 @@ public:
     art::InputTag       fSimPhotonLabel;                 ///< and for SimPhotons
     
     fhicl::ParameterSet f3DDrawerParams;                  ///< FHICL paramegers for the 3D drawers
+
+    fhicl::ParameterSetID fConfigurationID;               ///< ID of the configuration last applied by reconfigure()
 };
     
 }//namespace
@@ -40,6 +40,8 @@ namespace evd {
     fSimPhotonLabel          = pset.get< art::InputTag >      ("SimPhotonLabel"                );
 
     f3DDrawerParams          = pset.get< fhicl::ParameterSet >("Draw3DTools"                   );
+
+    fConfigurationID         = pset.id();
   }
 
 }
@@ -15,6 +15,7 @@
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 #include "lareventdisplay/EventDisplay/RawDataDrawer.h"
 #include "lareventdisplay/EventDisplay/wfHitDrawers/IWFHitDrawer.h"
 #include "lareventdisplay/EventDisplay/wfHitDrawers/IWaveformDrawer.h"
@@ -124,8 +125,11 @@ void TQPad::Draw()
         raw::ChannelID_t channel = geoSvc->PlaneWireToChannel(fPlane,fWire,drawopt->fTPC,drawopt->fCryostat);
 
         // Call the tools to fill the histograms for RawDigits and Wire data
+        DrawingProfiler::Scope profile(fPad->GetName(), "RawDigit waveform");
         fRawDigitDrawerTool->Fill(*fView, channel, this->RawDataDraw()->StartTick(), this->RawDataDraw()->TotalClockTicks());
+        profile.Next("Wire waveform");
         fWireDrawerTool->Fill(*fView, channel, this->RawDataDraw()->StartTick(), this->RawDataDraw()->TotalClockTicks());
+        profile.Next("waveform and hit painting");
 
         // Vertical limits set for the enclosing histogram, then draw it with axes only
         float maxLowVal = 1.1*std::min(fRawDigitDrawerTool->getMinimum(), fWireDrawerTool->getMinimum());
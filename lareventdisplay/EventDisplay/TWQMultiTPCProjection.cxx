@@ -21,6 +21,7 @@
 #include "larcorealg/Geometry/PlaneGeo.h"
 #include "lardata/DetectorInfoServices/DetectorPropertiesService.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 #include "lareventdisplay/EventDisplay/EvdLayoutOptions.h"
 #include "lareventdisplay/EventDisplay/HeaderPad.h"
 #include "lareventdisplay/EventDisplay/MCBriefPad.h"
@@ -309,6 +310,8 @@ namespace evd{
   //......................................................................
   void TWQMultiTPCProjectionView::Draw(const char* opt)
   {
+    DrawingProfiler::Instance().UpdateEvent();
+
     art::ServiceHandle<geo::Geometry const> geo;
 
     fPrevZoomOpt.clear();
@@ -329,6 +332,8 @@ namespace evd{
     // Reset current zooming plane - since it's not currently zooming.
     curr_zooming_plane=-1;
 
+    TWireProjPad::PrepareDraw(fPlanes);
+
     //  double Charge=0, ConvCharge=0;
     for(size_t i = 0; i < fPlanes.size(); ++i){
       fPlanes[i]->Draw(opt);
@@ -15,6 +15,7 @@
 #include "TROOT.h"
 #include "TRootEmbeddedCanvas.h"
 #include "TString.h"
+#include "TTimer.h"
 
 #include "larcore/Geometry/Geometry.h"
 #include "larcorealg/Geometry/GeometryCore.h"
@@ -23,6 +24,7 @@
 #include "lardata/Utilities/GeometryUtilities.h"
 #include "lareventdisplay/EventDisplay/ChangeTrackers.h" // util::DataProductChangeTracker_t
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 #include "lareventdisplay/EventDisplay/EvdLayoutOptions.h"
 #include "lareventdisplay/EventDisplay/HeaderPad.h"
 #include "lareventdisplay/EventDisplay/InfoTransfer.h"
@@ -62,7 +64,9 @@ namespace evd{
     , isZoomAutomatic
         (art::ServiceHandle<evd::EvdLayoutOptions const>()->fAutoZoomInterest)
     , fLastEvent(new util::DataProductChangeTracker_t)
+    , fRefineTimer(new TTimer)
   {
+    fRefineTimer->Connect("Timeout()", "evd::TWQProjectionView", this, "RefineDrawing()");
 
     art::ServiceHandle<geo::Geometry const> geo;
 
@@ -295,6 +299,7 @@ namespace evd{
     fPlaneQ.clear();
 
     delete fLastEvent;
+    delete fRefineTimer;
   }
 
   //......................................................................
@@ -336,6 +341,7 @@ namespace evd{
     mf::LogDebug("TWQProjectionView") << "Starting to draw";
 
     OnNewEvent(); // if the current event is a new one, we need some resetting
+    DrawingProfiler::Instance().UpdateEvent();
 
     art::ServiceHandle<geo::Geometry const> geo;
 
@@ -358,12 +364,23 @@ namespace evd{
     // Reset current zooming plane - since it's not currently zooming.
     curr_zooming_plane=-1;
 
+    // with progressive drawing, this is the coarse pass;
+    // RefineDrawing() completes the planes afterwards
+    fRefineTimer->Stop();
+    TWireProjPad::DrawingPass_t firstPass;
+    if (evdlayoutopt->fProgressiveDrawing) {
+      firstPass.deadline = TWireProjPad::DrawingPass_t::Clock_t::now();
+      firstPass.coarseness = evdlayoutopt->fCoarseDrawingScale;
+    }
+    bool drawingComplete = true;
+
     unsigned int const nPlanes = fPlanes.size();
     MF_LOG_DEBUG("TWQProjectionView") << "Start drawing " << nPlanes << " planes";
+    TWireProjPad::PrepareDraw(fPlanes);
     //  double Charge=0, ConvCharge=0;
     for(unsigned int i=0;i<nPlanes;++i){
       TWireProjPad* planePad = fPlanes[i];
-      planePad->Draw(opt);
+      if (!planePad->DrawPass(opt, firstPass)) drawingComplete = false;
       planePad->Pad()->Update();
       planePad->Pad()->GetFrame()->SetBit(TPad::kCannotMove,true);
       fPlaneQ[i]->Draw();
@@ -411,9 +428,48 @@ namespace evd{
       fAngleInfo->SetForegroundColor(kBlack);
 
     evdb::Canvas::fCanvas->Update();
+
+    // the refinement starts as soon as the GUI has processed its events
+    if (!drawingComplete) fRefineTimer->Start(0, kTRUE);
+
     mf::LogDebug("TWQProjectionView") << "Done drawing";
   }
 
+  //......................................................................
+  void TWQProjectionView::RefineDrawing()
+  {
+    art::ServiceHandle<evd::EvdLayoutOptions const> evdlayoutopt;
+
+    // no plane is started after the time budget is over,
+    // but at least one is refined at each step
+    TWireProjPad::DrawingPass_t pass;
+    pass.deadline = TWireProjPad::DrawingPass_t::Clock_t::now()
+      + std::chrono::duration_cast<TWireProjPad::DrawingPass_t::Clock_t::duration>
+        (std::chrono::duration<double, std::milli>(evdlayoutopt->fDrawingTimeBudget));
+
+    bool drawingComplete = true;
+    bool refined = false;
+    for (TWireProjPad* planePad: fPlanes) {
+      if (planePad->isDrawingComplete()) continue;
+      if (refined && (TWireProjPad::DrawingPass_t::Clock_t::now() >= pass.deadline)) {
+        drawingComplete = false;
+        continue;
+      }
+      if (!planePad->DrawPass("", pass)) drawingComplete = false;
+      planePad->Pad()->Update();
+      planePad->Pad()->GetFrame()->SetBit(TPad::kCannotMove,true);
+      refined = true;
+    }
+
+    if (!refined) return;
+    evdb::Canvas::fCanvas->Update();
+
+    MF_LOG_DEBUG("TWQProjectionView") << "Refinement step "
+      << (drawingComplete? "completed the drawing": "done");
+
+    if (!drawingComplete) fRefineTimer->Start(0, kTRUE);
+  }
+
   // comment out this method as for now we don't want to change every
   // plane to have the same range in wire number because wire numbers
   // don't necessarily overlap from plane to plane, ie the same range
@@ -26,6 +26,7 @@ class TGNumberEntry;
 class TGRadioButton;
 class TGTextButton;
 class TGTextView;
+class TTimer;
 
 namespace util {
     class DataProductChangeTracker_t;
@@ -91,6 +92,7 @@ public:
     void    SetRawCalib();
     void    SetUpSideBar();
     void    ForceRedraw(); ///< Forces a redraw of the window
+    void    RefineDrawing(); ///< Draws the next step of a progressive drawing
     void    SetUpZoomButtons();
     void    SetUpClusterButtons();
     void    SetUpDrawingButtons();
@@ -194,6 +196,8 @@ private:
 
     util::DataProductChangeTracker_t* fLastEvent; ///< keeps track of latest event
 
+    TTimer* fRefineTimer; ///< schedules the steps of progressive drawing
+
     /// Records whether we are automatically zooming to the region of interest
     void SetAutomaticZoomMode(bool bSet = true);
 
@@ -17,8 +17,14 @@
 #include "TString.h"
 #include "TVirtualPad.h"
 
+#include "tbb/parallel_for.h"
+
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/Utilities/PxUtils.h"
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h"
+#include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
+#include "lareventdisplay/EventDisplay/ColorRaster.h"
+#include "lareventdisplay/EventDisplay/DrawingProfiler.h"
 #include "lareventdisplay/EventDisplay/EvdLayoutOptions.h"
 #include "lareventdisplay/EventDisplay/HitSelector.h"
 #include "lareventdisplay/EventDisplay/RawDataDrawer.h"
@@ -26,6 +32,7 @@
 #include "lareventdisplay/EventDisplay/RecoBaseDrawer.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/SimulationDrawer.h"
+#include "lareventdisplay/EventDisplay/SimulationDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/Style.h"
 #include "lareventdisplay/EventDisplay/TWireProjPad.h"
 #include "nuevdb/EventDisplayBase/EventHolder.h"
@@ -193,6 +200,10 @@ namespace evd{
     fHisto->Draw("AB");
 
     fView = new evdb::View2D();
+    for (unsigned int layer = 0; layer < kNDrawingLayers; ++layer) {
+      fLayerViews[layer] = new evdb::View2D();
+      fLayerInputs[layer] = new util::LayerChangeTracker_t();
+    }
   }
 
   //......................................................................
@@ -200,10 +211,54 @@ namespace evd{
   {
     if (fHisto) { delete fHisto; fHisto = 0; }
     if (fView)  { delete fView;  fView  = 0; }
+    for (unsigned int layer = 0; layer < kNDrawingLayers; ++layer) {
+      delete fLayerViews[layer];
+      delete fLayerInputs[layer];
+    }
+  }
+
+  //......................................................................
+  void TWireProjPad::PrepareDraw(std::vector<TWireProjPad*> const& pads)
+  {
+    const art::Event *evt = evdb::EventHolder::Instance()->GetEvent();
+    if(!evt) return;
+
+    art::ServiceHandle<evd::RawDrawingOptions const> rawopt;
+    if(rawopt->fDrawRawDataOrCalibWires == 1) return;
+
+    // the preparation is accounted to all the planes together
+    DrawingProfiler::Scope profile("TWireProjPad", "LoadRawDigits");
+
+    // reading the data involves services which are not required to be
+    // thread-safe, so it's done here, one plane at a time; the settings the
+    // preparation needs from the services are also read at this time
+    std::vector<TWireProjPad*> toPrepare;
+    for(TWireProjPad* pad: pads){
+      if(pad->RawDataDraw()->LoadRawDigits(*evt, pad->fPlane))
+        toPrepare.push_back(pad);
+    }
+
+    MF_LOG_DEBUG("TWireProjPad") << "Preparing " << toPrepare.size()
+      << "/" << pads.size() << " planes concurrently";
+
+    // the drawers of the same input share the digit cache, but each one works
+    // on a different plane of it and uses no service
+    profile.Next("PrepareRawDigit2D");
+    tbb::parallel_for(std::size_t(0), toPrepare.size(), [&](std::size_t i)
+      {
+        TWireProjPad* pad = toPrepare[i];
+        pad->RawDataDraw()->PrepareRawDigit2D(*evt, pad->fPlane);
+      });
   }
 
   //......................................................................
   void TWireProjPad::Draw(const char* opt)
+  {
+    DrawPass(opt, DrawingPass_t());
+  }
+
+  //......................................................................
+  bool TWireProjPad::DrawPass(const char* opt, DrawingPass_t const& pass)
   {
     // DumpPadsInCanvas(fPad, "TWireProjPad", "Draw()");
     MF_LOG_DEBUG("TWireProjPad") << "Started to draw plane " << fPlane;
@@ -215,38 +270,143 @@ namespace evd{
     // grab the singleton holding the art::Event
     const art::Event *evt = evdb::EventHolder::Instance()->GetEvent();
     if(evt){
-      art::ServiceHandle<evd::RecoDrawingOptions const> recoOpt;
-
-      this->SimulationDraw()->MCTruthVectors2D(*evt, fView, fPlane);
+      art::ServiceHandle<evd::RecoDrawingOptions const>       recoOpt;
+      art::ServiceHandle<evd::RawDrawingOptions const>        rawOpt;
+      art::ServiceHandle<evd::SimulationDrawingOptions const> simOpt;
+      art::ServiceHandle<evd::ColorDrawingOptions const>      colorOpt;
+
+      // Each layer is drawn anew only when something it is drawn from has
+      // changed. All the layers depend on the event, the plane in the current
+      // TPC and the raw data and color options (including the ones the GUI
+      // changes directly), plus what is added for each layer.
+      util::LayerChangeTracker_t planeInput
+        (*evt, geo::PlaneID(rawOpt->CurrentTPC(), fPlane));
+      planeInput
+        .with(rawOpt->fConfigurationID.to_string())
+        .with(rawOpt->fDrawRawDataOrCalibWires)
+        .with(rawOpt->fMinSignal)
+        .with(colorOpt->fConfigurationID.to_string())
+        .with(colorOpt->fColorOrGray);
+
+      // the data layers are drawn at the resolution of the visible range
+      ColorRaster::Frame_t const frame
+        = ColorRaster::ExtractFrame(fPad, &GetCurrentZoom());
+      util::LayerChangeTracker_t rangeInput(planeInput);
+      rangeInput
+        .with(frame.xMin).with(frame.xMax).with(frame.yMin).with(frame.yMax)
+        .with(frame.width).with(frame.height);
 
       // the 2D pads have too much detail to be rendered on screen;
       // to act smarter, RawDataDrawer needs to know the range being plotted
-      this->RawDataDraw()->   ExtractRange    (fPad, &GetCurrentZoom());
-      this->RawDataDraw()->   RawDigit2D
-        (*evt, fView, fPlane, GetDrawOptions().bZoom2DdrawToRoI);
-
-      this->RecoBaseDraw()->  Wire2D          (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  Hit2D           (*evt, fView, fPlane);
+      util::LayerChangeTracker_t rawInput(rangeInput);
+      rawInput.with(GetDrawOptions().bZoom2DdrawToRoI);
+      util::LayerChangeTracker_t coarseRawInput(rawInput);
+      coarseRawInput.with("coarse");
+
+      // within a drawing pass, the first layer is always drawn, and the
+      // following ones only until the deadline
+      unsigned int nDrawnLayers = 0;
+      auto const drawLayerInTime = [&](DrawingLayer_t layer,
+        util::LayerChangeTracker_t const& input,
+        std::function<void(evdb::View2D*)> const& draw)
+        {
+          if (*(fLayerInputs[layer]) == input) return;
+          if ((nDrawnLayers > 0) && (DrawingPass_t::Clock_t::now() >= pass.deadline)) {
+            fDrawingComplete = false;
+            // coarse raw digits are kept until refined; other old content
+            // might be from a different input
+            if (!(*(fLayerInputs[layer]) == coarseRawInput)) ClearLayer(layer);
+            return;
+          }
+          DrawLayer(layer, input, draw);
+          ++nDrawnLayers;
+        };
+      fDrawingComplete = true;
+
+      auto const drawRawDigits = [&](evdb::View2D* view)
+        {
+          DrawingProfiler::Scope profile(fPad->GetName(), "RawDigit2D");
+          this->RawDataDraw()->RawDigit2D
+            (*evt, view, fPlane, GetDrawOptions().bZoom2DdrawToRoI);
+        };
+
+      // in a coarse pass, raw digits not drawn yet are drawn with fewer cells
+      bool const drawCoarse = (pass.coarseness > 1)
+        && !(*(fLayerInputs[kRawDigitLayer]) == rawInput)
+        && !(*(fLayerInputs[kRawDigitLayer]) == coarseRawInput);
+      if (drawCoarse) {
+        this->RawDataDraw()->ExtractRange(fPad, &GetCurrentZoom(), pass.coarseness);
+        DrawLayer(kRawDigitLayer, coarseRawInput, drawRawDigits);
+        fDrawingComplete = false;
+        ++nDrawnLayers;
+      }
+      else {
+        this->RawDataDraw()->ExtractRange(fPad, &GetCurrentZoom());
+        drawLayerInTime(kRawDigitLayer, rawInput, drawRawDigits);
+      }
 
-      if(recoOpt->fUseHitSelector)
+      this->RecoBaseDraw()->  ExtractRange    (fPad, &GetCurrentZoom());
+      drawLayerInTime(kWireLayer,
+        util::LayerChangeTracker_t(rangeInput).with(recoOpt->fConfigurationID.to_string()),
+        [&](evdb::View2D* view)
+        {
+          DrawingProfiler::Scope profile(fPad->GetName(), "Wire2D");
+          this->RecoBaseDraw()->Wire2D(*evt, view, fPlane);
+        });
+
+      drawLayerInTime(kRecoLayer,
+        util::LayerChangeTracker_t(planeInput).with(recoOpt->fConfigurationID.to_string()),
+        [&](evdb::View2D* view)
+        {
+          DrawingProfiler::Scope profile(fPad->GetName(), "Hit2D");
+          this->RecoBaseDraw()->  Hit2D                 (*evt, view, fPlane);
+          profile.Next("Slice2D");
+          this->RecoBaseDraw()->  Slice2D               (*evt, view, fPlane);
+          profile.Next("Cluster2D");
+          this->RecoBaseDraw()->  Cluster2D             (*evt, view, fPlane);
+          profile.Next("EndPoint2D");
+          this->RecoBaseDraw()->  EndPoint2D            (*evt, view, fPlane);
+          profile.Next("Prong2D");
+          this->RecoBaseDraw()->  Prong2D               (*evt, view, fPlane);
+          profile.Next("Vertex2D");
+          this->RecoBaseDraw()->  Vertex2D              (*evt, view, fPlane);
+          profile.Next("Seed2D");
+          this->RecoBaseDraw()->  Seed2D                (*evt, view, fPlane);
+          profile.Next("OpFlash2D");
+          this->RecoBaseDraw()->  OpFlash2D             (*evt, view, fPlane);
+          profile.Next("Event2D");
+          this->RecoBaseDraw()->  Event2D               (*evt, view, fPlane);
+          profile.Next("DrawTrackVertexAssns2D");
+          this->RecoBaseDraw()->  DrawTrackVertexAssns2D(*evt, view, fPlane);
+        });
+
+      drawLayerInTime(kMCTruthLayer,
+        util::LayerChangeTracker_t(planeInput)
+          .with(simOpt->fConfigurationID.to_string())
+          .with(simOpt->fShowMCTruthText)
+          .with(simOpt->fShowMCTruthVectors),
+        [&](evdb::View2D* view)
+        {
+          DrawingProfiler::Scope profile(fPad->GetName(), "MCTruthVectors2D");
+          this->SimulationDraw()->MCTruthVectors2D(*evt, view, fPlane);
+        });
+
+      // the hit selection changes with each click: it is always drawn anew
+      if(recoOpt->fUseHitSelector) {
+        DrawingProfiler::Scope profile(fPad->GetName(), "Hit2D (selected)");
         this->RecoBaseDraw()->Hit2D(this->HitSelectorGet()->GetSelectedHits(fPlane),
                                     kSelectedColor,
                                     fView,
                                     true);
-
-      this->RecoBaseDraw()->  Slice2D               (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  Cluster2D             (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  EndPoint2D            (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  Prong2D               (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  Vertex2D              (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  Seed2D                (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  OpFlash2D             (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  Event2D               (*evt, fView, fPlane);
-      this->RecoBaseDraw()->  DrawTrackVertexAssns2D(*evt, fView, fPlane);
+      }
 
     //  DumpPadsInCanvas(fPad, "TWireProjPad", "Before UpdatePad()");
       UpdatePad();
     } // if (evt)
+    else {
+      ClearLayers();
+      fDrawingComplete = true;
+    }
 
     // DumpPadsInCanvas(fPad, "TWireProjPad", "Before ClearandUpdatePad()");
     ClearandUpdatePad();
@@ -286,9 +446,71 @@ namespace evd{
 
     MF_LOG_DEBUG("TWireProjPad") << "Started rendering plane " << fPlane;
 
+    // ROOT painting is timed too, counting the primitives it adds to the pad
+    DrawingProfiler::Scope profile(fPad->GetName(), "DrawRaster", fPad);
+
+    // rasters (if any) go on the frame, under everything else
+    if (evt) {
+      this->RawDataDraw()->DrawRaster(fPlane);
+      this->RecoBaseDraw()->DrawWireRaster(fPlane);
+    }
+
+    // each layer is painted on its own, to count the primitives of its drawers
+    static char const* const layerDrawers[kNDrawingLayers] = {
+      "View2D::Draw RawDigit2D", "View2D::Draw Wire2D",
+      "View2D::Draw reconstruction", "View2D::Draw MCTruthVectors2D"
+    };
+    for (unsigned int layer = 0; layer < kNDrawingLayers; ++layer) {
+      profile.Next(layerDrawers[layer]);
+      fLayerViews[layer]->Draw();
+    }
+    profile.Next("View2D::Draw Hit2D (selected)");
     fView->Draw();
 
-    MF_LOG_DEBUG("TWireProjPad") << "Drawing of plane " << fPlane << " completed";
+    MF_LOG_DEBUG("TWireProjPad") << "Drawing of plane " << fPlane
+      << (fDrawingComplete? " completed": " partially completed");
+
+    return fDrawingComplete;
+  }
+
+  //......................................................................
+  void TWireProjPad::DrawLayer(DrawingLayer_t layer,
+                               util::LayerChangeTracker_t const& input,
+                               std::function<void(evdb::View2D*)> const& draw)
+  {
+    util::LayerChangeTracker_t& layerInput = *(fLayerInputs[layer]);
+    if (layerInput == input) {
+      MF_LOG_DEBUG("TWireProjPad") << "Layer #" << layer << " of plane "
+        << fPlane << " is still valid for " << input;
+      return;
+    }
+
+    // if drawing fails halfway, the layer will be drawn anew next time
+    layerInput.clear();
+    fLayerViews[layer]->Clear();
+    draw(fLayerViews[layer]);
+    layerInput = input;
+  }
+
+  //......................................................................
+  void TWireProjPad::ClearLayer(DrawingLayer_t layer)
+  {
+    fLayerViews[layer]->Clear();
+    fLayerInputs[layer]->clear();
+
+    // the rasters are painted apart from the views, but belong to the layers
+    switch (layer) {
+      case kRawDigitLayer: this->RawDataDraw()->ClearRaster(fPlane);        break;
+      case kWireLayer:     this->RecoBaseDraw()->ClearWireRaster(fPlane);   break;
+      default:                                                              break;
+    }
+  }
+
+  //......................................................................
+  void TWireProjPad::ClearLayers()
+  {
+    for (unsigned int layer = 0; layer < kNDrawingLayers; ++layer)
+      ClearLayer(DrawingLayer_t(layer));
   }
 
   //......................................................................
@@ -9,6 +9,8 @@
 #ifndef EVD_TWIREPROJPAD_H
 #define EVD_TWIREPROJPAD_H
 #include "lareventdisplay/EventDisplay/DrawingPad.h"
+#include <chrono>
+#include <functional>
 #include <vector>
 
 
@@ -18,6 +20,7 @@ namespace evdb { class View2D;   }
 
 namespace util {
   class PxLine;
+  class LayerChangeTracker_t;
 }
 
 namespace evd {
@@ -35,6 +38,45 @@ namespace evd {
 		 unsigned int plane);
     ~TWireProjPad();
     void Draw(const char* opt=0);
+
+    /// Limits of a drawing pass of progressive drawing
+    struct DrawingPass_t {
+      using Clock_t = std::chrono::steady_clock;
+
+      /// No drawing layer is started after this time, but the first one
+      Clock_t::time_point deadline = Clock_t::time_point::max();
+
+      /// If larger than 1, raw digits not drawn yet are drawn with cells this
+      /// many pixels large, regardless of the deadline
+      unsigned int coarseness = 1;
+    }; // DrawingPass_t
+
+    /**
+     * @brief Draws the plane within the limits of a drawing pass
+     * @param opt same as for Draw()
+     * @param pass limits of this drawing pass
+     * @return whether the drawing of the plane is complete
+     *
+     * Drawing layers which are not current are drawn anew in order, until the
+     * deadline of the pass. Layers left behind are empty, except for the
+     * raw digits, which stay at the coarse resolution until refined.
+     * Draw() is a pass without limits.
+     */
+    bool DrawPass(const char* opt, DrawingPass_t const& pass);
+
+    /// Returns whether the last drawing pass left nothing behind
+    bool isDrawingComplete() const { return fDrawingComplete; }
+
+    /**
+     * @brief Prepares the raw data of all the pads before drawing them
+     * @param pads the pads to be drawn next
+     *
+     * Digits are read for each pad in turn, then the region of interest and
+     * the charge summary of all the planes are extracted concurrently.
+     * The following Draw() of each pad only needs to create the graphic
+     * objects.
+     */
+    static void PrepareDraw(std::vector<TWireProjPad*> const& pads);
     void GetWireRange(int *i1, int *i2) const;
     void SetWireRange(int i1, int i2);
 
@@ -74,6 +116,27 @@ namespace evd {
   private:
     /*     void AutoZoom(); */
 
+    /// Drawing stages whose graphic objects are kept between repaints,
+    /// in the order they are rendered
+    enum DrawingLayer_t {
+      kRawDigitLayer, ///< raw digits
+      kWireLayer,     ///< calibrated wires
+      kRecoLayer,     ///< reconstructed objects
+      kMCTruthLayer,  ///< true particle directions
+      kNDrawingLayers ///< number of layers
+    };
+
+    /// Runs `draw` on the view of the layer, unless it was drawn from the same input
+    void DrawLayer(DrawingLayer_t layer,
+                   util::LayerChangeTracker_t const& input,
+                   std::function<void(evdb::View2D*)> const& draw);
+
+    /// Removes all the objects from the drawing layer, raster included
+    void ClearLayer(DrawingLayer_t layer);
+
+    /// Removes all the objects from the drawing layers
+    void ClearLayers();
+
 
   private:
 
@@ -83,7 +146,11 @@ namespace evd {
 
     unsigned int  fPlane; ///< Which plane in the detector
     TH1F*         fHisto; ///< Histogram to draw object on
-    evdb::View2D* fView;  ///< Collection of graphics objects to render
+    evdb::View2D* fView;  ///< Graphics objects made anew at each Draw() (selected hits, user lines)
+
+    evdb::View2D*               fLayerViews[kNDrawingLayers];  ///< Graphics objects of each drawing layer
+    util::LayerChangeTracker_t* fLayerInputs[kNDrawingLayers]; ///< Input each layer was last drawn from
+    bool                        fDrawingComplete = true;       ///< Whether all the layers are current
 
     double        fXLo;   ///< Low  value of x axis
     double        fXHi;   ///< High value of x axis
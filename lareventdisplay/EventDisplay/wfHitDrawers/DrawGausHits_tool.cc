@@ -5,19 +5,24 @@
 
 #include "lardataobj/RecoBase/Hit.h"
 #include "lardataobj/RecoBase/Wire.h"
+#include "lareventdisplay/EventDisplay/ChangeTrackers.h"
+#include "lareventdisplay/EventDisplay/ChannelDataIndex.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/wfHitDrawers/IWFHitDrawer.h"
 #include "nuevdb/EventDisplayBase/EventHolder.h"
 
 #include "art/Utilities/ToolMacros.h"
 #include "canvas/Persistency/Common/FindManyP.h"
-#include "cetlib_except/exception.h"
 #include "messagefacility/MessageLogger/MessageLogger.h"
 
-#include "TF1.h"
 #include "TPolyLine.h"
+#include "TVirtualPad.h"
 
-#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <string>
+#include <utility>
 
 namespace evdb_tool
 {
@@ -44,12 +49,30 @@ private:
     };
 
     using ROIHitParamsVec = std::vector<HitParams_t>;
-    using HitParamsVec    = std::vector<ROIHitParamsVec>;
 
-    int                                       fNumPoints;
-    bool                                      fFloatBaseline;
-    std::vector<int>                          fColorVec;
-    mutable std::vector<std::unique_ptr<TF1>> fHitFunctionVec;
+    // The hits of a ROI with their summed shape, sampled at a number of points
+    using ROIShape_t = struct ROIShape_t
+    {
+        ROIHitParamsVec     hitParamsVec;
+        float               baseline;
+        std::vector<double> ticks;
+        std::vector<double> values;
+    };
+
+    using ChannelShapes_t = std::vector<ROIShape_t>;
+    using ShapeKey_t      = std::pair<raw::ChannelID_t, std::string>;
+
+    ChannelShapes_t BuildShapes(const art::Event&, const art::InputTag&, raw::ChannelID_t) const;
+    size_t          NumPoints(double, double) const;
+    static void     SampleShape(ROIShape_t&, size_t);
+
+    size_t                                         fNumPoints;
+    bool                                           fFloatBaseline;
+    std::vector<int>                               fColorVec;
+
+    // Shapes already computed in this event, by channel and hit label
+    mutable util::EventChangeTracker_t             fShapeEvent;
+    mutable std::map<ShapeKey_t, ChannelShapes_t>  fShapeCache;
 };
 
 //----------------------------------------------------------------------
@@ -65,7 +88,7 @@ DrawGausHits::~DrawGausHits()
 
 void DrawGausHits::configure(const fhicl::ParameterSet& pset)
 {
-    fNumPoints     = pset.get< int>("NumPoints",     1000);
+    fNumPoints     = std::max(pset.get< int>("NumPoints",     1000), 2);
     fFloatBaseline = pset.get<bool>("FloatBaseline", false);
 
     fColorVec.clear();
@@ -74,7 +97,8 @@ void DrawGausHits::configure(const fhicl::ParameterSet& pset)
     fColorVec.push_back(kMagenta);
     fColorVec.push_back(kCyan);
 
-    fHitFunctionVec.clear();
+    fShapeEvent.clear();
+    fShapeCache.clear();
 
     return;
 }
@@ -89,150 +113,175 @@ void DrawGausHits::Draw(evdb::View2D&     view2D,
     const art::Event* event = evdb::EventHolder::Instance()->GetEvent();
     if(!event) return;
 
-    fHitFunctionVec.clear();
+    // Redrawing the same channel (e.g. on a zoom) reuses the hit shapes
+    if (fShapeEvent.update(util::EventChangeTracker_t(*event))) fShapeCache.clear();
 
     for (size_t imod = 0; imod < recoOpt->fHitLabels.size(); ++imod)
     {
-        // Step one is to recover the hits for this label that match the input channel
         art::InputTag const which = recoOpt->fHitLabels[imod];
 
-        art::Handle< std::vector<recob::Hit> > hitVecHandle;
-        event->getByLabel(which, hitVecHandle);
+        ShapeKey_t const key(channel, which.encode());
+
+        auto shapeItr = fShapeCache.find(key);
 
-        // Get a container for the subset of hits we are drawing
-        art::PtrVector<recob::Hit> hitPtrVec;
+        if (shapeItr == fShapeCache.end())
+            shapeItr = fShapeCache.emplace(key, BuildShapes(*event, which, channel)).first;
 
-        try{
-          for(size_t hitIdx = 0; hitIdx < hitVecHandle->size(); hitIdx++)
+        int const color = fColorVec[imod % fColorVec.size()];
+
+        for(auto& roiShape : shapeItr->second)
+        {
+            const float baseline = roiShape.baseline;
+
+            for(const auto& hitParams : roiShape.hitParamsVec)
             {
-              art::Ptr<recob::Hit> hit(hitVecHandle, hitIdx);
-              
-              if (hit->Channel() == channel) hitPtrVec.push_back(hit);
-            }
-        }
-        catch(cet::exception& e){
-          mf::LogWarning("DrawGausHits") << "DrawGausHits"
-                                         << " failed with message:\n"
-                                         << e;
-        }
+                TPolyLine& hitHeight = view2D.AddPolyLine(2, kBlack, 1, 1);
 
-        if (hitPtrVec.empty()) continue;
+                hitHeight.SetPoint(0, hitParams.hitCenter, baseline);
+                hitHeight.SetPoint(1, hitParams.hitCenter, hitParams.hitHeight + baseline);
 
-        // Apparently you cannot trust some hit producers to put the hits in the correct order!
-        std::sort(hitPtrVec.begin(),hitPtrVec.end(),[](const auto& left, const auto& right){return left->PeakTime() < right->PeakTime();});
+                hitHeight.Draw("same");
 
-        // Get associations to wires
-        art::FindManyP<recob::Wire> wireAssnsVec(hitPtrVec, *event, which);
-        std::vector<float>          wireDataVec;
+                TPolyLine& hitSigma = view2D.AddPolyLine(2, kGray, 1, 1);
 
-        // Recover the full (zero-padded outside ROI's) deconvolved waveform for this wire
-        if (wireAssnsVec.isValid() && wireAssnsVec.size() > 0) 
-	  {
-	    auto hwafp =  wireAssnsVec.at(0).front();
-	    if (!hwafp.isNull() && hwafp.isAvailable())
-	      {
-	         wireDataVec = hwafp->Signal();
-	      }
-	  }
+                hitSigma.SetPoint(0, hitParams.hitCenter - hitParams.hitSigma, 0.6 * hitParams.hitHeight + baseline);
+                hitSigma.SetPoint(1, hitParams.hitCenter + hitParams.hitSigma, 0.6 * hitParams.hitHeight + baseline);
 
-        // Now go through and process the hits back into the hit parameters
-        using HitParams_t = struct HitParams_t
-        {
-            float hitCenter;
-            float hitSigma;
-            float hitHeight;
-            float hitStart;
-            float hitEnd;
-        };
-
-        using ROIHitParamsVec = std::vector<HitParams_t>;
-        using HitParamsVec    = std::vector<ROIHitParamsVec>;
-
-        // Get an initial container for common hits on ROI
-        HitParamsVec    hitParamsVec;
-        ROIHitParamsVec roiHitParamsVec;
-        raw::TDCtick_t  lastEndTick(10000);
-
-        for (const auto& hit : hitPtrVec)
-        {
-            // check roi end condition
-            if (hit->PeakTime() - 3. * hit->RMS() > lastEndTick)
-            {
-                if (!roiHitParamsVec.empty()) hitParamsVec.push_back(roiHitParamsVec);
-                roiHitParamsVec.clear();
+                hitSigma.Draw("same");
             }
 
-            HitParams_t hitParams;
+            // The shape is sampled again only if the resolution has changed
+            size_t const nPoints = NumPoints(roiShape.hitParamsVec.front().hitStart, roiShape.hitParamsVec.back().hitEnd);
+
+            if (roiShape.ticks.size() != nPoints) SampleShape(roiShape, nPoints);
+
+            TPolyLine& hitFunc = view2D.AddPolyLine(nPoints, color, 1, 1);
 
-            hitParams.hitCenter = hit->PeakTime();
-            hitParams.hitSigma  = hit->RMS();
-            hitParams.hitHeight = hit->PeakAmplitude();
-            hitParams.hitStart  = hit->PeakTime() - 3. * hit->RMS();
-            hitParams.hitEnd    = hit->PeakTime() + 3. * hit->RMS();
+            for(size_t idx = 0; idx < nPoints; idx++) hitFunc.SetPoint(idx, roiShape.ticks[idx], roiShape.values[idx]);
 
-            lastEndTick         = hitParams.hitEnd;
+            hitFunc.Draw("same");
+        }
+    }//end loop over HitFinding modules
+
+    return;
+}
+
+DrawGausHits::ChannelShapes_t DrawGausHits::BuildShapes(const art::Event&    event,
+                                                        const art::InputTag& which,
+                                                        raw::ChannelID_t     channel) const
+{
+    ChannelShapes_t shapes;
 
-            roiHitParamsVec.emplace_back(hitParams);
+    // Step one is to recover the hits for this label that match the input channel
+    art::Handle< std::vector<recob::Hit> > hitVecHandle;
+    event.getByLabel(which, hitVecHandle);
 
-        }//end loop over reco hits
+    // Get a container for the subset of hits we are drawing;
+    // the index sorts them by peak time, since apparently you cannot trust
+    // some hit producers to put the hits in the correct order!
+    art::PtrVector<recob::Hit> hitPtrVec;
 
-        // Just in case (probably never called...)
-        if (!roiHitParamsVec.empty()) hitParamsVec.push_back(roiHitParamsVec);
+    auto const hitRange = evd::ChannelDataIndex::Instance().HitPositions(event, which, channel);
+    for(auto hitIdx = hitRange.first; hitIdx != hitRange.second; ++hitIdx)
+      hitPtrVec.push_back(art::Ptr<recob::Hit>(hitVecHandle, *hitIdx));
 
-        size_t roiCount(0);
+    if (hitPtrVec.empty()) return shapes;
 
-        for(const auto& roiHitParamsVec : hitParamsVec)
+    // Get associations to wires
+    art::FindManyP<recob::Wire> wireAssnsVec(hitPtrVec, event, which);
+    std::vector<float>          wireDataVec;
+
+    // Recover the full (zero-padded outside ROI's) deconvolved waveform for this wire
+    if (wireAssnsVec.isValid() && wireAssnsVec.size() > 0)
+    {
+        auto hwafp =  wireAssnsVec.at(0).front();
+        if (!hwafp.isNull() && hwafp.isAvailable())
         {
-            // Create a histogram here...
-            double roiStart = roiHitParamsVec.front().hitStart;
-            double roiStop  = roiHitParamsVec.back().hitEnd;
+            wireDataVec = hwafp->Signal();
+        }
+    }
 
-            std::string funcString = "gaus(0)";
-            std::string funcName   = Form("hitshape_%05zu_c%02zu",size_t(channel),roiCount++);
+    // Now go through and process the hits back into the hit parameters
+    ROIHitParamsVec roiHitParamsVec;
+    raw::TDCtick_t  lastEndTick(10000);
 
-            for(size_t idx = 1; idx < roiHitParamsVec.size(); idx++) funcString += "+gaus(" + std::to_string(3*idx) + ")";
+    for (const auto& hit : hitPtrVec)
+    {
+        // check roi end condition
+        if (hit->PeakTime() - 3. * hit->RMS() > lastEndTick)
+        {
+            if (!roiHitParamsVec.empty()) shapes.push_back({roiHitParamsVec, 0., {}, {}});
+            roiHitParamsVec.clear();
+        }
 
-            // Include a baseline
-            float baseline(0.);
+        HitParams_t hitParams;
 
-            if (fFloatBaseline && !wireDataVec.empty()) baseline = wireDataVec.at(roiStart);
+        hitParams.hitCenter = hit->PeakTime();
+        hitParams.hitSigma  = hit->RMS();
+        hitParams.hitHeight = hit->PeakAmplitude();
+        hitParams.hitStart  = hit->PeakTime() - 3. * hit->RMS();
+        hitParams.hitEnd    = hit->PeakTime() + 3. * hit->RMS();
 
-            funcString += "+" + std::to_string(baseline);
+        lastEndTick         = hitParams.hitEnd;
 
-            fHitFunctionVec.emplace_back(std::make_unique<TF1>(funcName.c_str(),funcString.c_str(),roiStart,roiStop));
-            TF1& hitFunc = *fHitFunctionVec.back().get();
+        roiHitParamsVec.emplace_back(hitParams);
 
-            hitFunc.SetLineColor(fColorVec[imod % fColorVec.size()]);
+    }//end loop over reco hits
 
-            size_t idx(0);
-            for(const auto& hitParams : roiHitParamsVec)
-            {
-                hitFunc.SetParameter(idx + 0, hitParams.hitHeight);
-                hitFunc.SetParameter(idx + 1, hitParams.hitCenter);
-                hitFunc.SetParameter(idx + 2, hitParams.hitSigma);
+    // Just in case (probably never called...)
+    if (!roiHitParamsVec.empty()) shapes.push_back({roiHitParamsVec, 0., {}, {}});
 
-                TPolyLine& hitHeight = view2D.AddPolyLine(2, kBlack, 1, 1);
+    // Include a baseline
+    if (fFloatBaseline && !wireDataVec.empty())
+    {
+        // hits near the edges of the waveform start (or end) outside of it
+        double const lastTick = double(wireDataVec.size() - 1);
+        for(auto& roiShape : shapes)
+        {
+            double const startTick = std::clamp(double(roiShape.hitParamsVec.front().hitStart), 0., lastTick);
+            roiShape.baseline = wireDataVec[size_t(startTick)];
+        }
+    }
 
-                hitHeight.SetPoint(0, hitParams.hitCenter, baseline);
-                hitHeight.SetPoint(1, hitParams.hitCenter, hitParams.hitHeight + baseline);
+    return shapes;
+}
 
-                hitHeight.Draw("same");
+size_t DrawGausHits::NumPoints(double roiStart, double roiStop) const
+{
+    // There is no point in sampling the shape more finely than the pixels of the pad
+    if (!gPad) return fNumPoints;
 
-                TPolyLine& hitSigma = view2D.AddPolyLine(2, kGray, 1, 1);
+    size_t const nPixels = std::abs(gPad->XtoAbsPixel(roiStop) - gPad->XtoAbsPixel(roiStart));
 
-                hitSigma.SetPoint(0, hitParams.hitCenter - hitParams.hitSigma, 0.6 * hitParams.hitHeight + baseline);
-                hitSigma.SetPoint(1, hitParams.hitCenter + hitParams.hitSigma, 0.6 * hitParams.hitHeight + baseline);
+    return std::clamp(nPixels + 1, size_t(2), fNumPoints);
+}
 
-                hitSigma.Draw("same");
+void DrawGausHits::SampleShape(ROIShape_t& roiShape, size_t nPoints)
+{
+    const ROIHitParamsVec& hitParamsVec = roiShape.hitParamsVec;
 
-                idx += 3;
-            }
+    double const roiStart = hitParamsVec.front().hitStart;
+    double const step     = (hitParamsVec.back().hitEnd - roiStart) / (nPoints - 1);
 
-            hitFunc.Draw("same");
-        }
-    }//end loop over HitFinding modules
+    roiShape.ticks.resize(nPoints);
+    roiShape.values.assign(nPoints, roiShape.baseline);
 
-    return;
+    for(size_t idx = 0; idx < nPoints; idx++) roiShape.ticks[idx] = roiStart + idx * step;
+
+    // Sum of the gaussian shapes of the hits, one hit at a time
+    for(const auto& hitParams : hitParamsVec)
+    {
+        double const center   = hitParams.hitCenter;
+        double const height   = hitParams.hitHeight;
+        double const invSigma = 1. / hitParams.hitSigma;
+
+        for(size_t idx = 0; idx < nPoints; idx++)
+        {
+            double const z = (roiShape.ticks[idx] - center) * invSigma;
+
+            roiShape.values[idx] += height * std::exp(-0.5 * z * z);
+        }
+    }
 }
 
 DEFINE_ART_CLASS_TOOL(DrawGausHits)
@@ -6,6 +6,7 @@
 #include "larcore/Geometry/Geometry.h"
 #include "lardataobj/RawData/RawDigit.h"
 #include "lardataobj/RawData/raw.h"
+#include "lareventdisplay/EventDisplay/ChannelDataIndex.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/wfHitDrawers/IWaveformDrawer.h"
@@ -42,6 +43,8 @@ private:
     float                 fMaximum;
     float                 fMinimum;
 
+    std::vector<short>    fUncompressed;  ///< buffer for the samples, reused at each call
+
     std::unique_ptr<TH1F> fRawDigitHist;
 };
 
@@ -87,12 +90,13 @@ void DrawRawHist::Fill(evdb::View2D&     view2D,
         
         if (!rawDigitVecHandle.isValid()) continue;
         
-        for(size_t rawDigitIdx = 0; rawDigitIdx < rawDigitVecHandle->size(); rawDigitIdx++)
+        // the index finds the digit of the channel without scanning the collection
+        size_t const rawDigitIdx = evd::ChannelDataIndex::Instance().DigitPosition(*event, rawDataLabel, channel);
+        
+        if (rawDigitIdx != evd::ChannelDataIndex::NoPosition)
         {
             art::Ptr<raw::RawDigit> rawDigit(rawDigitVecHandle, rawDigitIdx);
             
-            if (rawDigit->Channel() != channel) continue;
-            
             // We will need the pedestal service...
             const lariov::DetPedestalProvider& pedestalRetrievalAlg = art::ServiceHandle<lariov::DetPedestalService const>()->GetPedestalProvider();
             
@@ -116,7 +120,8 @@ void DrawRawHist::Fill(evdb::View2D&     view2D,
                 mf::LogWarning  ("DrawRawHist") << " PedestalOption is not understood: " << rawOpt->fPedestalOption << ".  Pedestals not subtracted.";
             }
             
-            std::vector<short> uncompressed(rawDigit->Samples());
+            std::vector<short>& uncompressed = fUncompressed;
+            uncompressed.resize(rawDigit->Samples());
             raw::Uncompress(rawDigit->ADCs(), uncompressed, rawDigit->Compression());
 
             TH1F* histPtr = fRawDigitHist.get();
@@ -132,9 +137,6 @@ void DrawRawHist::Fill(evdb::View2D&     view2D,
             }
             
             histPtr->SetLineColor(kBlack);
-            
-            // There is only one channel displayed so if here we are done
-            break;
         }
     }
 
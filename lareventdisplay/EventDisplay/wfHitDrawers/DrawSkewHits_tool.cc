@@ -8,6 +8,7 @@
 #include "larcore/Geometry/Geometry.h"
 #include "lardata/ArtDataHelper/MVAReader.h"
 #include "lardataobj/RecoBase/Hit.h"
+#include "lareventdisplay/EventDisplay/ChannelDataIndex.h"
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/wfHitDrawers/IWFHitDrawer.h"
@@ -85,25 +86,13 @@ void DrawSkewHits::Draw(evdb::View2D&     view2D,
         art::Handle< std::vector<recob::Hit> > hitVecHandle;
         event->getByLabel(which, hitVecHandle);
 
-        // Get a container for the subset of hits we are working with and setup to fill it
+        // Get a container for the subset of hits we are working with and fill it
+        // with the hits on the channel in question, found by the index
         art::PtrVector<recob::Hit> hitPtrVec;
-        bool                       stillSearching(true);
-        int                        fitParamsOffset(0);
 
-        // Loop through all hits and find those on the channel in question, also count up to the start of these hits
-        for(size_t hitIdx = 0; hitIdx < hitVecHandle->size(); hitIdx++)
-        {
-            art::Ptr<recob::Hit> hit(hitVecHandle, hitIdx);
-
-            if (hit->Channel() == channel)
-            {
-                hitPtrVec.push_back(hit);
-                stillSearching = false;
-            }
-            else if (!stillSearching) break;
-
-            if (stillSearching) fitParamsOffset++;
-        }
+        auto const hitRange = evd::ChannelDataIndex::Instance().HitPositions(*event, which, channel);
+        for(auto hitIdx = hitRange.first; hitIdx != hitRange.second; ++hitIdx)
+            hitPtrVec.push_back(art::Ptr<recob::Hit>(hitVecHandle, *hitIdx));
 
         // No hits no work
         if (hitPtrVec.empty()) continue;
@@ -125,7 +114,8 @@ void DrawSkewHits::Draw(evdb::View2D&     view2D,
         // Ok, loop through the hits for this channnel and recover the parameters
         for (size_t idx = 0; idx < hitPtrVec.size(); ++idx)
         {
-            const auto& fitParams = fitParamVecs[fitParamsOffset + idx];
+            // the fit parameters follow the order of the hit collection
+            const auto& fitParams = fitParamVecs[hitPtrVec[idx].key()];
             const auto& hit       = hitPtrVec[idx];
 
             hitPeakTimeVec.push_back(fitParams[0]);
@@ -5,6 +5,7 @@
 
 #include "larcore/Geometry/Geometry.h"
 #include "lardataobj/RecoBase/Wire.h"
+#include "lareventdisplay/EventDisplay/ChannelDataIndex.h"
 #include "lareventdisplay/EventDisplay/ColorDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RawDrawingOptions.h"
 #include "lareventdisplay/EventDisplay/RecoDrawingOptions.h"
@@ -98,12 +99,13 @@ void DrawWireHist::Fill(evdb::View2D&     view2D,
         if (!event->getByLabel(which, wireVecHandle)) continue;
         ++nWireLabels;
 
-        for(size_t wireIdx = 0; wireIdx < wireVecHandle->size(); wireIdx++)
+        // the index finds the wire of the channel without scanning the collection
+        size_t const wireIdx = evd::ChannelDataIndex::Instance().WirePosition(*event, which, channel);
+
+        if (wireIdx != evd::ChannelDataIndex::NoPosition)
         {
             art::Ptr<recob::Wire> wire(wireVecHandle, wireIdx);
 
-            if (wire->Channel() != channel) continue;
-
             const std::vector<float>& signalVec = wire->Signal();
 
             TH1F* histPtr = fRecoHistMap.at(which.encode()).get();
@@ -117,9 +119,6 @@ void DrawWireHist::Fill(evdb::View2D&     view2D,
             }
 
             histPtr->SetLineColor(fColorMap.at((nWireLabels-1) % recoOpt->fWireLabels.size()));
-
-            // There is only one channel displayed so if here we are done
-            break;
         }
     }//end loop over HitFinding modules
 
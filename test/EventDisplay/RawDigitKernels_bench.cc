@@ -0,0 +1,508 @@
+/**
+ * @file   RawDigitKernels_bench.cc
+ * @brief  Benchmark of the raw digit drawing kernels on synthetic planes
+ *
+ * Usage:
+ *
+ *     RawDigitKernels_bench [--wires N] [--ticks N] [--occupancy F]
+ *       [--compression none|huffman|zs] [--cells WIRECELLS TICKCELLS]
+ *       [--repeat N] [--seed N]
+ *
+ * A wire plane is generated with a noisy baseline and signal pulses covering
+ * about the `occupancy` fraction of the samples, and the digit of each wire is
+ * compressed as asked. Each kernel of the raw digit drawing then runs on the
+ * plane `repeat` times, the drawing ones on a grid of the specified number of
+ * cells (like a pad of that many pixels). Drawing and region of interest
+ * extraction are also run together, both in two passes and fused in one
+ * (as RawDataDrawer does when it needs both). For each kernel, the time per run,
+ * the samples and cells processed per second, the memory allocations per run
+ * and the peak resident memory of the process so far are printed.
+ *
+ * The program fails if a kernel gives inconsistent results, so that it can
+ * also run as a test.
+ */
+
+#include "lareventdisplay/EventDisplay/CellGrid.h"
+#include "lareventdisplay/EventDisplay/RawDigitCells.h"
+
+#include "larcoreobj/SimpleTypesAndConstants/RawTypes.h" // raw::Compress_t
+#include "lardataobj/RawData/raw.h" // raw::Compress(), raw::Uncompress()
+
+#include <sys/resource.h> // getrusage()
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+
+//------------------------------------------------------------------------------
+//--- allocation counting
+//---
+namespace {
+  std::atomic<std::size_t> gAllocations { 0U };
+  std::atomic<std::size_t> gAllocatedBytes { 0U };
+} // local namespace
+
+void* operator new(std::size_t size) {
+  ++gAllocations;
+  gAllocatedBytes += size;
+  if (void* ptr = std::malloc(size? size: 1U)) return ptr;
+  throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+
+namespace {
+
+  //----------------------------------------------------------------------------
+  /// Parameters of the benchmark
+  struct Config_t {
+    unsigned int nWires = 10000; ///< wires on the plane
+    std::size_t nTicks = 6000; ///< samples on each wire
+    double occupancy = 0.05; ///< fraction of the samples with signal
+    raw::Compress_t compression = raw::kNone; ///< compression of the digits
+    unsigned int nWireCells = 1000; ///< drawing cells on the wire direction
+    unsigned int nTickCells = 700; ///< drawing cells on the tick direction
+    unsigned int repeat = 3; ///< runs of each kernel
+    unsigned int seed = 12345; ///< seed of the random generator
+  }; // Config_t
+
+
+  raw::Compress_t ParseCompression(std::string const& name) {
+    if (name == "none") return raw::kNone;
+    if (name == "huffman") return raw::kHuffman;
+    if (name == "zs") return raw::kZeroSuppression;
+    throw std::runtime_error("Unknown compression: '" + name + "'");
+  } // ParseCompression()
+
+
+  std::string CompressionName(raw::Compress_t compression) {
+    switch (compression) {
+      case raw::kNone:            return "none";
+      case raw::kHuffman:         return "huffman";
+      case raw::kZeroSuppression: return "zs";
+      default:                    return "other";
+    } // switch
+  } // CompressionName()
+
+
+  Config_t ParseArguments(int argc, char** argv) {
+    Config_t config;
+    for (int iArg = 1; iArg < argc; ++iArg) {
+      std::string const arg = argv[iArg];
+      auto const value = [&](){
+        if (++iArg >= argc)
+          throw std::runtime_error("Missing value for '" + arg + "'");
+        return std::string(argv[iArg]);
+      };
+      if      (arg == "--wires")       config.nWires = std::stoul(value());
+      else if (arg == "--ticks")       config.nTicks = std::stoul(value());
+      else if (arg == "--occupancy")   config.occupancy = std::stod(value());
+      else if (arg == "--compression")
+        config.compression = ParseCompression(value());
+      else if (arg == "--cells") {
+        config.nWireCells = std::stoul(value());
+        config.nTickCells = std::stoul(value());
+      }
+      else if (arg == "--repeat")      config.repeat = std::stoul(value());
+      else if (arg == "--seed")        config.seed = std::stoul(value());
+      else throw std::runtime_error("Unknown argument: '" + arg + "'");
+    } // for
+    if ((config.nWires == 0) || (config.nTicks == 0) || (config.repeat == 0))
+      throw std::runtime_error("Empty plane or no repetition requested");
+    // the number of pulses is drawn from a Poisson with positive mean
+    if (!(config.occupancy > 0.) || (config.occupancy > 1.))
+      throw std::runtime_error("Occupancy must be larger than 0 and up to 1");
+    return config;
+  } // ParseArguments()
+
+
+  //----------------------------------------------------------------------------
+  /// A plane of digits, compressed and uncompressed
+  struct SyntheticPlane_t {
+    unsigned int nWires = 0;
+    std::size_t nTicks = 0;
+    raw::Compress_t compression = raw::kNone;
+    short pedestal = 0; ///< pedestal of all the channels
+
+    /// The compressed digit of each wire
+    std::vector<std::vector<short>> digits;
+
+    /// All the samples, pedestal subtracted, wire by wire
+    std::vector<short> samples;
+
+    /// Returns the samples of the specified wire
+    short const* Samples(unsigned int wire) const
+      { return samples.data() + wire * nTicks; }
+
+    /// Returns the total number of samples
+    std::size_t NSamples() const { return samples.size(); }
+
+    /// Returns the total size of the compressed digits
+    std::size_t NCompressed() const
+      {
+        std::size_t n = 0;
+        for (auto const& digit: digits) n += digit.size();
+        return n;
+      }
+  }; // SyntheticPlane_t
+
+
+  /**
+   * @brief Generates a plane of digits
+   *
+   * The baseline has a Gaussian noise of 2.5 ADC counts around the pedestal.
+   * The signal is made of triangular pulses, 20 ticks long and with peaks
+   * between 20 and 200 ADC counts, placed at random. The zero-suppressed
+   * digits have no pedestal, since the suppression is applied to the ADC
+   * counts themselves.
+   */
+  SyntheticPlane_t MakePlane(Config_t const& config) {
+    constexpr std::size_t PulseLength = 20;
+
+    SyntheticPlane_t plane;
+    plane.nWires = config.nWires;
+    plane.nTicks = config.nTicks;
+    plane.compression = config.compression;
+    plane.pedestal = (config.compression == raw::kZeroSuppression)? 0: 400;
+
+    std::mt19937 engine(config.seed);
+    std::normal_distribution<float> noise(0.F, 2.5F);
+    std::uniform_real_distribution<float> amplitude(20.F, 200.F);
+    std::uniform_int_distribution<std::size_t> start
+      (0U, (plane.nTicks > PulseLength)? plane.nTicks - PulseLength: 0U);
+    std::poisson_distribution<unsigned int> nPulses
+      (config.occupancy * plane.nTicks / PulseLength);
+
+    plane.digits.resize(plane.nWires);
+    plane.samples.resize(plane.nWires * plane.nTicks);
+    std::vector<float> waveform(plane.nTicks);
+    for (unsigned int wire = 0; wire < plane.nWires; ++wire) {
+      for (float& sample: waveform) sample = noise(engine);
+      for (unsigned int iPulse = nPulses(engine); iPulse > 0; --iPulse) {
+        float const peak = amplitude(engine);
+        std::size_t const first = start(engine);
+        std::size_t const end = std::min(first + PulseLength, plane.nTicks);
+        for (std::size_t tick = first; tick < end; ++tick) {
+          float const x = float(tick - first) / PulseLength;
+          waveform[tick] += peak * (1.F - std::abs(2.F * x - 1.F));
+        }
+      } // for pulses
+
+      std::vector<short>& digit = plane.digits[wire];
+      digit.resize(plane.nTicks);
+      short* samples = plane.samples.data() + wire * plane.nTicks;
+      for (std::size_t tick = 0; tick < plane.nTicks; ++tick) {
+        samples[tick] = (short) std::lround(waveform[tick]);
+        digit[tick] = samples[tick] + plane.pedestal;
+      }
+      raw::Compress(digit, plane.compression);
+    } // for wires
+
+    // what zero suppression dropped is not in the samples either
+    if (plane.compression == raw::kZeroSuppression) {
+      std::vector<short> uncompressed(plane.nTicks);
+      for (unsigned int wire = 0; wire < plane.nWires; ++wire) {
+        raw::Uncompress(plane.digits[wire], uncompressed, plane.compression);
+        std::copy(uncompressed.begin(), uncompressed.end(),
+          plane.samples.begin() + wire * plane.nTicks);
+      }
+    }
+
+    return plane;
+  } // MakePlane()
+
+
+  //----------------------------------------------------------------------------
+  /// Runs an operation on all the samples of the plane, with the same calls
+  /// RawDataDrawer::RunOperation() makes on the digits of a plane
+  template <typename Op>
+  bool RunOnPlane(SyntheticPlane_t const& plane, Op& operation) {
+    if (!operation.Initialize()) return false;
+    for (unsigned int wire = 0; wire < plane.nWires; ++wire) {
+      if (!operation.ProcessWire(wire)) continue;
+      short const* samples = plane.Samples(wire);
+      for (std::size_t tick = 0; tick < plane.nTicks; ++tick) {
+        if (!operation.ProcessTick(tick)) continue;
+        if (!operation.Operate(wire, tick, float(samples[tick]))) return false;
+      }
+    } // for wires
+    return operation.Finish();
+  } // RunOnPlane()
+
+
+  /// The box drawer of RawDataDrawer, without the charge sums and the view
+  class BoxOperation {
+  public:
+    BoxOperation(evd::details::CellGridClass const& grid): fGrid(grid) {}
+
+    bool Initialize() { fCells.Initialize(fGrid, 1.F); return true; }
+    bool ProcessWire(unsigned int wire) { return fCells.ProcessWire(wire); }
+    bool ProcessTick(std::size_t tick) { return fCells.ProcessTick(tick); }
+    bool Operate(unsigned int, std::size_t tick, float adc)
+      { fCells.Add(tick, adc); return true; }
+    bool Finish() { return true; }
+
+    evd::details::BoxCellsClass const& Cells() const { return fCells; }
+
+  private:
+    evd::details::CellGridClass fGrid;
+    evd::details::BoxCellsClass fCells;
+  }; // BoxOperation
+
+
+  /// The region of interest extractor of RawDataDrawer
+  class RoIOperation {
+  public:
+    RoIOperation(float threshold): fThreshold(threshold), fRange(threshold) {}
+
+    bool Initialize() { fRange = evd::details::RoIRangeClass(fThreshold); return true; }
+    bool ProcessWire(unsigned int) { return true; }
+    bool ProcessTick(std::size_t) { return true; }
+    bool Operate(unsigned int wire, std::size_t tick, float adc)
+      { fRange.Add(wire, tick, adc); return true; }
+    bool Finish() { return true; }
+
+    evd::details::RoIRangeClass const& Range() const { return fRange; }
+
+  private:
+    float fThreshold;
+    evd::details::RoIRangeClass fRange;
+  }; // RoIOperation
+
+
+  /// A box as it would be sent to the view
+  struct Box_t {
+    float minWire, minTick, maxWire, maxTick;
+    int color;
+  }; // Box_t
+
+
+  /// A color palette like the one of the raw digits
+  int Color(int adc) { return 1000 + std::min(std::abs(adc) / 4, 255); }
+
+
+  //----------------------------------------------------------------------------
+  /// Measurements of a kernel
+  struct KernelStats_t {
+    std::string name;
+    double seconds = 0.; ///< time per run
+    std::size_t samples = 0U; ///< samples processed per run
+    std::size_t cells = 0U; ///< cells processed per run
+    double allocations = 0.; ///< allocations per run
+    double allocatedBytes = 0.; ///< bytes allocated per run
+    long peakRSSkB = 0; ///< peak resident memory of the process so far [kB]
+  }; // KernelStats_t
+
+
+  template <typename Kernel>
+  KernelStats_t Measure(
+    std::string name, unsigned int repeat,
+    std::size_t samples, std::size_t cells, Kernel&& kernel
+  ) {
+    std::size_t const allocations = gAllocations;
+    std::size_t const allocatedBytes = gAllocatedBytes;
+    auto const start = std::chrono::steady_clock::now();
+    for (unsigned int iRun = 0; iRun < repeat; ++iRun) kernel();
+    std::chrono::duration<double> const elapsed
+      = std::chrono::steady_clock::now() - start;
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    KernelStats_t stats;
+    stats.name = std::move(name);
+    stats.seconds = elapsed.count() / repeat;
+    stats.samples = samples;
+    stats.cells = cells;
+    stats.allocations = double(gAllocations - allocations) / repeat;
+    stats.allocatedBytes = double(gAllocatedBytes - allocatedBytes) / repeat;
+    stats.peakRSSkB = usage.ru_maxrss;
+    return stats;
+  } // Measure()
+
+
+  void PrintHeader() {
+    std::printf("%-28s %10s %12s %12s %10s %12s %10s\n",
+      "kernel", "ms/run", "samples/s", "cells/s", "allocs", "alloc MiB",
+      "peak MiB");
+  } // PrintHeader()
+
+
+  void Print(KernelStats_t const& stats) {
+    auto const rate = [&stats](std::size_t n)
+      { return (stats.seconds > 0.)? n / stats.seconds: 0.; };
+    std::printf("%-28s %10.3f %12.4g %12.4g %10.0f %12.3f %10.1f\n",
+      stats.name.c_str(), stats.seconds * 1e3,
+      rate(stats.samples), rate(stats.cells), stats.allocations,
+      stats.allocatedBytes / (1 << 20), stats.peakRSSkB / 1024.);
+  } // Print()
+
+
+  /// Counts the failed checks
+  unsigned int gFailures = 0;
+
+  void Check(bool condition, std::string const& what) {
+    if (condition) return;
+    std::printf("FAILED: %s\n", what.c_str());
+    ++gFailures;
+  } // Check()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+int main(int argc, char** argv) {
+
+  Config_t config;
+  try { config = ParseArguments(argc, argv); }
+  catch (std::exception const& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+
+  SyntheticPlane_t const plane = MakePlane(config);
+  std::size_t const nSamples = plane.NSamples();
+
+  std::printf("Plane of %u wires x %zu ticks, occupancy %g, compression '%s'"
+    " (%.1f%% of the samples stored); drawing on %u x %u cells\n",
+    plane.nWires, plane.nTicks, config.occupancy,
+    CompressionName(plane.compression).c_str(),
+    100. * plane.NCompressed() / nSamples,
+    config.nWireCells, config.nTickCells);
+
+  evd::details::CellGridClass const grid(
+    0.F, float(plane.nWires), config.nWireCells,
+    0.F, float(plane.nTicks), config.nTickCells
+    );
+  std::size_t const nCells = grid.NCells();
+
+  PrintHeader();
+
+  //
+  // uncompression of the digits into one block, pedestal subtracted
+  //
+  std::vector<short> block(nSamples);
+  std::vector<short> uncompressed(plane.nTicks);
+  Print(Measure("uncompression", config.repeat, nSamples, 0U, [&](){
+    short* dest = block.data();
+    for (std::vector<short> const& digit: plane.digits) {
+      raw::Uncompress(digit, uncompressed, plane.compression);
+      for (short const adc: uncompressed) *(dest++) = adc - plane.pedestal;
+    }
+  }));
+  Check(block == plane.samples, "uncompressed samples differ from the original");
+
+  //
+  // cell lookup of each sample
+  //
+  std::size_t nInCells = 0;
+  Print(Measure("CellGridClass::GetCell", config.repeat, nSamples, nCells, [&](){
+    nInCells = 0;
+    for (unsigned int wire = 0; wire < plane.nWires; ++wire) {
+      for (std::size_t tick = 0; tick < plane.nTicks; ++tick)
+        if (grid.GetCell(float(wire), float(tick)) >= 0) ++nInCells;
+    }
+  }));
+  Check(nInCells == nSamples, "some samples are not in any cell");
+
+  //
+  // filling of the drawing cells (BoxDrawer)
+  //
+  BoxOperation boxes(grid);
+  Print(Measure("BoxDrawer", config.repeat, nSamples, nCells,
+    [&](){ RunOnPlane(plane, boxes); }));
+  std::vector<evd::details::BoxInfo_t> const& cells = boxes.Cells().Cells();
+  Check(std::all_of(cells.begin(), cells.end(),
+    [](evd::details::BoxInfo_t const& info){ return info.good; }),
+    "some drawing cells have no sample");
+
+  //
+  // region of interest extraction (RoIextractorClass)
+  //
+  constexpr float RoIthreshold = 10.F;
+  RoIOperation roi(RoIthreshold);
+  Print(Measure("RoIextractorClass", config.repeat, nSamples, 0U,
+    [&](){ RunOnPlane(plane, roi); }));
+  bool const hasSignal = std::any_of(plane.samples.begin(), plane.samples.end(),
+    [](short adc){ return std::abs(adc) >= RoIthreshold; });
+  Check(roi.Range().hasData() == hasSignal, "wrong region of interest");
+
+  //
+  // drawing and region of interest extraction, in two passes and fused
+  //
+  BoxOperation boxesAlone(grid);
+  RoIOperation roiAlone(RoIthreshold);
+  Print(Measure("BoxDrawer+RoI (two passes)", config.repeat, nSamples, nCells,
+    [&](){
+      RunOnPlane(plane, boxesAlone);
+      RunOnPlane(plane, roiAlone);
+    }));
+
+  BoxOperation boxesFused(grid);
+  RoIOperation roiFused(RoIthreshold);
+  Print(Measure("BoxDrawer+RoI (fused)", config.repeat, nSamples, nCells, [&](){
+    evd::details::FusedKernels<BoxOperation, RoIOperation> fused
+      (boxesFused, roiFused);
+    RunOnPlane(plane, fused);
+  }));
+  std::vector<evd::details::BoxInfo_t> const& fusedCells
+    = boxesFused.Cells().Cells();
+  Check(std::equal(fusedCells.begin(), fusedCells.end(),
+    boxesAlone.Cells().Cells().begin(), boxesAlone.Cells().Cells().end(),
+    [](evd::details::BoxInfo_t const& a, evd::details::BoxInfo_t const& b)
+      { return (a.adc == b.adc) && (a.good == b.good); }
+    ),
+    "fused drawing differs from the one alone");
+  Check((roiFused.Range().WireMin() == roiAlone.Range().WireMin())
+    && (roiFused.Range().WireMax() == roiAlone.Range().WireMax())
+    && (roiFused.Range().TickMin() == roiAlone.Range().TickMin())
+    && (roiFused.Range().TickMax() == roiAlone.Range().TickMax()),
+    "fused region of interest differs from the one alone");
+
+  //
+  // conversion of the cells into boxes (QueueDrawingBoxes)
+  //
+  constexpr float MinSignal = 5.F;
+  std::vector<Box_t> boxList;
+  boxList.reserve(nCells);
+  unsigned int nBoxes = 0;
+  evd::details::CellGridClass const& drawGrid = boxes.Cells().Grid();
+  Print(Measure("QueueDrawingBoxes (boxes)", config.repeat, 0U, nCells, [&](){
+    boxList.clear();
+    nBoxes = evd::details::DrawCells(cells, MinSignal, Color,
+      [&](std::size_t iBox, int color){
+        Box_t box;
+        std::tie(box.minWire, box.minTick, box.maxWire, box.maxTick)
+          = evd::details::CellBox(drawGrid, iBox, cells[iBox].adc, false);
+        box.color = color;
+        boxList.push_back(box);
+      });
+  }));
+  Check(nBoxes == boxList.size(), "wrong count of drawn boxes");
+
+  std::vector<int> raster(nCells, 0);
+  unsigned int nPainted = 0;
+  Print(Measure("QueueDrawingBoxes (raster)", config.repeat, 0U, nCells, [&](){
+    nPainted = evd::details::DrawCells(cells, MinSignal, Color,
+      [&raster](std::size_t iBox, int color){ raster[iBox] = color; });
+  }));
+  Check(nPainted == nBoxes, "raster and boxes have different cells");
+
+  if (gFailures > 0) {
+    std::printf("%u checks FAILED\n", gFailures);
+    return 1;
+  }
+  return 0;
+} // main()
@@ -0,0 +1,118 @@
+/**
+ * @file   SpacePointDecimator_test.cc
+ * @brief  Test of the merging of space points in the 3D display
+ *
+ * Usage:
+ *
+ *     SpacePointDecimator_test
+ *
+ * A cloud of points is spread over a detector-sized region, with a small
+ * cluster inside a zoomed region. The points are decimated to a budget larger
+ * than the cluster, with the zoomed region as the shown one: all the points
+ * of the cluster must be kept as they are, and the budget must be met.
+ * Without a shown region, the cluster is merged like the other points.
+ *
+ * The program fails if any of the checks fails.
+ */
+
+#include "lareventdisplay/EventDisplay/3DDrawers/SpacePointDecimator.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+using Point_t = evdb_tool::SpacePointDecimator::Point_t;
+
+namespace {
+
+  //----------------------------------------------------------------------------
+  /// Returns how many of the `points` are found unchanged in `decimated`
+  std::size_t countKept
+    (std::vector<Point_t> const& points, std::vector<Point_t> const& decimated)
+  {
+    std::size_t nKept = 0U;
+    for (Point_t const& point: points) {
+      if (std::find(decimated.begin(), decimated.end(), point) != decimated.end())
+        ++nKept;
+    }
+    return nKept;
+  } // countKept()
+
+} // local namespace
+
+
+//------------------------------------------------------------------------------
+int main() {
+
+  constexpr std::size_t nCluster = 100U;
+  constexpr std::size_t nOthers = 5000U;
+  constexpr std::size_t budget = 500U;
+
+  Point_t const zoomMin {{ 0., 0., 0. }};
+  Point_t const zoomMax {{ 10., 10., 10. }};
+
+  std::mt19937 rand(12345U);
+  std::uniform_real_distribution<double> inZoom(0.5, 9.5);
+  std::uniform_real_distribution<double> inDetector(-1000., 1000.);
+
+  // the cluster, in the zoomed region
+  std::vector<Point_t> cluster;
+  for (std::size_t i = 0; i < nCluster; ++i)
+    cluster.push_back(Point_t{{ inZoom(rand), inZoom(rand), inZoom(rand) }});
+
+  // all the points: the others are all out of the zoomed region
+  std::vector<Point_t> points = cluster;
+  while (points.size() < nCluster + nOthers) {
+    Point_t const point {{ inDetector(rand), inDetector(rand), inDetector(rand) }};
+    if ((point[0] >= zoomMin[0]) && (point[0] <= zoomMax[0])
+      && (point[1] >= zoomMin[1]) && (point[1] <= zoomMax[1])
+      && (point[2] >= zoomMin[2]) && (point[2] <= zoomMax[2]))
+      continue;
+    points.push_back(point);
+  } // while
+
+  unsigned int nErrors = 0U;
+
+  // zoomed region shown: the cluster is kept at full resolution
+  {
+    evdb_tool::SpacePointDecimator const decimator
+      (budget, points.size(), zoomMin, zoomMax);
+    std::vector<Point_t> const decimated = decimator.Decimate(points);
+    std::size_t const nKept = countKept(cluster, decimated);
+    std::printf("Zoomed: %zu points decimated into %zu, %zu/%zu in the zoom kept\n",
+      points.size(), decimated.size(), nKept, cluster.size());
+    if (nKept != cluster.size()) {
+      std::fprintf(stderr, "Error: %zu points in the zoomed region were merged\n",
+        cluster.size() - nKept);
+      ++nErrors;
+    }
+    if (decimated.size() > budget) {
+      std::fprintf(stderr, "Error: %zu points drawn, budget is %zu\n",
+        decimated.size(), budget);
+      ++nErrors;
+    }
+  }
+
+  // whole region shown: the cluster is no different from the other points
+  {
+    evdb_tool::SpacePointDecimator const decimator(budget, points.size());
+    std::vector<Point_t> const decimated = decimator.Decimate(points);
+    std::size_t const nKept = countKept(cluster, decimated);
+    std::printf("Unzoomed: %zu points decimated into %zu, %zu/%zu in the zoom kept\n",
+      points.size(), decimated.size(), nKept, cluster.size());
+    if (nKept == cluster.size()) {
+      std::fprintf(stderr, "Error: no point in the cluster was merged\n");
+      ++nErrors;
+    }
+    if (decimated.size() > budget) {
+      std::fprintf(stderr, "Error: %zu points drawn, budget is %zu\n",
+        decimated.size(), budget);
+      ++nErrors;
+    }
+  }
+
+  return (nErrors == 0U)? 0: 1;
+} // main()